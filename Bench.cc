@@ -0,0 +1,238 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "Bench.h"
+#include "Detect.h"
+
+// built for the x86-64 baseline like Example.cc: runs everywhere, the benchmarks need avx2 and are only entered then
+//
+//   ./Bench [--json] [--cpu N] [--filter NAME] [--warmup N] [--repeat N]
+
+namespace avx {
+namespace bench {
+
+double ticksPerNs() {
+  static const double rv = [] {
+    using clock = std::chrono::steady_clock;
+
+    const auto t0 = clock::now();
+    const auto c0 = ticks();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    const auto t1 = clock::now();
+    const auto c1 = ticks();
+
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+    return static_cast<double>(c1 - c0) / static_cast<double>(ns);
+  }();
+  return rv;
+}
+
+Stats stats(std::vector<double> samples) {
+  if (samples.empty())
+    return {0, 0, 0, 0};
+
+  std::sort(begin(samples), end(samples));
+
+  const auto n = samples.size();
+  const auto mean = std::accumulate(begin(samples), end(samples), 0.) / static_cast<double>(n);
+  const auto median = n % 2 == 1 ? samples[n / 2] : (samples[n / 2 - 1] + samples[n / 2]) / 2;
+
+  double squares{0};
+  for (const auto sample : samples)
+    squares += (sample - mean) * (sample - mean);
+
+  return {samples.front(), median, mean, n > 1 ? std::sqrt(squares / static_cast<double>(n - 1)) : 0.};
+}
+
+namespace {
+
+// at least this many reference cycles per repeat, so that timer resolution and overhead do not matter
+const constexpr std::uint64_t minTicksPerRepeat = 2'000'000u;
+
+std::uint64_t time(const Benchmark& benchmark, std::size_t iterations) {
+  const auto t0 = ticks();
+  benchmark.run(iterations);
+  return ticks() - t0;
+}
+
+Result measureOne(const Benchmark& benchmark, const Options& options) {
+  std::size_t iterations{1};
+  while (time(benchmark, iterations) < minTicksPerRepeat && iterations < (std::size_t{1} << 40))
+    iterations *= 2;
+
+  for (std::size_t i{0}; i < options.warmup; ++i)
+    time(benchmark, iterations);
+
+  std::vector<double> cycles, ns;
+  for (std::size_t i{0}; i < options.repeat; ++i) {
+    const auto perOp = static_cast<double>(time(benchmark, iterations)) / static_cast<double>(iterations * benchmark.ops);
+    cycles.push_back(perOp);
+    ns.push_back(perOp / ticksPerNs());
+  }
+
+  return {&benchmark, stats(cycles), stats(ns)};
+}
+
+const char* name(Kind kind) {
+  switch (kind) {
+  case Kind::latency:
+    return "latency";
+  case Kind::throughput:
+    return "throughput";
+  case Kind::bandwidth:
+    return "bandwidth";
+  }
+  return "unknown";
+}
+
+double gbPerS(const Result& result) {
+  const auto& benchmark = *result.benchmark;
+  if (benchmark.kind != Kind::bandwidth || result.nsPerOp.median == 0)
+    return 0;
+  return static_cast<double>(benchmark.bytes) / (result.nsPerOp.median * static_cast<double>(benchmark.ops));
+}
+
+// median cycles per op of the scalar variant of the same benchmark, by name and kind
+std::map<std::pair<std::string, Kind>, double> scalarBaselines(const std::vector<Result>& results) {
+  std::map<std::pair<std::string, Kind>, double> rv;
+  for (const auto& result : results)
+    if (result.benchmark->variant == "scalar")
+      rv[{result.benchmark->name, result.benchmark->kind}] = result.cyclesPerOp.median;
+  return rv;
+}
+
+double speedup(const std::map<std::pair<std::string, Kind>, double>& baselines, const Result& result) {
+  const auto it = baselines.find({result.benchmark->name, result.benchmark->kind});
+  if (it == end(baselines) || result.cyclesPerOp.median == 0)
+    return 0;
+  return it->second / result.cyclesPerOp.median;
+}
+
+void pin(int cpu) {
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  CPU_SET(cpu, &cpus);
+
+  if (::pthread_setaffinity_np(::pthread_self(), sizeof(cpus), &cpus) != 0)
+    throw std::runtime_error{"unable to pin to cpu " + std::to_string(cpu)};
+}
+
+void printStats(const char* key, const Stats& s) {
+  std::printf("\"%s\": {\"min\": %.6g, \"median\": %.6g, \"mean\": %.6g, \"stddev\": %.6g}", key, s.min, s.median,
+              s.mean, s.stddev);
+}
+}
+
+std::vector<Result> measure(const std::vector<Benchmark>& benchmarks, const Options& options) {
+  std::vector<Result> rv;
+
+  for (const auto& benchmark : benchmarks)
+    if (options.filter.empty() || benchmark.name.find(options.filter) != std::string::npos)
+      rv.push_back(measureOne(benchmark, options));
+
+  return rv;
+}
+
+void printTable(const std::vector<Result>& results) {
+  const auto baselines = scalarBaselines(results);
+
+  std::printf("%-28s %-8s %-10s %12s %10s %10s %8s %9s\n", "name", "variant", "kind", "cycles/op", "stddev", "ns/op",
+              "GB/s", "x scalar");
+
+  for (const auto& result : results) {
+    const auto& benchmark = *result.benchmark;
+    std::printf("%-28s %-8s %-10s %12.4f %10.4f %10.4f %8.2f %9.2f\n", benchmark.name.c_str(),
+                benchmark.variant.c_str(), name(benchmark.kind), result.cyclesPerOp.median, result.cyclesPerOp.stddev,
+                result.nsPerOp.median, gbPerS(result), speedup(baselines, result));
+  }
+}
+
+void printJson(const std::vector<Result>& results, const Options& options) {
+  const auto baselines = scalarBaselines(results);
+
+  std::printf("{\n  \"isa\": \"%s\", \"ticksPerNs\": %.6g, \"cpu\": %d, \"warmup\": %zu, \"repeat\": %zu,\n",
+              cpu::name(cpu::isa()), ticksPerNs(), options.cpu, options.warmup, options.repeat);
+  std::printf("  \"results\": [\n");
+
+  for (std::size_t i{0}; i < results.size(); ++i) {
+    const auto& result = results[i];
+    const auto& benchmark = *result.benchmark;
+
+    std::printf("    {\"name\": \"%s\", \"variant\": \"%s\", \"kind\": \"%s\", \"ops\": %zu, \"bytes\": %zu, ",
+                benchmark.name.c_str(), benchmark.variant.c_str(), name(benchmark.kind), benchmark.ops,
+                benchmark.bytes);
+    printStats("cyclesPerOp", result.cyclesPerOp);
+    std::printf(", ");
+    printStats("nsPerOp", result.nsPerOp);
+    std::printf(", \"gbPerS\": %.6g, \"speedupVsScalar\": %.6g}%s\n", gbPerS(result), speedup(baselines, result),
+                i + 1 == results.size() ? "" : ",");
+  }
+
+  std::printf("  ]\n}\n");
+}
+}
+}
+
+
+int main(int argc, char** argv) try {
+  avx::bench::Options options;
+
+  for (int i = 1; i < argc; ++i) {
+    const std::string arg{argv[i]};
+    const auto value = [&] {
+      if (i + 1 == argc)
+        throw std::runtime_error{arg + " needs a value"};
+      return std::string{argv[++i]};
+    };
+
+    if (arg == "--json")
+      options.json = true;
+    else if (arg == "--cpu")
+      options.cpu = std::stoi(value());
+    else if (arg == "--filter")
+      options.filter = value();
+    else if (arg == "--warmup")
+      options.warmup = std::stoul(value());
+    else if (arg == "--repeat")
+      options.repeat = std::stoul(value());
+    else
+      throw std::runtime_error{"unknown argument " + arg};
+  }
+
+  if (avx::cpu::isa() < avx::cpu::Isa::avx2)
+    throw std::runtime_error{"benchmarks need avx2"};
+
+  if (options.cpu >= 0)
+    avx::bench::pin(options.cpu);
+
+  std::vector<avx::bench::Benchmark> benchmarks;
+  avx::bench::registerBenchmarks(benchmarks);
+
+  if (avx::cpu::isa() >= avx::cpu::Isa::avx512)
+    avx::bench::registerBenchmarks512(benchmarks);
+
+  const auto results = avx::bench::measure(benchmarks, options);
+
+  if (options.json)
+    avx::bench::printJson(results, options);
+  else
+    avx::bench::printTable(results);
+
+} catch (const std::exception& e) {
+  std::cerr << e.what() << std::endl;
+  return EXIT_FAILURE;
+}
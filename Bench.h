@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <x86intrin.h>
+
+// compiled for the x86-64 baseline, see Bench.cc; the benchmarks themselves are in Benchmarks.cc
+
+namespace avx {
+namespace bench {
+
+// keeps the compiler from computing x at compile time or dropping it, without emitting any instruction:
+// keep forces floating point and vector values into a register, keepInMemory anything else into memory
+template <typename T>
+inline void keep(T& x) {
+  asm volatile("" : "+x"(x));
+}
+
+template <typename T>
+inline void keepInMemory(T& x) {
+  asm volatile("" : "+m"(x) : : "memory");
+}
+
+// time stamp counter: constant rate reference cycles, not core cycles -- they differ with frequency scaling and turbo
+inline std::uint64_t ticks() {
+  unsigned aux;
+  return __rdtscp(&aux);
+}
+
+// reference cycles per nanosecond; calibrated once
+double ticksPerNs();
+
+struct Stats final {
+  double min;
+  double median;
+  double mean;
+  double stddev;
+};
+
+// over all repeats, after dropping the warmup runs
+Stats stats(std::vector<double> samples);
+
+enum class Kind {
+  latency,    // cycles per op along a dependency chain
+  throughput, // cycles per op over independent chains, i.e. reciprocal throughput
+  bandwidth,  // GB/s and cycles per element over a working set
+};
+
+// one benchmark: run(iterations) performs iterations ops (or passes over bytes) and returns nothing observable
+struct Benchmark final {
+  std::string name;
+  std::string variant; // vec, autovec, scalar, libc; regular, stream or auto stores
+  Kind kind;
+  std::size_t ops;   // ops resp. elements per iteration
+  std::size_t bytes; // bytes read and written per iteration, bandwidth benchmarks only
+  std::function<void(std::size_t iterations)> run;
+};
+
+// filled in by Benchmarks.cc, built for ISAFLAGS.avx2
+void registerBenchmarks(std::vector<Benchmark>& benchmarks);
+
+// filled in by Benchmarks512.cc, built for ISAFLAGS.avx512; call on avx512 machines only
+void registerBenchmarks512(std::vector<Benchmark>& benchmarks);
+
+struct Options final {
+  std::size_t warmup = 3;
+  std::size_t repeat = 15;
+  int cpu = 0;        // pinned to, -1 leaves the affinity alone
+  std::string filter; // substring of names to run, all if empty
+  bool json = false;
+};
+
+struct Result final {
+  const Benchmark* benchmark;
+  Stats cyclesPerOp;
+  Stats nsPerOp;
+};
+
+// runs each benchmark until a repeat takes long enough for the clock, then warmup + repeat times
+std::vector<Result> measure(const std::vector<Benchmark>& benchmarks, const Options& options);
+
+void printTable(const std::vector<Result>& results);
+void printJson(const std::vector<Result>& results, const Options& options);
+}
+}
@@ -0,0 +1,281 @@
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmarks.h"
+
+// built with ISAFLAGS.avx2 and KERNELFLAGS, see the Makefile; only entered on avx2 machines, see Bench.cc
+//
+// ops: latency along one dependency chain and reciprocal throughput over eight independent ones, in cycles per
+// instruction. Streaming kernels: GB/s and cycles per element over working sets sized for L1, L2, L3 and DRAM, each
+// next to the same loop vectorized by the compiler (autovec) and not vectorized at all (scalar). Clock: the core clock
+// with and without vector work, see Benchmarks.h; the 512 bit variants are in Benchmarks512.cc.
+
+// the compiler's vectorizer off for scalar baselines, everything else stays at -O3
+#define AVX_BENCH_SCALAR __attribute__((optimize("no-tree-vectorize")))
+
+namespace avx {
+namespace bench {
+
+namespace {
+
+void registerOps(std::vector<Benchmark>& benchmarks) {
+  using f = vec8f;
+  using i = vec8i;
+
+  both<f>(benchmarks, "vec8f add", [](const f& x, const f& y) { return x + y; });
+  both<f>(benchmarks, "vec8f sub", [](const f& x, const f& y) { return x - y; });
+  both<f>(benchmarks, "vec8f mul", [](const f& x, const f& y) { return x * y; });
+  both<f>(benchmarks, "vec8f div", [](const f& x, const f& y) { return x / y; });
+  both<f>(benchmarks, "vec8f fusedMulAdd", [](const f& x, const f& y) { return fusedMulAdd(x, y, y); });
+  both<f>(benchmarks, "vec8f min", [](const f& x, const f& y) { return min(x, y); });
+  both<f>(benchmarks, "vec8f max", [](const f& x, const f& y) { return max(x, y); });
+  both<f>(benchmarks, "vec8f abs", [](const f& x, const f&) { return abs(x); });
+  both<f>(benchmarks, "vec8f ceil", [](const f& x, const f&) { return ceil(x); });
+  both<f>(benchmarks, "vec8f sqrt", [](const f& x, const f&) { return sqrt(x); });
+  both<f>(benchmarks, "vec8f reciprocalSqrt", [](const f& x, const f&) { return reciprocalSqrt(x); });
+  both<f>(benchmarks, "vec8f reciprocal", [](const f& x, const f&) { return reciprocal(x); });
+  both<f>(benchmarks, "vec8f and", [](const f& x, const f& y) { return x & y; });
+  both<f>(benchmarks, "vec8f xor", [](const f& x, const f& y) { return x ^ y; });
+  both<f>(benchmarks, "vec8f compare", [](const f& x, const f& y) { return x < y; });
+  both<f>(benchmarks, "vec8f blend", [](const f& x, const f& y) { return blend(x, y, x); });
+  both<f>(benchmarks, "vec8f blend<imm>", [](const f& x, const f& y) { return blend<0x0F>(x, y); });
+  both<f>(benchmarks, "vec8f permute", [](const f& x, const f& y) { return permute(x, reinterpret(y)); });
+  both<f>(benchmarks, "vec8f shuffle", [](const f& x, const f& y) { return shuffle<0x1B>(x, y); });
+  both<f>(benchmarks, "vec8f unpackLow", [](const f& x, const f& y) { return unpackLow(x, y); });
+  both<f>(benchmarks, "vec8f hAdd", [](const f& x, const f& y) { return hAdd(x, y); });
+  both<f>(benchmarks, "vec8f addSub", [](const f& x, const f& y) { return addSub(x, y); });
+
+  both<i>(benchmarks, "vec8i add", [](const i& x, const i& y) { return x + y; });
+  both<i>(benchmarks, "vec8i sub", [](const i& x, const i& y) { return x - y; });
+  both<i>(benchmarks, "vec8i mul", [](const i& x, const i& y) { return x * y; });
+  both<i>(benchmarks, "vec8i mulHi", [](const i& x, const i& y) { return mulHi(x, y); });
+  // static: std::function's heap storage is not over-aligned for a captured vec8i
+  static const Divisor<std::int32_t> seven{7};
+  both<i>(benchmarks, "vec8i divide", [](const i& x, const i&) { return x / seven; });
+  both<i>(benchmarks, "vec8i min", [](const i& x, const i& y) { return min(x, y); });
+  both<i>(benchmarks, "vec8i max", [](const i& x, const i& y) { return max(x, y); });
+  both<i>(benchmarks, "vec8i abs", [](const i& x, const i&) { return abs(x); });
+  both<i>(benchmarks, "vec8i and", [](const i& x, const i& y) { return x & y; });
+  both<i>(benchmarks, "vec8i xor", [](const i& x, const i& y) { return x ^ y; });
+  both<i>(benchmarks, "vec8i shiftLeft", [](const i& x, const i& y) { return x << y; });
+  both<i>(benchmarks, "vec8i shiftLeft<imm>", [](const i& x, const i&) { return shiftLeftZeroExtend<1>(x); });
+  both<i>(benchmarks, "vec8i compare", [](const i& x, const i& y) { return x > y; });
+  both<i>(benchmarks, "vec8i blend", [](const i& x, const i& y) { return blend(x, y, x); });
+  both<i>(benchmarks, "vec8i permute", [](const i& x, const i& y) { return permute(x, y); });
+  both<i>(benchmarks, "vec8i shuffle", [](const i& x, const i&) { return shuffle<0x1B>(x); });
+  both<i>(benchmarks, "vec8i unpackLow", [](const i& x, const i& y) { return unpackLow(x, y); });
+  both<i>(benchmarks, "vec8i hAdd", [](const i& x, const i& y) { return hAdd(x, y); });
+
+  using d = vec4d;
+  using q = vec4q;
+  using s = vec16s;
+  using b = vec32b;
+
+  both<d>(benchmarks, "vec4d add", [](const d& x, const d& y) { return x + y; });
+  both<d>(benchmarks, "vec4d div", [](const d& x, const d& y) { return x / y; });
+  both<d>(benchmarks, "vec4d fusedMulAdd", [](const d& x, const d& y) { return fusedMulAdd(x, y, y); });
+  both<q>(benchmarks, "vec4q add", [](const q& x, const q& y) { return x + y; });
+  both<q>(benchmarks, "vec4q mul", [](const q& x, const q& y) { return x * y; });
+  both<q>(benchmarks, "vec4q max", [](const q& x, const q& y) { return max(x, y); });
+  both<s>(benchmarks, "vec16s addSaturate", [](const s& x, const s& y) { return addSaturate(x, y); });
+  both<s>(benchmarks, "vec16s mulFixedPoint", [](const s& x, const s& y) { return mulFixedPoint(x, y); });
+  both<s>(benchmarks, "vec16s narrow", [](const s& x, const s& y) { return narrow(widenLow(x), widenHigh(y)); });
+  both<b>(benchmarks, "vec32b addSaturateUnsigned", [](const b& x, const b& y) { return addSaturateUnsigned(x, y); });
+  both<b>(benchmarks, "vec32b minUnsigned", [](const b& x, const b& y) { return minUnsigned(x, y); });
+}
+
+
+AVX_BENCH_SCALAR float sumScalar(const float* first, std::size_t n) {
+  float rv{0};
+  for (std::size_t i{0}; i < n; ++i)
+    rv += first[i];
+  return rv;
+}
+
+float sumAuto(const float* first, std::size_t n) {
+  float rv{0};
+#pragma omp simd reduction(+ : rv)
+  for (std::size_t i = 0; i < n; ++i)
+    rv += first[i];
+  return rv;
+}
+
+AVX_BENCH_SCALAR float dotScalar(const float* x, const float* y, std::size_t n) {
+  float rv{0};
+  for (std::size_t i{0}; i < n; ++i)
+    rv += x[i] * y[i];
+  return rv;
+}
+
+float dotAuto(const float* x, const float* y, std::size_t n) {
+  float rv{0};
+#pragma omp simd reduction(+ : rv)
+  for (std::size_t i = 0; i < n; ++i)
+    rv += x[i] * y[i];
+  return rv;
+}
+
+AVX_BENCH_SCALAR void copyScalar(const float* x, float* out, std::size_t n) {
+  for (std::size_t i{0}; i < n; ++i)
+    out[i] = x[i];
+}
+
+void copyAuto(const float* x, float* out, std::size_t n) {
+  for (std::size_t i{0}; i < n; ++i)
+    out[i] = x[i];
+}
+
+AVX_BENCH_SCALAR void triadScalar(const float* x, const float* y, float* out, std::size_t n) {
+  for (std::size_t i{0}; i < n; ++i)
+    out[i] = x[i] + 3.f * y[i];
+}
+
+void triadAuto(const float* x, const float* y, float* out, std::size_t n) {
+  for (std::size_t i{0}; i < n; ++i)
+    out[i] = x[i] + 3.f * y[i];
+}
+
+// the loop vecPerf used to time, see Kernels.cc
+AVX_BENCH_SCALAR void addCeilScalar(const float* x, const float* y, float* out, std::size_t n) {
+  for (std::size_t i{0}; i < n; ++i)
+    out[i] = x[i] + std::ceil(y[i]);
+}
+
+void addCeilAuto(const float* x, const float* y, float* out, std::size_t n) {
+  for (std::size_t i{0}; i < n; ++i)
+    out[i] = x[i] + std::ceil(y[i]);
+}
+
+// streamed copy with the body's reads prefetched Prefetch bytes ahead, or not at all for zero, see VecCopy.h
+template <std::size_t Prefetch>
+float copyPrefetching(Arrays& x) {
+  const auto* in = x.a.data();
+
+  detail::write<Prefetch>(x.c.data(), x.n, Prefetch == 0 ? nullptr : in, Stores::streaming,
+                          [&](std::size_t i, std::size_t count) {
+                            vec8f v;
+                            if (count == vec8f::Size)
+                              v.load(in + i, in + i + count);
+                            else
+                              v.load_partial(in + i, in + i + count);
+                            return v;
+                          });
+  return x.c[0];
+}
+
+// name, one benchmark per variant; arrays counts the arrays read or written for bytes per element
+template <typename Vec, typename Auto, typename Scalar>
+void streaming(std::vector<Benchmark>& benchmarks, const std::string& name, std::shared_ptr<Arrays> arrays,
+               std::size_t touched, Vec vec, Auto autovec, Scalar scalar) {
+  benchmarks.push_back(bandwidth(name, "vec", arrays, touched, vec));
+  benchmarks.push_back(bandwidth(name, "autovec", arrays, touched, autovec));
+  benchmarks.push_back(bandwidth(name, "scalar", arrays, touched, scalar));
+}
+
+void registerStreaming(std::vector<Benchmark>& benchmarks) {
+  for (const auto& level : levels) {
+    auto arrays = std::make_shared<Arrays>(level.n);
+    const auto suffix = std::string{"/"} + level.level;
+    const auto n = level.n;
+
+    streaming(benchmarks, "sum" + suffix, arrays, 1,
+              [](Arrays& x) { return avx::sum(x.a.data(), x.a.data() + x.n); },
+              [](Arrays& x) { return sumAuto(x.a.data(), x.n); },
+              [](Arrays& x) { return sumScalar(x.a.data(), x.n); });
+
+    streaming(benchmarks, "dot" + suffix, arrays, 2,
+              [](Arrays& x) { return avx::dot(x.a.data(), x.a.data() + x.n, x.b.data()); },
+              [](Arrays& x) { return dotAuto(x.a.data(), x.b.data(), x.n); },
+              [](Arrays& x) { return dotScalar(x.a.data(), x.b.data(), x.n); });
+
+    const auto copy = [](const vec8f& x) { return x; };
+    streaming(benchmarks, "copy" + suffix, arrays, 2,
+              [=](Arrays& x) { avx::transform(span(x.a), span(x.c), copy); return x.c[0]; },
+              [](Arrays& x) { copyAuto(x.a.data(), x.c.data(), x.n); return x.c[0]; },
+              [](Arrays& x) { copyScalar(x.a.data(), x.c.data(), x.n); return x.c[0]; });
+
+    streaming(benchmarks, "triad" + suffix, arrays, 3,
+              [](Arrays& x) { view(x.c) = view(x.a) + 3.f * view(x.b); return x.c[0]; },
+              [](Arrays& x) { triadAuto(x.a.data(), x.b.data(), x.c.data(), x.n); return x.c[0]; },
+              [](Arrays& x) { triadScalar(x.a.data(), x.b.data(), x.c.data(), x.n); return x.c[0]; });
+
+    const auto addCeil = [](const vec8f& x, const vec8f& y) { return x + ceil(y); };
+    streaming(benchmarks, "addCeil" + suffix, arrays, 3,
+              [=](Arrays& x) { avx::transform(span(x.a), span(x.b), span(x.c), addCeil); return x.c[0]; },
+              [](Arrays& x) { addCeilAuto(x.a.data(), x.b.data(), x.c.data(), x.n); return x.c[0]; },
+              [](Arrays& x) { addCeilScalar(x.a.data(), x.b.data(), x.c.data(), x.n); return x.c[0]; });
+
+    // the arrays' bytes for a byte that is not in them, against glibc's memchr -- itself vectorized
+    benchmarks.push_back(bandwidth("find" + suffix, "vec", arrays, 1, [](Arrays& x) {
+      const auto* first = reinterpret_cast<const char*>(x.a.data());
+      return static_cast<float>(avx::find(first, first + x.n * sizeof(float), '#') - first);
+    }));
+    benchmarks.push_back(bandwidth("find" + suffix, "libc", arrays, 1, [](Arrays& x) {
+      const auto* first = reinterpret_cast<const char*>(x.a.data());
+      return static_cast<float>(std::memchr(first, '#', x.n * sizeof(float)) == nullptr);
+    }));
+
+    // the copy and fill engine, see VecCopy.h: regular and streaming stores at every level, automatic picking one by
+    // the last level cache size, against glibc's memcpy and memset
+    const auto copies = [](Stores stores) {
+      return [stores](Arrays& x) { avx::copy(x.a.data(), x.a.data() + x.n, x.c.data(), stores); return x.c[0]; };
+    };
+    benchmarks.push_back(bandwidth("copy" + suffix, "regular", arrays, 2, copies(Stores::regular)));
+    benchmarks.push_back(bandwidth("copy" + suffix, "stream", arrays, 2, copies(Stores::streaming)));
+    benchmarks.push_back(bandwidth("copy" + suffix, "auto", arrays, 2, copies(Stores::automatic)));
+    benchmarks.push_back(bandwidth("copy" + suffix, "libc", arrays, 2, [](Arrays& x) {
+      std::memcpy(x.c.data(), x.a.data(), x.n * sizeof(float));
+      return x.c[0];
+    }));
+
+    // the streamed body's software prefetch distance in bytes (pf), for detail::PrefetchBytes: DRAM only, below it the
+    // inputs are in cache already
+    if (n * sizeof(float) >= detail::streamingBytes()) {
+      benchmarks.push_back(bandwidth("copy" + suffix, "pf 0", arrays, 2, copyPrefetching<0u>));
+      benchmarks.push_back(bandwidth("copy" + suffix, "pf 256", arrays, 2, copyPrefetching<256u>));
+      benchmarks.push_back(bandwidth("copy" + suffix, "pf 512", arrays, 2, copyPrefetching<512u>));
+      benchmarks.push_back(bandwidth("copy" + suffix, "pf 1024", arrays, 2, copyPrefetching<1024u>));
+      benchmarks.push_back(bandwidth("copy" + suffix, "pf 2048", arrays, 2, copyPrefetching<2048u>));
+      benchmarks.push_back(bandwidth("copy" + suffix, "pf 4096", arrays, 2, copyPrefetching<4096u>));
+    }
+
+    const auto fills = [](Stores stores) {
+      return [stores](Arrays& x) { avx::fill(x.c.data(), x.c.data() + x.n, 2.f, stores); return x.c[0]; };
+    };
+    benchmarks.push_back(bandwidth("fill" + suffix, "regular", arrays, 1, fills(Stores::regular)));
+    benchmarks.push_back(bandwidth("fill" + suffix, "stream", arrays, 1, fills(Stores::streaming)));
+    benchmarks.push_back(bandwidth("fill" + suffix, "auto", arrays, 1, fills(Stores::automatic)));
+    benchmarks.push_back(bandwidth("fill" + suffix, "libc", arrays, 1, [](Arrays& x) {
+      std::memset(x.c.data(), 0, x.n * sizeof(float));
+      return x.c[0];
+    }));
+
+    // outputs Stores::automatic would stream only, see VecCopy.h
+    if (n * sizeof(float) >= detail::streamingBytes())
+      benchmarks.push_back({"addCeil" + suffix, "stream", Kind::bandwidth, n, n * 3u * sizeof(float),
+                            [arrays, addCeil](std::size_t iterations) {
+                              arrays->touch();
+                              auto& x = *arrays;
+                              for (std::size_t i{0}; i < iterations; ++i) {
+                                avx::transform<true>(span(x.a), span(x.b), span(x.c), addCeil);
+                                keepInMemory(x.c[0]);
+                              }
+                            }});
+  }
+}
+}
+
+void registerBenchmarks(std::vector<Benchmark>& benchmarks) {
+  registerOps(benchmarks);
+  registerStreaming(benchmarks);
+
+  benchmarks.push_back(clock<Idle>("scalar"));
+  benchmarks.push_back(clock<FusedMulAdds<vec8f>>("vec"));
+}
+}
+}
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Bench.h"
+#include "Vec.h"
+
+// helpers shared by Benchmarks.cc and Benchmarks512.cc; both are built with different ISAFLAGS, so everything in here
+// has internal linkage -- otherwise the linker is free to pick e.g. the avx512 copy for both, see Kernels.cc. That does
+// not cover the std:: code both instantiate: Benchmark's destructor, std::vector<Benchmark>'s insertion, std::string
+// and std::shared_ptr helpers are weak symbols of both objects, and GNU ld keeps the copy of the first object linked.
+// Benchmarks.o has to stay ahead of Benchmarks512.o in BENCH_OBJS, see the Makefile.
+
+namespace avx {
+namespace bench {
+
+namespace {
+
+template <typename V>
+auto keepVec(V& x) -> decltype(keep(x.ymm)) {
+  keep(x.ymm);
+}
+
+template <typename V>
+auto keepVec(V& x) -> decltype(keep(x.zmm)) {
+  keep(x.zmm);
+}
+
+template <typename V, typename Op>
+Benchmark latency(const char* name, Op op) {
+  return {name, "vec", Kind::latency, 1u, 0u, [op](std::size_t iterations) {
+            V x{typename V::Value{1}}, y{typename V::Value{1}};
+            keepVec(y);
+
+            for (std::size_t i{0}; i < iterations; ++i) {
+              x = op(x, y);
+              keepVec(x);
+            }
+          }};
+}
+
+template <typename V, typename Op>
+Benchmark throughput(const char* name, Op op) {
+  return {name, "vec", Kind::throughput, 8u, 0u, [op](std::size_t iterations) {
+            const typename V::Value one{1};
+            V x0{one}, x1{one}, x2{one}, x3{one}, x4{one}, x5{one}, x6{one}, x7{one}, y{one};
+            keepVec(y);
+
+            for (std::size_t i{0}; i < iterations; ++i) {
+              x0 = op(x0, y);
+              x1 = op(x1, y);
+              x2 = op(x2, y);
+              x3 = op(x3, y);
+              x4 = op(x4, y);
+              x5 = op(x5, y);
+              x6 = op(x6, y);
+              x7 = op(x7, y);
+              keepVec(x0), keepVec(x1), keepVec(x2), keepVec(x3), keepVec(x4), keepVec(x5), keepVec(x6), keepVec(x7);
+            }
+          }};
+}
+
+template <typename V, typename Op>
+void both(std::vector<Benchmark>& benchmarks, const char* name, Op op) {
+  benchmarks.push_back(latency<V>(name, op));
+  benchmarks.push_back(throughput<V>(name, op));
+}
+
+
+// core clock: a chain of dependent scalar adds retires one add per core cycle whatever the vector units do, so its
+// reference cycles per add are the ratio of the time stamp counter's rate to the core clock. Work runs next to it:
+// heavy 512 bit instructions lower the core clock on many cores (frequency licences), the x scalar column then is the
+// core clock relative to no vector work at all.
+struct Idle final {
+  void operator()() {}
+};
+
+// eight independent fused multiply adds per call, enough to keep the FMA units busy
+template <typename V>
+struct FusedMulAdds final {
+  V x0{1.f}, x1{1.f}, x2{1.f}, x3{1.f}, x4{1.f}, x5{1.f}, x6{1.f}, x7{1.f}, y{1.f};
+
+  void operator()() {
+    x0 = fusedMulAdd(x0, y, y), x1 = fusedMulAdd(x1, y, y), x2 = fusedMulAdd(x2, y, y), x3 = fusedMulAdd(x3, y, y);
+    x4 = fusedMulAdd(x4, y, y), x5 = fusedMulAdd(x5, y, y), x6 = fusedMulAdd(x6, y, y), x7 = fusedMulAdd(x7, y, y);
+    keepVec(x0), keepVec(x1), keepVec(x2), keepVec(x3), keepVec(x4), keepVec(x5), keepVec(x6), keepVec(x7);
+  }
+};
+
+template <typename Work>
+Benchmark clock(const char* variant) {
+  return {"clock", variant, Kind::latency, 8u, 0u, [](std::size_t iterations) {
+            Work work; // on the stack: std::function's heap storage is not over-aligned for vecs
+            std::size_t chain{0}, one{1};
+
+            // register operands: some cores fold chains of adds of immediates in the renamer
+            for (std::size_t i{0}; i < iterations; ++i) {
+              asm volatile("add %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\t"
+                           "add %1, %0\n\tadd %1, %0\n\tadd %1, %0\n\tadd %1, %0"
+                           : "+r"(chain)
+                           : "r"(one));
+              work();
+            }
+
+            keepInMemory(chain);
+          }};
+}
+
+
+// three arrays per working set, allocated on first use; 64 byte aligned so that spans can be loaded zmm-wise
+struct Arrays final {
+  std::size_t n;
+  AlignedVector<float, 64u> a, b, c;
+
+  explicit Arrays(std::size_t size) : n(size) {}
+
+  void touch() {
+    if (!a.empty())
+      return;
+    a.assign(n, 1.f);
+    b.assign(n, 0.5f);
+    c.assign(n, 0.f);
+  }
+};
+
+// elements per array; three arrays fit the level, e.g. 3 x 4 KiB in a 32 KiB L1
+const struct {
+  const char* level;
+  std::size_t n;
+} levels[] = {{"L1", 1u << 10}, {"L2", 1u << 14}, {"L3", 1u << 18}, {"DRAM", 1u << 25}};
+
+// kernel over arrays, returning a float to keep; touched counts the arrays read or written for bytes per element
+template <typename Kernel>
+Benchmark bandwidth(const std::string& name, const char* variant, std::shared_ptr<Arrays> arrays, std::size_t touched,
+                    Kernel kernel) {
+  const auto n = arrays->n;
+  const auto bytes = n * touched * sizeof(float);
+
+  return {name, variant, Kind::bandwidth, n, bytes, [arrays, kernel](std::size_t iterations) {
+            arrays->touch();
+            for (std::size_t i{0}; i < iterations; ++i) {
+              auto rv = kernel(*arrays);
+              keep(rv);
+              keepInMemory(arrays->c[0]);
+            }
+          }};
+}
+}
+}
+}
@@ -0,0 +1,93 @@
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Benchmarks.h"
+
+// built with ISAFLAGS.avx512 and KERNELFLAGS, see the Makefile; only entered on avx512 machines, see Bench.cc
+//
+// the 512 bit counterparts to Benchmarks.cc: ops on vec16f and vec16i, and the streaming kernels as variant vec512,
+// written against native<float> -- the same source as Kernels.cc, recompiled for zmm. Twice the lanes per instruction
+// do not come for free on every core: compare the clock benchmark's vec512 variant against vec and scalar.
+
+#if !defined(__AVX512F__)
+#error "build with ISAFLAGS.avx512, see Makefile"
+#endif
+
+namespace avx {
+namespace bench {
+
+namespace {
+
+void registerOps512(std::vector<Benchmark>& benchmarks) {
+  using f = vec16f;
+  using i = vec16i;
+
+  both<f>(benchmarks, "vec16f add", [](const f& x, const f& y) { return x + y; });
+  both<f>(benchmarks, "vec16f mul", [](const f& x, const f& y) { return x * y; });
+  both<f>(benchmarks, "vec16f div", [](const f& x, const f& y) { return x / y; });
+  both<f>(benchmarks, "vec16f fusedMulAdd", [](const f& x, const f& y) { return fusedMulAdd(x, y, y); });
+  both<f>(benchmarks, "vec16f min", [](const f& x, const f& y) { return min(x, y); });
+  both<f>(benchmarks, "vec16f sqrt", [](const f& x, const f&) { return sqrt(x); });
+  both<f>(benchmarks, "vec16f reciprocal", [](const f& x, const f&) { return reciprocal(x); });
+  both<f>(benchmarks, "vec16f compare+blend", [](const f& x, const f& y) { return blend(x, y, x < y); });
+  both<f>(benchmarks, "vec16f addMasked", [](const f& x, const f& y) { return addMasked(x, x < y, x, y); });
+  both<f>(benchmarks, "vec16f permute", [](const f& x, const f& y) { return permute(x, reinterpret(y)); });
+  both<f>(benchmarks, "vec16f compress", [](const f& x, const f& y) { return compress(x, x < y); });
+
+  both<i>(benchmarks, "vec16i add", [](const i& x, const i& y) { return x + y; });
+  both<i>(benchmarks, "vec16i mul", [](const i& x, const i& y) { return x * y; });
+  both<i>(benchmarks, "vec16i min", [](const i& x, const i& y) { return min(x, y); });
+  both<i>(benchmarks, "vec16i shiftLeft", [](const i& x, const i& y) { return x << y; });
+  both<i>(benchmarks, "vec16i compare+blend", [](const i& x, const i& y) { return blend(x, y, x > y); });
+  both<i>(benchmarks, "vec16i permute", [](const i& x, const i& y) { return permute(x, y); });
+  both<i>(benchmarks, "vec16i compress", [](const i& x, const i& y) { return compress(x, x > y); });
+}
+
+void registerStreaming512(std::vector<Benchmark>& benchmarks) {
+  for (const auto& level : levels) {
+    auto arrays = std::make_shared<Arrays>(level.n);
+    const auto suffix = std::string{"/"} + level.level;
+
+    // four accumulators as avx::sum, see VecReduce.h
+    benchmarks.push_back(bandwidth("sum" + suffix, "vec512", arrays, 1, [](Arrays& x) {
+      native<float> acc0{0.f}, acc1{0.f}, acc2{0.f}, acc3{0.f};
+      const auto* first = x.a.data();
+      const auto step = native<float>::Size;
+
+      std::size_t i{0};
+      for (; i + 4u * step <= x.n; i += 4u * step) {
+        acc0 += native<float>(first + i, first + i + step);
+        acc1 += native<float>(first + i + step, first + i + 2u * step);
+        acc2 += native<float>(first + i + 2u * step, first + i + 3u * step);
+        acc3 += native<float>(first + i + 3u * step, first + i + 4u * step);
+      }
+
+      forEach(first + i, first + x.n, [&](const auto& y, const auto&) { acc0 += y; });
+      return hSum((acc0 + acc1) + (acc2 + acc3));
+    }));
+
+    const auto copy = [](const auto& x) { return x; };
+    benchmarks.push_back(bandwidth("copy" + suffix, "vec512", arrays, 2, [=](Arrays& x) {
+      avx::transform(span(x.a), span(x.c), copy);
+      return x.c[0];
+    }));
+
+    const auto addCeil = [](const auto& x, const auto& y) { return x + ceil(y); };
+    benchmarks.push_back(bandwidth("addCeil" + suffix, "vec512", arrays, 3, [=](Arrays& x) {
+      avx::transform(span(x.a), span(x.b), span(x.c), addCeil);
+      return x.c[0];
+    }));
+  }
+}
+}
+
+void registerBenchmarks512(std::vector<Benchmark>& benchmarks) {
+  registerOps512(benchmarks);
+  registerStreaming512(benchmarks);
+
+  benchmarks.push_back(clock<FusedMulAdds<vec16f>>("vec512"));
+}
+}
+}
@@ -1,6 +1,15 @@
 CC = gcc
 CXX = g++
 CXXFLAGS = -pthread -fdiagnostics-color=auto -fmax-errors=1 -std=c++14 -O2 -g -Wall -Wextra -pedantic -Wuninitialized -Wstrict-overflow=3 -Wshadow
-CXXFLAGS += -mavx -mavx2 -mfma
-LDLIBS = -lstdc++ -lpthread
+LDLIBS = -lstdc++ -lm -lpthread
 LDFLAGS += -Wl,-O1 -Wl,--hash-style=gnu -Wl,--sort-common -Wl,--demangle -Wl,--build-id
+
+# instruction set levels; everything not built for a specific level has to run on the x86-64 baseline
+# keep in sync with the level masks in Detect.cc
+ISAFLAGS.generic =
+ISAFLAGS.sse4 = -msse4.1 -msse4.2
+ISAFLAGS.avx2 = $(ISAFLAGS.sse4) -mavx -mavx2 -mfma -mf16c
+ISAFLAGS.avx512 = $(ISAFLAGS.avx2) -mavx512f -mavx512dq -mavx512bw -mavx512vl -mprefer-vector-width=512
+
+# kernels built once per level, see Kernels.cc
+KERNELFLAGS = -O3 -fopenmp-simd
@@ -0,0 +1,281 @@
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <mutex>
+
+#include <cpuid.h>
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "Counters.h"
+#include "Detect.h"
+
+// compiled for the x86-64 baseline; must not include Vec.h or anything else built for a specific level
+
+namespace avx {
+namespace counters {
+
+namespace detail {
+std::atomic<bool> on{std::getenv("AVX_COUNTERS") != nullptr};
+const bool avx = cpu::has(cpu::avx);
+}
+
+namespace {
+
+// raw Intel events: event select | unit mask << 8, see the Intel SDM volume 3B and perfmon event lists
+const constexpr std::uint64_t fpArith256 = 0xC7u | 0x30u << 8; // FP_ARITH_INST_RETIRED.256B_PACKED_*
+const constexpr std::uint64_t fpArith512 = 0xC7u | 0xC0u << 8; // FP_ARITH_INST_RETIRED.512B_PACKED_*
+const constexpr std::uint64_t lvl1TurboLicense = 0x28u | 0x18u << 8; // CORE_POWER.LVL1_TURBO_LICENSE
+const constexpr std::uint64_t lvl2TurboLicense = 0x28u | 0x20u << 8; // CORE_POWER.LVL2_TURBO_LICENSE
+const constexpr std::uint64_t vectorWidthMismatch = 0x0Eu | 0x02u << 8; // UOPS_ISSUED.VECTOR_WIDTH_MISMATCH
+const constexpr std::uint64_t sseAvxMix = 0xC1u | 0x10u << 8; // ASSISTS.SSE_AVX_MIX
+
+enum class Core { other, broadwell, skylake, skylakeServer, iceLake, later };
+
+// family 6 models, see the Intel SDM volume 4 table 2-1
+Core core() {
+  std::uint32_t eax, ebx, ecx, edx;
+
+  if (!__get_cpuid(0, &eax, &ebx, &ecx, &edx) || ebx != 0x756E6547u || edx != 0x49656E69u || ecx != 0x6C65746Eu)
+    return Core::other; // GenuineIntel
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx) || (eax >> 8 & 0xFu) != 6u)
+    return Core::other;
+
+  switch ((eax >> 4 & 0xFu) | (eax >> 12 & 0xF0u)) {
+  case 0x3D: case 0x47: case 0x4F: case 0x56:
+    return Core::broadwell;
+  case 0x4E: case 0x5E: case 0x8E: case 0x9E: case 0xA5: case 0xA6:
+    return Core::skylake;
+  case 0x55:
+    return Core::skylakeServer; // and Cascade Lake, Cooper Lake
+  case 0x6A: case 0x6C: case 0x7D: case 0x7E:
+    return Core::iceLake;
+  case 0x8C: case 0x8D: case 0x8F: case 0xCF:
+    return Core::later; // Tiger Lake, Sapphire Rapids, Emerald Rapids
+  default:
+    return Core::other;
+  }
+}
+
+// false for events this machine does not have
+bool describe(Event event, Core at, perf_event_attr& attr) {
+  const auto hardware = [&](std::uint64_t config) {
+    attr.type = PERF_TYPE_HARDWARE;
+    attr.config = config;
+    return true;
+  };
+
+  const auto raw = [&](std::uint64_t config, bool available) {
+    attr.type = PERF_TYPE_RAW;
+    attr.config = config;
+    return available;
+  };
+
+  const auto software = [&](std::uint64_t config) {
+    attr.type = PERF_TYPE_SOFTWARE;
+    attr.config = config;
+    return true;
+  };
+
+  const auto fpArith = at != Core::other;
+  const auto licenses = at == Core::skylakeServer || at == Core::iceLake;
+
+  switch (event) {
+  case cycles:
+    return hardware(PERF_COUNT_HW_CPU_CYCLES);
+  case instructions:
+    return hardware(PERF_COUNT_HW_INSTRUCTIONS);
+  case cacheMisses:
+    return hardware(PERF_COUNT_HW_CACHE_MISSES);
+  case fp256:
+    return raw(fpArith256, fpArith);
+  case fp512:
+    return raw(fpArith512, fpArith);
+  case license1:
+    return raw(lvl1TurboLicense, licenses);
+  case license2:
+    return raw(lvl2TurboLicense, licenses);
+  case transitions:
+    if (at == Core::skylake || at == Core::skylakeServer)
+      return raw(vectorWidthMismatch, true);
+    return raw(sseAvxMix, at == Core::iceLake || at == Core::later);
+  case pageFaults:
+    return software(PERF_COUNT_SW_PAGE_FAULTS);
+  case taskClockNs:
+    return software(PERF_COUNT_SW_TASK_CLOCK);
+  case EventCount:
+    break;
+  }
+  return false;
+}
+
+// the thread's events, each counting on its own so that one refused event does not take the others with it; opened
+// on the thread's first enabled scope, counting the thread in user space from then on
+class Events final {
+public:
+  Events() {
+    static const auto at = core();
+
+    for (std::size_t event{0}; event < EventCount; ++event) {
+      perf_event_attr attr;
+      std::memset(&attr, 0, sizeof(attr));
+      attr.size = sizeof(attr);
+      attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+      attr.exclude_kernel = 1;
+      attr.exclude_hv = 1;
+
+      fds[event] = -1;
+      if (describe(static_cast<Event>(event), at, attr))
+        fds[event] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC));
+    }
+  }
+
+  ~Events() {
+    for (auto fd : fds)
+      if (fd >= 0)
+        ::close(fd);
+  }
+
+  Events(const Events&) = delete;
+  Events& operator=(const Events&) = delete;
+
+  void read(detail::Sample& sample) const {
+    for (std::size_t event{0}; event < EventCount; ++event) {
+      auto& reading = sample.readings[event];
+      reading = {0, 0, 0};
+
+      if (fds[event] >= 0 && ::read(fds[event], &reading, sizeof(reading)) != sizeof(reading))
+        reading = {0, 0, 0};
+    }
+  }
+
+  std::uint32_t available() const {
+    std::uint32_t rv{0};
+    for (std::size_t event{0}; event < EventCount; ++event)
+      rv |= fds[event] >= 0 ? 1u << event : 0u;
+    return rv;
+  }
+
+private:
+  int fds[EventCount];
+};
+
+const Events& events() {
+  static thread_local const Events opened;
+  return opened;
+}
+
+// the count while the scope was running, extrapolated to the whole scope when the kernel multiplexed the event
+std::uint64_t scaled(const detail::Reading& first, const detail::Reading& last) {
+  const auto value = last.value - first.value;
+  const auto enabled = last.enabled - first.enabled, running = last.running - first.running;
+
+  if (running == 0 || running == enabled)
+    return value;
+
+  return static_cast<std::uint64_t>(static_cast<double>(value) * enabled / running);
+}
+
+std::mutex lock;
+std::map<std::string, Stats> kernels;
+}
+
+
+const char* name(Event event) {
+  switch (event) {
+  case cycles:
+    return "cycles";
+  case instructions:
+    return "instructions";
+  case cacheMisses:
+    return "cacheMisses";
+  case fp256:
+    return "fp256";
+  case fp512:
+    return "fp512";
+  case license1:
+    return "license1";
+  case license2:
+    return "license2";
+  case transitions:
+    return "transitions";
+  case pageFaults:
+    return "pageFaults";
+  case taskClockNs:
+    return "taskClockNs";
+  case EventCount:
+    break;
+  }
+  return "unknown";
+}
+
+
+namespace detail {
+
+void read(Sample& sample) {
+  events().read(sample);
+  sample.time = std::chrono::steady_clock::now();
+}
+
+void add(const char* kernel, const Sample& first, const Sample& last) {
+  const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(last.time - first.time).count();
+  const auto available = events().available();
+
+  const std::lock_guard<std::mutex> guard{lock};
+
+  auto& stats = kernels[kernel];
+  stats.calls += 1;
+  stats.ns += static_cast<std::uint64_t>(ns);
+  stats.available |= available;
+
+  for (std::size_t event{0}; event < EventCount; ++event)
+    stats.values[event] += scaled(first.readings[event], last.readings[event]);
+}
+}
+
+
+std::vector<std::pair<std::string, Stats>> stats() {
+  const std::lock_guard<std::mutex> guard{lock};
+  return {kernels.begin(), kernels.end()};
+}
+
+void reset() {
+  const std::lock_guard<std::mutex> guard{lock};
+  kernels.clear();
+}
+
+void printJson(std::FILE* out) {
+  const auto all = stats();
+
+  std::fprintf(out, "{\n  \"kernels\": [\n");
+
+  for (std::size_t i{0}; i < all.size(); ++i) {
+    const auto& stats = all[i].second;
+    const auto has = [&](Event event) { return (stats.available >> event & 1u) != 0; };
+
+    // kernel names are written as they are: string literals without quotes or backslashes
+    std::fprintf(out, "    {\"name\": \"%s\", \"calls\": %llu, \"ns\": %llu", all[i].first.c_str(),
+                 static_cast<unsigned long long>(stats.calls), static_cast<unsigned long long>(stats.ns));
+
+    for (std::size_t event{0}; event < EventCount; ++event) {
+      if (has(static_cast<Event>(event)))
+        std::fprintf(out, ", \"%s\": %llu", name(static_cast<Event>(event)),
+                     static_cast<unsigned long long>(stats.values[event]));
+      else
+        std::fprintf(out, ", \"%s\": null", name(static_cast<Event>(event)));
+    }
+
+    if (has(cycles) && has(instructions) && stats.values[cycles] != 0)
+      std::fprintf(out, ", \"ipc\": %.4g", static_cast<double>(stats.values[instructions]) / stats.values[cycles]);
+    else
+      std::fprintf(out, ", \"ipc\": null");
+
+    std::fprintf(out, "}%s\n", i + 1 == all.size() ? "" : ",");
+  }
+
+  std::fprintf(out, "  ]\n}\n");
+}
+}
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+#include <immintrin.h>
+
+// per-kernel hardware counters: a Scope wraps a kernel region, reads the calling thread's perf_event counters on entry
+// and exit and adds the difference to the kernel's stats, see printJson. Events:
+//   cycles, instructions, cacheMisses: the generic hardware events (last level cache misses)
+//   fp256, fp512: FP_ARITH_INST_RETIRED 256 resp. 512 bit packed single and double, Broadwell and later
+//   license1, license2: cycles at the AVX2 resp. AVX-512 heavy frequency license (CORE_POWER.LVL1/LVL2_TURBO_LICENSE),
+//   Skylake-SP, Cascade Lake and Ice Lake
+//   transitions: SSE/AVX mixing -- UOPS_ISSUED.VECTOR_WIDTH_MISMATCH on Skylake and Cascade Lake, where SSE code after
+//   dirty upper halves gets blend uops; ASSISTS.SSE_AVX_MIX from Ice Lake on
+//   pageFaults, taskClockNs: software events, there without a PMU too
+// Model specific events are only opened on the Intel cores listed; events the machine or kernel refuse -- no PMU in a
+// VM, perf_event_paranoid above 2 -- are missing from the stats. Counts are scaled when the kernel multiplexes events.
+// Disabled, the default unless AVX_COUNTERS is set in the environment, a Scope is a relaxed load and a branch (plus the
+// vzeroupper); enabled it costs a read system call per event on entry and exit, some microseconds: wrap kernel calls
+// over arrays, not loop bodies.
+// Compiled for the x86-64 baseline, see Counters.cc; Exit::zeroUpper is skipped on machines without AVX.
+
+namespace avx {
+namespace counters {
+
+enum Event : std::size_t {
+  cycles,
+  instructions,
+  cacheMisses,
+  fp256,
+  fp512,
+  license1,
+  license2,
+  transitions,
+  pageFaults,
+  taskClockNs,
+  EventCount,
+};
+
+const char* name(Event event);
+
+namespace detail {
+  extern std::atomic<bool> on;
+
+  // the machine has AVX, for vzeroupper; false while static initialization has not got to Counters.cc yet
+  extern const bool avx;
+
+  // one event's raw count and its time enabled and running, for scaling
+  struct Reading final {
+    std::uint64_t value;
+    std::uint64_t enabled;
+    std::uint64_t running;
+  };
+
+  // the calling thread's counters; events not available are zero
+  struct Sample final {
+    Reading readings[EventCount];
+    std::chrono::steady_clock::time_point time;
+  };
+
+  void read(Sample& sample);
+  void add(const char* kernel, const Sample& first, const Sample& last);
+
+  // inlined into AVX code, where the compiler knows which register halves vzeroupper clears; a call from baseline code,
+  // and calls clobber all vector registers anyway
+  __attribute__((target("avx"))) inline void zeroUpper() { _mm256_zeroupper(); }
+}
+
+inline bool enabled() { return detail::on.load(std::memory_order_relaxed); }
+inline void enable(bool on = true) { detail::on.store(on, std::memory_order_relaxed); }
+
+// summed over a kernel's scopes on all threads
+struct Stats final {
+  std::uint64_t calls;
+  std::uint64_t ns;
+  std::uint64_t values[EventCount];
+  std::uint32_t available; // bit per event
+};
+
+// by kernel name
+std::vector<std::pair<std::string, Stats>> stats();
+void reset();
+
+// {"kernels": [{"name": .., "calls": .., "ns": .., "cycles": .., .., "ipc": ..}, ..]}, missing events as null
+void printJson(std::FILE* out = stdout);
+
+
+enum class Exit {
+  none,
+  zeroUpper, // vzeroupper: no SSE/AVX transition penalty or false dependency for SSE code after the scope; on AVX
+             // machines only, none elsewhere
+};
+
+// name has to outlive the scope; scopes of the same name are added up
+class Scope final {
+public:
+  explicit Scope(const char* name, Exit exit = Exit::zeroUpper)
+      : kernel(name), onExit(detail::avx ? exit : Exit::none), active(enabled()) {
+    if (active)
+      detail::read(first);
+  }
+
+  ~Scope() {
+    if (onExit == Exit::zeroUpper)
+      detail::zeroUpper();
+
+    if (active) {
+      detail::Sample last;
+      detail::read(last);
+      detail::add(kernel, first, last);
+    }
+  }
+
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  const char* kernel;
+  Exit onExit;
+  bool active;
+  detail::Sample first;
+};
+}
+}
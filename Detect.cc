@@ -0,0 +1,183 @@
+#include <cpuid.h>
+
+#include "Detect.h"
+
+// compiled for the x86-64 baseline; do not use anything Config.mk's ISAFLAGS.* would enable here
+
+namespace avx {
+namespace cpu {
+
+namespace {
+
+// feature bits for masking, see Detect.s and e.g.:
+// https://en.wikipedia.org/wiki/CPUID#EAX.3D1:_Processor_Info_and_Feature_Bits
+
+// eax=1, ecx:  1 << 28 | 1 << 27  (avx, osxsave)
+const constexpr std::uint32_t avxMask = 0x18000000;
+
+// eax=1, ecx:  1 << 28 | 1 << 27 | 1 << 12
+const constexpr std::uint32_t fmaMask = 0x18001000;
+
+// eax=1, ecx:  1 << 19, 1 << 20, 1 << 23, 1 << 29
+const constexpr std::uint32_t sse41Mask = 1u << 19;
+const constexpr std::uint32_t sse42Mask = 1u << 20;
+const constexpr std::uint32_t popcntMask = 1u << 23;
+const constexpr std::uint32_t f16cMask = 1u << 29;
+
+// eax=7, ecx=0, ebx:  1 << 5
+const constexpr std::uint32_t avx2Mask = 0x20;
+
+// eax=7, ecx=0, ebx:  1 << 16, 1 << 17, 1 << 30, 1 << 31
+const constexpr std::uint32_t avx512fMask = 1u << 16;
+const constexpr std::uint32_t avx512dqMask = 1u << 17;
+const constexpr std::uint32_t avx512bwMask = 1u << 30;
+const constexpr std::uint32_t avx512vlMask = 1u << 31;
+
+// xcr0: both xmm and ymm state enabled by OS
+const constexpr std::uint32_t xmmYmmEnabledMask = 0x6;
+
+// xcr0: opmask, upper 256 bit of zmm0-15 and zmm16-31 state enabled by OS
+const constexpr std::uint32_t zmmEnabledMask = 0xE0;
+
+inline bool isSet(std::uint32_t reg, std::uint32_t mask) { return (reg & mask) == mask; }
+
+// xgetbv is only valid if osxsave is set; there is no intrinsic without -mxsave
+std::uint32_t xcr0() {
+  std::uint32_t eax, edx;
+  __asm__ __volatile__("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return eax;
+}
+
+std::uint32_t probe() {
+  std::uint32_t rv{0};
+  std::uint32_t eax, ebx, ecx, edx;
+
+  if (!__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+    return rv;
+
+  if (isSet(ecx, sse41Mask))
+    rv |= sse41;
+  if (isSet(ecx, sse42Mask))
+    rv |= sse42;
+  if (isSet(ecx, popcntMask))
+    rv |= popcnt;
+  if (isSet(ecx, avxMask))
+    rv |= avx;
+  if (isSet(ecx, fmaMask))
+    rv |= fma;
+  if (isSet(ecx, f16cMask))
+    rv |= f16c;
+
+  // osxsave is part of avxMask; without it there is no xgetbv and no register state to rely on
+  std::uint32_t xcr{0};
+  if (rv & avx)
+    xcr = xcr0();
+
+  if (isSet(xcr, xmmYmmEnabledMask))
+    rv |= xmmYmmEnabled;
+  if (isSet(xcr, xmmYmmEnabledMask | zmmEnabledMask))
+    rv |= zmmEnabled;
+
+  if (!__get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx))
+    return rv;
+
+  if (isSet(ebx, avx2Mask))
+    rv |= avx2;
+  if (isSet(ebx, avx512fMask))
+    rv |= avx512f;
+  if (isSet(ebx, avx512dqMask))
+    rv |= avx512dq;
+  if (isSet(ebx, avx512bwMask))
+    rv |= avx512bw;
+  if (isSet(ebx, avx512vlMask))
+    rv |= avx512vl;
+
+  return rv;
+}
+
+// deterministic cache parameters, the same layout in leaf 4 and 0x8000001D: one subleaf per cache until type 0,
+// eax[4:0] type (1 data, 2 instruction, 3 unified), eax[7:5] level, ebx ways - 1 [31:22], partitions - 1 [21:12],
+// line size - 1 [11:0], ecx sets - 1
+std::size_t largestCache(std::uint32_t leaf) {
+  std::size_t rv{0};
+  std::uint32_t eax, ebx, ecx, edx;
+
+  for (std::uint32_t subleaf{0}; __get_cpuid_count(leaf, subleaf, &eax, &ebx, &ecx, &edx); ++subleaf) {
+    const auto type = eax & 0x1F;
+    if (type == 0)
+      break;
+    if (type == 2)
+      continue;
+
+    const std::size_t ways = (ebx >> 22) + 1, partitions = (ebx >> 12 & 0x3FF) + 1, line = (ebx & 0xFFF) + 1;
+    const std::size_t sets = std::size_t{ecx} + 1;
+    const auto bytes = ways * partitions * line * sets;
+
+    if (bytes > rv)
+      rv = bytes;
+  }
+
+  return rv;
+}
+
+// eax=0x80000001, ecx: 1 << 22  (topology extensions, AMD's leaf 0x8000001D)
+const constexpr std::uint32_t topologyExtensionsMask = 1u << 22;
+
+std::size_t probeCache() {
+  std::uint32_t eax, ebx, ecx, edx;
+  std::size_t rv{0};
+
+  if (__get_cpuid_max(0, nullptr) >= 4)
+    rv = largestCache(4);
+
+  if (rv == 0 && __get_cpuid(0x80000001, &eax, &ebx, &ecx, &edx) && isSet(ecx, topologyExtensionsMask))
+    rv = largestCache(0x8000001D);
+
+  return rv != 0 ? rv : std::size_t{8} << 20;
+}
+
+// has to match what ISAFLAGS.* in Config.mk enable for the kernel builds
+const constexpr std::uint32_t sse4Level = sse41 | sse42;
+const constexpr std::uint32_t avx2Level = sse4Level | avx | fma | f16c | avx2 | xmmYmmEnabled;
+const constexpr std::uint32_t avx512Level = avx2Level | avx512f | avx512dq | avx512bw | avx512vl | zmmEnabled;
+}
+
+
+std::uint32_t features() {
+  static const std::uint32_t cached = probe();
+  return cached;
+}
+
+Isa isa() {
+  static const Isa cached = [] {
+    if (has(avx512Level))
+      return Isa::avx512;
+    if (has(avx2Level))
+      return Isa::avx2;
+    if (has(sse4Level))
+      return Isa::sse4;
+    return Isa::generic;
+  }();
+  return cached;
+}
+
+std::size_t lastLevelCacheBytes() {
+  static const std::size_t cached = probeCache();
+  return cached;
+}
+
+const char* name(Isa level) {
+  switch (level) {
+  case Isa::generic:
+    return "generic";
+  case Isa::sse4:
+    return "sse4";
+  case Isa::avx2:
+    return "avx2";
+  case Isa::avx512:
+    return "avx512";
+  }
+  return "unknown";
+}
+}
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace avx {
+namespace cpu {
+
+// linkable version of Detect.s: cpuid feature bits plus OS support for saving and restoring register state (xgetbv)
+// the first four bits are the same as the ones Detect.s returns as exit code
+enum Feature : std::uint32_t {
+  avx = 1u << 0,
+  fma = 1u << 1,
+  avx2 = 1u << 2,
+  xmmYmmEnabled = 1u << 3,
+  sse41 = 1u << 4,
+  sse42 = 1u << 5,
+  popcnt = 1u << 6,
+  avx512f = 1u << 7,
+  avx512dq = 1u << 8,
+  avx512bw = 1u << 9,
+  avx512vl = 1u << 10,
+  zmmEnabled = 1u << 11,
+  f16c = 1u << 12,
+};
+
+// instruction set levels we build kernels for, ordered; see ISAFLAGS.* in Config.mk
+enum class Isa { generic, sse4, avx2, avx512 };
+
+// all features this machine and OS support; probed once
+std::uint32_t features();
+
+inline bool has(std::uint32_t required) { return (features() & required) == required; }
+
+// best level all required features are available for; probed once
+Isa isa();
+
+const char* name(Isa level);
+
+// size of the largest (last level) data or unified cache in bytes, shared by all cores on it; cpuid leaf 4 (Intel) or
+// 0x8000001D (AMD), a conservative 8 MiB if neither is there. Probed once.
+std::size_t lastLevelCacheBytes();
+}
+}
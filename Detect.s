@@ -1,3 +1,4 @@
+; standalone; for the linkable C++ version see Detect.h
 ; yasm -f elf64 -Worphan-labels Detect.s
 ; gcc -nostdlib Detect.o -o Detect
 
@@ -0,0 +1,26 @@
+#include "Detect.h"
+#include "Kernels.h"
+
+// compiled for the x86-64 baseline; must not include Vec.h or anything else built for a specific level
+
+namespace avx {
+namespace kernels {
+
+const Table& table() {
+  static const Table& picked = []() -> const Table& {
+    switch (cpu::isa()) {
+    case cpu::Isa::avx512:
+      return avx512::table;
+    case cpu::Isa::avx2:
+      return avx2::table;
+    case cpu::Isa::sse4:
+      return sse4::table;
+    case cpu::Isa::generic:
+      return generic::table;
+    }
+    return generic::table;
+  }();
+  return picked;
+}
+}
+}
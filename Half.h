@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+#include "VecBase.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// 16 bit floating point storage, arithmetic happens in float -- see the vec8f load and store overloads and VecHalf.h:
+//   Half: IEEE 754 binary16, 5 bit exponent and 10 bit mantissa; up to 65504, about three decimal digits. F16C
+//   converts eight at a time (vcvtph2ps, vcvtps2ph), rounding to nearest even.
+//   BFloat16: the upper half of a float, 8 bit exponent and 7 bit mantissa; float's range, about two decimal digits.
+//   Widening is a shift, narrowing rounds to nearest even; nans stay (quiet) nans.
+
+struct Half final {
+  std::uint16_t bits;
+};
+
+struct BFloat16 final {
+  std::uint16_t bits;
+};
+
+inline Half toHalf(float x) { return {static_cast<std::uint16_t>(_cvtss_sh(x, _MM_FROUND_TO_NEAREST_INT))}; }
+inline float toFloat(Half x) { return _cvtsh_ss(x.bits); }
+
+inline BFloat16 toBFloat16(float x) {
+  std::uint32_t bits;
+  std::memcpy(&bits, &x, sizeof(bits));
+
+  if ((bits & 0x7FFFFFFFu) > 0x7F800000u)
+    return {static_cast<std::uint16_t>(bits >> 16 | 0x40u)};
+
+  return {static_cast<std::uint16_t>((bits + 0x7FFFu + (bits >> 16 & 1u)) >> 16)};
+}
+
+inline float toFloat(BFloat16 x) {
+  const std::uint32_t bits = static_cast<std::uint32_t>(x.bits) << 16;
+  float rv;
+  std::memcpy(&rv, &bits, sizeof(rv));
+  return rv;
+}
+
+
+namespace detail {
+
+  // eight bfloat16 to eight floats and back, as above
+  inline __m256 widenBFloat16(__m128i x) {
+    return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(x), 16));
+  }
+
+  inline __m128i narrowBFloat16(__m256 x) {
+    const auto bits = _mm256_castps_si256(x);
+    const auto odd = _mm256_and_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(1));
+    const auto bias = _mm256_add_epi32(odd, _mm256_set1_epi32(0x7FFF));
+    const auto rounded = _mm256_srli_epi32(_mm256_add_epi32(bits, bias), 16);
+
+    const auto quiet = _mm256_or_si256(_mm256_srli_epi32(bits, 16), _mm256_set1_epi32(0x40));
+    const auto nan = _mm256_castps_si256(_mm256_cmp_ps(x, x, _CMP_UNORD_Q));
+    const auto narrowed = _mm256_blendv_epi8(rounded, quiet, nan);
+
+    // all lanes fit 16 bits, the unsigned saturation never kicks in
+    return _mm_packus_epi32(_mm256_castsi256_si128(narrowed), _mm256_extracti128_si256(narrowed, 1));
+  }
+}
+}
+}
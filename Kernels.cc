@@ -0,0 +1,58 @@
+#include <cmath>
+#include <cstddef>
+
+#include "Kernels.h"
+
+// built once per instruction set level, see the Kernels.%.o rule in the Makefile:
+//   AVX_KERNELS_ISA names the level and thereby the namespace this build's table lives in
+//   helpers have internal linkage only, otherwise the linker is free to pick e.g. the avx512 copy for all levels
+
+#ifndef AVX_KERNELS_ISA
+#error "compile with -DAVX_KERNELS_ISA=generic|sse4|avx2|avx512, see Makefile"
+#endif
+
+// AVX2 and AVX-512 builds share the vec kernels below: native<float> is vec8f resp. vec16f for them
+#if defined(__AVX2__) && defined(__FMA__)
+#define AVX_KERNELS_VEC
+#include "Vec.h"
+#endif
+
+namespace avx {
+namespace kernels {
+namespace AVX_KERNELS_ISA {
+
+namespace {
+
+#ifdef AVX_KERNELS_VEC
+float sum(const float* first, std::size_t n) {
+  native<float> acc{0.f};
+  forEach(first, first + n, [&](const auto& x, const auto&) { acc += x; });
+  return hSum(acc);
+}
+
+void addCeil(float* out, const float* lhs, const float* rhs, std::size_t n) {
+  transform(lhs, lhs + n, rhs, out, [](const auto& a, const auto& b) { return a + ceil(b); });
+}
+#else
+// no vec<T, N> for this level (yet): plain loops, vectorized by the compiler for the level's ISAFLAGS.*
+float sum(const float* first, std::size_t n) {
+  float rv{0.f};
+#pragma omp simd reduction(+ : rv)
+  for (std::size_t i = 0; i < n; ++i)
+    rv += first[i];
+  return rv;
+}
+
+void addCeil(float* out, const float* lhs, const float* rhs, std::size_t n) {
+#pragma omp simd
+  for (std::size_t i = 0; i < n; ++i)
+    out[i] = lhs[i] + std::ceil(rhs[i]);
+}
+#endif
+}
+
+
+extern const Table table{cpu::Isa::AVX_KERNELS_ISA, sum, addCeil};
+}
+}
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include "Detect.h"
+
+namespace avx {
+namespace kernels {
+
+// Kernels.cc is compiled once per instruction set level (ISAFLAGS.* in Config.mk), each build defines its own table
+struct Table final {
+  cpu::Isa isa;
+
+  // sum over [first, first + n)
+  float (*sum)(const float* first, std::size_t n);
+
+  // out[i] = lhs[i] + ceil(rhs[i]), out may alias lhs or rhs
+  void (*addCeil)(float* out, const float* lhs, const float* rhs, std::size_t n);
+};
+
+namespace generic {
+  extern const Table table;
+}
+
+namespace sse4 {
+  extern const Table table;
+}
+
+namespace avx2 {
+  extern const Table table;
+}
+
+namespace avx512 {
+  extern const Table table;
+}
+
+// best table for this machine, picked once on first use; see Dispatch.cc
+const Table& table();
+}
+}
@@ -0,0 +1,218 @@
+#include <cstddef>
+#include <algorithm>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <pthread.h>
+#include <sched.h>
+
+#include "Parallel.h"
+
+// compiled for the x86-64 baseline; must not include Vec.h or anything else built for a specific level
+
+namespace avx {
+namespace parallel {
+
+namespace {
+
+// chunks [next, last) still to do by one worker; owners take from the front, thieves half from the back
+struct alignas(64) Slot final {
+  std::mutex lock;
+  std::size_t next{0};
+  std::size_t last{0};
+};
+
+thread_local bool isWorker{false};
+
+class Pool final {
+public:
+  Pool() {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+
+    std::vector<int> pinned;
+    if (::sched_getaffinity(0, sizeof(cpus), &cpus) == 0)
+      for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu)
+        if (CPU_ISSET(cpu, &cpus))
+          pinned.push_back(cpu);
+
+    const auto workers = std::max<std::size_t>(1u, pinned.size());
+    slots = std::make_unique<Slot[]>(workers);
+    threads.reserve(workers);
+
+    for (std::size_t worker = 0; worker < workers; ++worker) {
+      threads.emplace_back([this, worker] { work(worker); });
+
+      if (worker < pinned.size()) {
+        cpu_set_t cpu;
+        CPU_ZERO(&cpu);
+        CPU_SET(pinned[worker], &cpu);
+        ::pthread_setaffinity_np(threads.back().native_handle(), sizeof(cpu), &cpu);
+      }
+    }
+  }
+
+  ~Pool() {
+    {
+      std::lock_guard<std::mutex> guard{lock};
+      stop = true;
+    }
+    wake.notify_all();
+
+    for (auto& thread : threads)
+      thread.join();
+  }
+
+  std::size_t size() const { return threads.size(); }
+
+  void run(std::size_t chunks, Schedule schedule, detail::Body body, const void* context) {
+    if (chunks == 0)
+      return;
+
+    if (chunks == 1 || size() == 1 || isWorker) {
+      for (std::size_t chunk = 0; chunk < chunks; ++chunk)
+        body(context, chunk, 0);
+      return;
+    }
+
+    // one job at a time for callers from different threads
+    std::lock_guard<std::mutex> serialize{running};
+
+    for (std::size_t worker = 0; worker < size(); ++worker) {
+      std::lock_guard<std::mutex> guard{slots[worker].lock};
+      slots[worker].next = chunks * worker / size();
+      slots[worker].last = chunks * (worker + 1) / size();
+    }
+
+    std::unique_lock<std::mutex> guard{lock};
+
+    job = Job{schedule, body, context};
+    error = nullptr;
+    pending = size();
+    ++generation;
+
+    wake.notify_all();
+    done.wait(guard, [this] { return pending == 0; });
+
+    if (error)
+      std::rethrow_exception(error);
+  }
+
+private:
+  struct Job final {
+    Schedule schedule;
+    detail::Body body;
+    const void* context;
+  };
+
+  void work(std::size_t worker) {
+    isWorker = true;
+    std::size_t seen{0};
+
+    for (;;) {
+      Job current{Schedule::stealing, nullptr, nullptr};
+
+      {
+        std::unique_lock<std::mutex> guard{lock};
+        wake.wait(guard, [&] { return stop || generation != seen; });
+
+        if (stop)
+          return;
+
+        seen = generation;
+        current = job;
+      }
+
+      std::size_t chunk;
+      while (take(worker, chunk) || (current.schedule == Schedule::stealing && steal(worker, chunk))) {
+        try {
+          current.body(current.context, chunk, worker);
+        } catch (...) {
+          std::lock_guard<std::mutex> guard{lock};
+          if (!error)
+            error = std::current_exception();
+        }
+      }
+
+      {
+        std::lock_guard<std::mutex> guard{lock};
+        if (--pending != 0)
+          continue;
+      }
+      done.notify_one();
+    }
+  }
+
+  bool take(std::size_t worker, std::size_t& chunk) {
+    auto& slot = slots[worker];
+    std::lock_guard<std::mutex> guard{slot.lock};
+
+    if (slot.next == slot.last)
+      return false;
+
+    chunk = slot.next++;
+    return true;
+  }
+
+  // moves the back half of the first non-empty victim's chunks into our slot, starting with the closest neighbour
+  bool steal(std::size_t thief, std::size_t& chunk) {
+    for (std::size_t offset = 1; offset < size(); ++offset) {
+      auto& victim = slots[(thief + offset) % size()];
+      std::size_t first, last;
+
+      {
+        std::lock_guard<std::mutex> guard{victim.lock};
+        if (victim.next == victim.last)
+          continue;
+
+        const auto remaining = victim.last - victim.next;
+        first = victim.last - (remaining + 1) / 2;
+        last = victim.last;
+        victim.last = first;
+      }
+
+      auto& own = slots[thief];
+      std::lock_guard<std::mutex> guard{own.lock};
+      own.next = first + 1;
+      own.last = last;
+      chunk = first;
+      return true;
+    }
+    return false;
+  }
+
+  std::vector<std::thread> threads;
+  std::unique_ptr<Slot[]> slots;
+
+  std::mutex running;
+
+  std::mutex lock;
+  std::condition_variable wake;
+  std::condition_variable done;
+  Job job{Schedule::stealing, nullptr, nullptr};
+  std::exception_ptr error;
+  std::size_t pending{0};
+  std::size_t generation{0};
+  bool stop{false};
+};
+
+Pool& pool() {
+  static Pool instance;
+  return instance;
+}
+}
+
+std::size_t concurrency() { return pool().size(); }
+
+namespace detail {
+
+void run(std::size_t chunks, Schedule schedule, Body body, const void* context) {
+  pool().run(chunks, schedule, body, context);
+}
+}
+}
+}
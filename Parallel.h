@@ -0,0 +1,187 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include "VecMemory.h"
+
+// compiled for the x86-64 baseline, see Parallel.cc; vec kernels on top of it are in VecParallel.h
+
+namespace avx {
+namespace parallel {
+
+// a pool with one worker per cpu in the process' affinity mask, each pinned to its cpu. Ranges are cut into chunks
+// along cache lines, so that no two workers ever write to the same line, and split evenly across the workers.
+//
+// first touch: the kernel places a page on the NUMA node of the thread writing it first. Initializing fresh memory
+// with Schedule::fixed (see fill, iota, firstTouch) puts every chunk on the node of the worker that gets the same
+// chunk in later passes over a range of the same size; memory has to be left untouched until then, e.g. Arena memory
+// and not a value-initialized std::vector.
+
+enum class Schedule {
+  stealing, // workers out of chunks steal half of the remaining ones of another worker: for uneven work
+  fixed,    // worker w always gets the same chunks: for first touch
+};
+
+// number of workers; worker indices are in [0, concurrency())
+std::size_t concurrency();
+
+namespace detail {
+
+  using Body = void (*)(const void* context, std::size_t chunk, std::size_t worker);
+
+  // body(context, c, w) for all chunks c in [0, chunks) on the workers, returns once all are done; runs on the calling
+  // thread if there is a single chunk or worker, or when called from a worker. The first exception thrown is rethrown.
+  void run(std::size_t chunks, Schedule schedule, Body body, const void* context);
+
+  // [0, n) cut at cache line boundaries of anchor: chunk 0 is [0, head + grain), chunk c > 0 is
+  // [head + c * grain, head + (c + 1) * grain), all capped at n
+  struct Chunks final {
+    std::size_t n;
+    std::size_t head;
+    std::size_t grain;
+
+    std::size_t count() const { return n <= head + grain ? 1u : (n - head + grain - 1u) / grain; }
+    std::size_t first(std::size_t chunk) const { return chunk == 0 ? 0 : std::min(n, head + chunk * grain); }
+    std::size_t last(std::size_t chunk) const { return std::min(n, head + (chunk + 1u) * grain); }
+    // the chunk starting at first
+    std::size_t index(std::size_t first) const { return first < head + grain ? 0 : (first - head) / grain; }
+  };
+
+  template <typename T>
+  inline Chunks chunks(const T* anchor, std::size_t n, std::size_t grainBytes) {
+    const std::size_t line = 64u;
+    const auto misalignment = reinterpret_cast<std::uintptr_t>(anchor) % line;
+
+    std::size_t head{0};
+    if (misalignment != 0 && misalignment % sizeof(T) == 0)
+      head = std::min(n, (line - misalignment) / sizeof(T));
+
+    const auto bytes = (std::max(grainBytes, line) + line - 1u) / line * line;
+    return {n, head, std::max<std::size_t>(1u, bytes / sizeof(T))};
+  }
+
+  template <typename Fn>
+  struct ForEach final {
+    const Chunks& chunks;
+    Fn& fn;
+
+    static void call(const void* context, std::size_t chunk, std::size_t) {
+      const auto& self = *static_cast<const ForEach*>(context);
+      self.fn(self.chunks.first(chunk), self.chunks.last(chunk));
+    }
+  };
+
+  template <typename Acc>
+  struct alignas(64) Padded final {
+    Acc value;
+  };
+
+  template <typename Acc, typename Fn, typename Combine>
+  struct Reduce final {
+    const Chunks& chunks;
+    Fn& fn;
+    Combine& combine;
+    Padded<Acc>* acc;
+
+    static void call(const void* context, std::size_t chunk, std::size_t worker) {
+      const auto& self = *static_cast<const Reduce*>(context);
+      auto& into = self.acc[worker].value;
+      into = self.combine(into, self.fn(self.chunks.first(chunk), self.chunks.last(chunk)));
+    }
+  };
+}
+
+// default chunk size, a third of a typical 48 KiB L1
+static const constexpr std::size_t DefaultGrainBytes = 16u * 1024u;
+
+
+// fn(first, last) for disjoint [first, last) covering [0, n), concurrently; cut along cache lines of anchor[0, n),
+// usually the array written to
+template <typename T, typename Fn>
+inline void forEach(const T* anchor, std::size_t n, Fn fn, Schedule schedule = Schedule::stealing,
+                    std::size_t grainBytes = DefaultGrainBytes) {
+  const auto chunks = detail::chunks(anchor, n, grainBytes);
+  const detail::ForEach<Fn> context{chunks, fn};
+  detail::run(chunks.count(), schedule, &detail::ForEach<Fn>::call, &context);
+}
+
+// fn(first, last) for disjoint [first, last) covering [0, n), cut at multiples of grain elements from index 0 whatever
+// the address: for results that have to depend on the index alone, e.g. counter-based random numbers; neighbouring
+// chunks may share a cache line at their boundary
+template <typename Fn>
+inline void forEachIndex(std::size_t n, std::size_t grain, Fn fn, Schedule schedule = Schedule::stealing) {
+  const detail::Chunks chunks{n, 0, std::max<std::size_t>(1u, grain)};
+  const detail::ForEach<Fn> context{chunks, fn};
+  detail::run(chunks.count(), schedule, &detail::ForEach<Fn>::call, &context);
+}
+
+// combine over fn(first, last) for disjoint [first, last) covering [0, n): chunk results are combined into one
+// accumulator per worker, those in worker order. Which chunks a worker gets varies from run to run with stealing, so
+// non-associative combines such as float addition differ in the last bits between runs; use Schedule::fixed if not
+template <typename T, typename Acc, typename Fn, typename Combine>
+inline Acc reduce(const T* anchor, std::size_t n, Acc identity, Fn fn, Combine combine,
+                  Schedule schedule = Schedule::stealing, std::size_t grainBytes = DefaultGrainBytes) {
+  AlignedVector<detail::Padded<Acc>, 64u> acc(concurrency(), detail::Padded<Acc>{identity});
+
+  const auto chunks = detail::chunks(anchor, n, grainBytes);
+  const detail::Reduce<Acc, Fn, Combine> context{chunks, fn, combine, acc.data()};
+  detail::run(chunks.count(), schedule, &detail::Reduce<Acc, Fn, Combine>::call, &context);
+
+  auto rv = identity;
+  for (const auto& each : acc)
+    rv = combine(rv, each.value);
+  return rv;
+}
+
+// two passes over the same chunks of [0, n), e.g. for prefix sums and compaction: first(first, last) summarizes a
+// chunk into an Acc, those are combined from init in chunk order, then second(first, last, acc) gets the combination
+// of init and all chunks before its own. Returns the combination of init and all chunks.
+template <typename T, typename Acc, typename First, typename Combine, typename Second>
+inline Acc scan(const T* anchor, std::size_t n, Acc init, First first, Combine combine, Second second,
+                Schedule schedule = Schedule::stealing, std::size_t grainBytes = DefaultGrainBytes) {
+  const auto chunks = detail::chunks(anchor, n, grainBytes);
+  std::vector<Acc> acc(chunks.count(), init);
+
+  forEach(anchor, n, [&](std::size_t i, std::size_t j) { acc[chunks.index(i)] = first(i, j); }, schedule, grainBytes);
+
+  auto rv = init;
+  for (auto& each : acc)
+    rv = combine(rv, std::exchange(each, rv));
+
+  forEach(anchor, n, [&](std::size_t i, std::size_t j) { second(i, j, acc[chunks.index(i)]); }, schedule, grainBytes);
+  return rv;
+}
+
+
+// first touch initialization, see above
+
+template <typename T>
+inline void fill(T* first, T* last, T value) {
+  forEach(first, static_cast<std::size_t>(last - first), [=](std::size_t i, std::size_t j) {
+    std::fill(first + i, first + j, value);
+  }, Schedule::fixed);
+}
+
+// first[i] = value + i
+template <typename T>
+inline void iota(T* first, T* last, T value) {
+  forEach(first, static_cast<std::size_t>(last - first), [=](std::size_t i, std::size_t j) {
+    for (; i < j; ++i)
+      first[i] = value + static_cast<T>(i);
+  }, Schedule::fixed);
+}
+
+// places the pages of [first, last) without initializing them to anything in particular
+template <typename T>
+inline void firstTouch(T* first, T* last) {
+  forEach(first, static_cast<std::size_t>(last - first), [=](std::size_t i, std::size_t j) {
+    const std::size_t page = 4096u / sizeof(T) == 0 ? 1u : 4096u / sizeof(T);
+    for (; i < j; i += page)
+      *reinterpret_cast<volatile unsigned char*>(first + i) = 0;
+  }, Schedule::fixed);
+}
+}
+}
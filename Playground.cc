@@ -0,0 +1,2066 @@
+#include <vector>
+#include <iostream>
+#include <stdexcept>
+#include <algorithm>
+#include <iterator>
+#include <chrono>
+#include <numeric>
+#include <random>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <cstring>
+#include <utility>
+#include <cstdio>
+#include <cstdint>
+#include <unordered_map>
+#include <memory>
+
+#include "Vec.h"
+#include "Counters.h"
+#include "Playground.h"
+
+#define R(...) std::cout << __VA_ARGS__ << std::endl;
+
+
+void blendTest() {
+  avx::vec8f a{0.};
+  avx::vec8f b{1.};
+  R(a);
+  R(b);
+
+  const constexpr auto oddEvenMask = 1 << 1 | 1 << 3 | 1 << 5 | 1 << 7;
+  const constexpr auto evenOddMask = 1 << 0 | 1 << 2 | 1 << 4 | 1 << 6;
+  const constexpr auto selectFirstMask = 0b1000'0000;
+  const constexpr auto selectLastMask = 0b0000'0001;
+  R(avx::blend<oddEvenMask>(a, b));
+  R(avx::blend<evenOddMask>(a, b));
+  R(avx::blend<selectFirstMask>(a, b));
+  R(avx::blend<selectLastMask>(a, b));
+}
+
+
+void dotTest() {
+  avx::vec8f a{1, 1, 1, 1, 2, 2, 2, 2};
+  avx::vec8f b{2, 2, 2, 2, 3, 3, 3, 3};
+  R(a);
+  R(b);
+
+  // dot really is dot(a[0:4],b[0:4]) ++ dot(a[4:8],b[4:8]), resulting in effectively two dot products instead of one
+  const auto dp = dot(a, b);
+  R(dp);
+}
+
+
+void permuteTest() {
+  avx::vec8f v{1, 2, 3, 4, 5, 6, 7, 8};
+  R(v);
+  // select4 on each 128 lane
+  R(avx::permute<0b1010'1010>(v));
+  R(avx::permute<0b0101'0101>(v));
+
+  avx::vec8f w{8, 7, 6, 5, 4, 3, 2, 1};
+  R(v);
+  R(w);
+  R(avx::permute<0b0111'0111>(v, w));
+}
+
+
+void shuffleTest() {
+  avx::vec8f x{10, 20, 30, 40, 50, 60, 70, 80};
+  avx::vec8f y{11, 21, 31, 41, 51, 61, 71, 81};
+  R(x);
+  R(y);
+
+  R(avx::shuffle<0b0101'0101>(x, y));
+}
+
+
+void unpackTest() {
+  avx::vec8f x{10, 20, 30, 40, 50, 60, 70, 80};
+  avx::vec8f y{11, 21, 31, 41, 51, 61, 71, 81};
+
+  R(x);
+  R(y);
+  R(unpackHigh(x, y));
+  R(unpackLow(x, y));
+}
+
+
+void fmaTest() {
+  avx::vec8f a{10, 20, 30, 40, 50, 60, 70, 80};
+  avx::vec8f b{0, 1, 0, 0, 0, 0, 0, 0};
+  avx::vec8f c{1, 2, 3, 4, 5, 6, 7, 8};
+  R(a);
+  R(b);
+  R(c);
+  // a*b + c
+  R(fusedMulAdd(a, b, c));
+}
+
+
+void shiftTest() {
+  avx::vec8i v{1,2,3,4,5,6,7,8};
+  R(v);
+
+  auto l = v << 2;
+  auto r = v >> 2;
+
+  R(l);
+  R(r);
+}
+
+
+void bitTest() {
+  avx::vec8i x{0xFFFFFF};
+  avx::vec8i y{0x0};
+
+  R(x);
+  R(y);
+  R(~x);
+  R(~y);
+  R(0-x);
+  R(abs(x));
+}
+
+
+void comparisonTest() {
+  avx::vec8i a{1,2,3,4,5,6,7,8};
+  avx::vec8i b{0,2,3,4,5,6,7,8};
+
+  R((a > a));
+  R((a < a));
+  R((a >= a));
+  R((a <= a));
+  R((a != a));
+  R((a == a));
+
+  R((a < b));
+  R((a > b));
+}
+
+
+void tailTest() {
+  // neither the size nor the offset are multiples of 8
+  std::vector<float> fst(1'000'003u + 3u);
+  std::vector<float> snd(1'000'003u + 3u);
+  std::iota(begin(fst), end(fst), 0u);
+  std::iota(snd.rbegin(), snd.rend(), 0u);
+
+  avx::transform(&fst[3], &fst[fst.size() - 1], &snd[3], &fst[3],
+                 [](const avx::vec8f& a, const avx::vec8f& b) { return a + ceil(b); });
+  R(fst[2] << ' ' << fst[3] << ' ' << fst[fst.size() - 2] << ' ' << fst.back());
+
+  std::vector<std::int32_t> ints{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  avx::vec8i z{0};
+  avx::forEach(&ints[1], &ints[ints.size()], [&](const avx::vec8i& x, const avx::vec8i&) { z += x; });
+  R(z);
+
+  avx::vec8i w;
+  w.load_partial(&ints[0], &ints[3]);
+  R(w);
+  w.store_partial(&ints[8], &ints[11]);
+  R(ints.back());
+}
+
+
+void lookupTest() {
+  std::vector<float> table{0, 10, 20, 30, 40, 50, 60, 70, 80, 90, 100, 110, 120, 130, 140, 150, 160, 170, 180, 190};
+  std::vector<std::int32_t> index{19, 0, 3, 8, 15, 16, 1, 2, 7, 11, 4};
+  std::vector<float> out(index.size());
+
+  avx::lookup(table.data(), table.size(), &index.front(), &index.back() + 1, out.data());
+  std::copy(begin(out), end(out), std::ostream_iterator<float>(std::cout, " "));
+  R("");
+
+  avx::gather(table.data(), &index.front(), &index.back() + 1, out.data());
+  std::copy(begin(out), end(out), std::ostream_iterator<float>(std::cout, " "));
+  R("");
+
+  std::vector<std::int32_t> ints{-1, -2, -3, -4, -5, -6, -7, -8, -9, -10, -11, -12};
+  const avx::RegisterTable<std::int32_t, 16u> small(&ints.front(), &ints.back() + 1);
+  R(small({0, 11, 12, 15, 8, 7, 3, 9}));
+
+  avx::vec8f x{0.f};
+  x.gather_masked(table.data(), {&index[0], &index[8]}, avx::laneMask(3));
+  R(x);
+  x.scatter_masked(out.data(), {0, 1, 2, 3, 4, 5, 6, 7}, avx::laneMask(2));
+  R(out[0] << ' ' << out[1] << ' ' << out[2]);
+}
+
+
+// register tables vs. gathers vs. scalar lookups; ms for the same L2-resident random indices per table size
+void lookupPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  const constexpr auto repeat = 5'000u;
+  std::vector<std::int32_t> index(16'384u);
+  std::vector<float> out(index.size());
+
+  for (std::size_t size : {8u, 16u, 32u, 1024u, 1u << 16, 1u << 24}) {
+    std::vector<float> table(size);
+    std::iota(begin(table), end(table), 0.f);
+
+    std::mt19937 gen{0};
+    std::uniform_int_distribution<std::int32_t> dist(0, static_cast<std::int32_t>(size) - 1);
+    std::generate(begin(index), end(index), [&] { return dist(gen); });
+
+    const auto t0 = clock::now();
+    for (auto n = 0u; n < repeat; ++n)
+      for (std::size_t i{0}; i < index.size(); ++i)
+        out[i] = table[index[i]];
+    const auto t1 = clock::now();
+    for (auto n = 0u; n < repeat; ++n)
+      avx::gather(table.data(), &index.front(), &index.back() + 1, out.data());
+    const auto t2 = clock::now();
+    for (auto n = 0u; n < repeat; ++n)
+      avx::lookup(table.data(), table.size(), &index.front(), &index.back() + 1, out.data());
+    const auto t3 = clock::now();
+
+    R(size << " scalar " << std::chrono::duration_cast<ms>(t1 - t0).count() << " gather "
+           << std::chrono::duration_cast<ms>(t2 - t1).count() << " lookup "
+           << std::chrono::duration_cast<ms>(t3 - t2).count());
+  }
+}
+
+
+namespace {
+// distance to the double precision reference in units in the last place of the float result
+double ulps(float approx, double exact) {
+  if (std::isnan(exact) || std::isinf(exact))
+    return (std::isnan(exact) && std::isnan(approx)) || approx == exact ? 0. : std::numeric_limits<double>::infinity();
+
+  const auto rounded = static_cast<float>(exact);
+  const auto ulp = std::nextafter(std::fabs(rounded), std::numeric_limits<float>::infinity()) - std::fabs(rounded);
+  return std::fabs(approx - exact) / ulp;
+}
+
+template <typename Approx, typename Exact>
+void maxError(const char* name, float first, float last, Approx approx, Exact exact) {
+  double maxUlps{0}, maxAbs{0};
+
+  const auto step = (last - first) / 1e7f;
+  for (auto x = first; x + 7 * step < last; x += 8 * step) {
+    const avx::vec8f v{x, x + step, x + 2 * step, x + 3 * step, x + 4 * step, x + 5 * step, x + 6 * step, x + 7 * step};
+    const auto r = approx(v);
+
+    for (std::size_t i{0}; i < 8; ++i) {
+      const auto e = exact(static_cast<double>(v[i]));
+      maxUlps = std::max(maxUlps, ulps(r[i], e));
+      maxAbs = std::max(maxAbs, std::fabs(r[i] - e));
+    }
+  }
+
+  R(name << " [" << first << ", " << last << ") max ulp " << maxUlps << " max abs " << maxAbs);
+}
+}
+
+
+void mathTest() {
+  using avx::vec8f;
+  const auto pow3 = [](double x) { return std::pow(x, 3.5); };
+
+  maxError("exp", -103.9f, 88.7f, [](const vec8f& x) { return exp(x); }, [](double x) { return std::exp(x); });
+  maxError("expFast", -87.3f, 88.3f, [](const vec8f& x) { return expFast(x); }, [](double x) { return std::exp(x); });
+  maxError("log", 1e-40f, 1e3f, [](const vec8f& x) { return log(x); }, [](double x) { return std::log(x); });
+  maxError("log", 0.5f, 2.f, [](const vec8f& x) { return log(x); }, [](double x) { return std::log(x); });
+  maxError("logFast", 1e-30f, 1e3f, [](const vec8f& x) { return logFast(x); }, [](double x) { return std::log(x); });
+  maxError("sin", -3.14159f, 3.14159f, [](const vec8f& x) { return sin(x); }, [](double x) { return std::sin(x); });
+  maxError("cos", -3.14159f, 3.14159f, [](const vec8f& x) { return cos(x); }, [](double x) { return std::cos(x); });
+  maxError("sin", -8192.f, 8192.f, [](const vec8f& x) { return sin(x); }, [](double x) { return std::sin(x); });
+  maxError("sinFast", -8192.f, 8192.f, [](const vec8f& x) { return sinFast(x); }, [](double x) { return std::sin(x); });
+  maxError("cos", -8192.f, 8192.f, [](const vec8f& x) { return cos(x); }, [](double x) { return std::cos(x); });
+  maxError("cosFast", -8192.f, 8192.f, [](const vec8f& x) { return cosFast(x); }, [](double x) { return std::cos(x); });
+  maxError("tanh", -10.f, 10.f, [](const vec8f& x) { return tanh(x); }, [](double x) { return std::tanh(x); });
+  maxError("tanhFast", -10.f, 10.f, [](const vec8f& x) { return tanhFast(x); }, [](double x) { return std::tanh(x); });
+  maxError("pow 3.5", 1e-3f, 1e3f, [](const vec8f& x) { return pow(x, vec8f{3.5f}); }, pow3);
+  maxError("powFast 3.5", 1e-3f, 1e3f, [](const vec8f& x) { return powFast(x, vec8f{3.5f}); }, pow3);
+
+  const auto inf = std::numeric_limits<float>::infinity();
+  const auto nan = std::numeric_limits<float>::quiet_NaN();
+  const vec8f special{nan, inf, -inf, 0.f, -0.f, 1e-45f, -1.f, 1.f};
+  R(special);
+  R(exp(special));
+  R(log(special));
+  R(sin(special));
+  R(cos(special));
+  R(tanh(special));
+  R(pow(special, vec8f{3.f}));
+  R(pow(vec8f{-2.f}, vec8f{0.f, 1.f, 2.f, 3.f, 0.5f, -1.f, -2.f, nan}));
+}
+
+
+extern "C" {
+// glibc libmvec, AVX2 variants
+__m256 _ZGVdN8v_expf(__m256);
+__m256 _ZGVdN8v_logf(__m256);
+__m256 _ZGVdN8v_sinf(__m256);
+__m256 _ZGVdN8v_cosf(__m256);
+__m256 _ZGVdN8v_tanhf(__m256);
+__m256 _ZGVdN8vv_powf(__m256, __m256);
+}
+
+namespace {
+// ms for 400M evaluations over an L1-resident array
+template <typename Fn>
+long long throughput(Fn fn) {
+  using clock = std::chrono::high_resolution_clock;
+
+  std::vector<float> xs(4'096u);
+  std::iota(begin(xs), end(xs), 1.f);
+  for (auto& x : xs)
+    x = x / 4'096.f;
+
+  avx::vec8f acc{0.f};
+  const auto t0 = clock::now();
+  for (auto n = 0u; n < 100'000u; ++n)
+    for (std::size_t i{0}; i < xs.size(); i += 8)
+      acc += fn(avx::vec8f(&xs[i], &xs[i + 8]));
+  const auto t1 = clock::now();
+
+  // keep acc alive
+  if (acc[0] == 42.f)
+    R(acc);
+
+  return std::chrono::duration_cast<std::chrono::milliseconds>(t1 - t0).count();
+}
+}
+
+
+void mathPerf() {
+  using avx::vec8f;
+  const vec8f y{2.5f};
+
+  R("exp " << throughput([](const vec8f& x) { return exp(x); }) << " fast "
+           << throughput([](const vec8f& x) { return expFast(x); }) << " libmvec "
+           << throughput([](const vec8f& x) { return vec8f{_ZGVdN8v_expf(x.ymm)}; }));
+  R("log " << throughput([](const vec8f& x) { return log(x); }) << " fast "
+           << throughput([](const vec8f& x) { return logFast(x); }) << " libmvec "
+           << throughput([](const vec8f& x) { return vec8f{_ZGVdN8v_logf(x.ymm)}; }));
+  R("sin " << throughput([](const vec8f& x) { return sin(x); }) << " fast "
+           << throughput([](const vec8f& x) { return sinFast(x); }) << " libmvec "
+           << throughput([](const vec8f& x) { return vec8f{_ZGVdN8v_sinf(x.ymm)}; }));
+  R("cos " << throughput([](const vec8f& x) { return cos(x); }) << " fast "
+           << throughput([](const vec8f& x) { return cosFast(x); }) << " libmvec "
+           << throughput([](const vec8f& x) { return vec8f{_ZGVdN8v_cosf(x.ymm)}; }));
+  R("tanh " << throughput([](const vec8f& x) { return tanh(x); }) << " fast "
+            << throughput([](const vec8f& x) { return tanhFast(x); }) << " libmvec "
+            << throughput([](const vec8f& x) { return vec8f{_ZGVdN8v_tanhf(x.ymm)}; }));
+  R("pow " << throughput([&](const vec8f& x) { return pow(x, y); }) << " fast "
+           << throughput([&](const vec8f& x) { return powFast(x, y); }) << " libmvec "
+           << throughput([&](const vec8f& x) { return vec8f{_ZGVdN8vv_powf(x.ymm, y.ymm)}; }));
+}
+
+
+void reduceTest() {
+  std::vector<float> xs(1'000'003u);
+  std::iota(begin(xs), end(xs), 0.f);
+  xs[123'457] = -1.f;
+  xs[765'433] = 2e6f;
+  xs[765'437] = 2e6f;
+
+  R(avx::sum(&xs.front(), &xs.back() + 1) << ' ' << std::accumulate(begin(xs), end(xs), 0.));
+  R(avx::sumKahan(&xs.front(), &xs.back() + 1) << ' ' << avx::sumPairwise(&xs.front(), &xs.back() + 1));
+  R(avx::minimum(&xs.front(), &xs.back() + 1) << ' ' << avx::maximum(&xs.front(), &xs.back() + 1));
+  R(avx::argMin(&xs.front(), &xs.back() + 1) << ' ' << avx::argMax(&xs.front(), &xs.back() + 1));
+  R(avx::dot(&xs.front(), &xs.front() + 11, &xs.front()));
+
+  std::vector<std::int32_t> ints{5, 3, 9, -2, 7, 9, 0, -2, 1, 4, 2};
+  R(avx::sum(&ints.front(), &ints.back() + 1) << ' ' << avx::minimum(&ints.front(), &ints.back() + 1) << ' '
+                                               << avx::maximum(&ints.front(), &ints.back() + 1));
+  R(avx::argMin(&ints.front(), &ints.back() + 1) << ' ' << avx::argMax(&ints.front(), &ints.back() + 1));
+  R(avx::hSum(avx::vec8i{1, 2, 3, 4, 5, 6, 7, 8}) << ' ' << avx::hMax(avx::vec8f{1, 9, 3, 4, 5, 6, 7, 8}));
+}
+
+
+// one accumulator is latency bound, several are throughput bound; ms for sums over an L1-resident array
+void reducePerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  std::vector<float> xs(4'096u, 1.f);
+  const auto repeat = 200'000u;
+  float acc{0};
+
+  const auto time = [&](const char* name, float (*fn)(const float*, const float*)) {
+    const auto t0 = clock::now();
+    for (auto n = 0u; n < repeat; ++n)
+      acc += fn(&xs.front(), &xs.back() + 1);
+    const auto t1 = clock::now();
+    R(name << ' ' << std::chrono::duration_cast<ms>(t1 - t0).count());
+  };
+
+  time("scalar", [](const float* first, const float* last) { return std::accumulate(first, last, 0.f); });
+  time("sum<1>", avx::sum<1, float>);
+  time("sum<2>", avx::sum<2, float>);
+  time("sum<4>", avx::sum<4, float>);
+  time("sum<8>", avx::sum<8, float>);
+  time("sumKahan<4>", avx::sumKahan<4>);
+  time("sumPairwise<4>", avx::sumPairwise<4>);
+  time("minimum<4>", avx::minimum<4, float>);
+  time("argMin<1>", [](const float* first, const float* last) { return static_cast<float>(avx::argMin<1>(first, last)); });
+  time("argMin<4>", [](const float* first, const float* last) { return static_cast<float>(avx::argMin<4>(first, last)); });
+
+  R(acc);
+}
+
+
+void memoryTest() {
+  avx::AlignedVector<float> xs(1'000'003u);
+  std::iota(begin(xs), end(xs), 0.f);
+  R(reinterpret_cast<std::uintptr_t>(xs.data()) % 32u);
+
+  avx::transform(avx::span(xs), avx::span(xs), [](const avx::vec8f& x) { return x * avx::vec8f{2.f}; });
+  R(xs[1] << ' ' << xs.back());
+
+  avx::Arena arena{1u << 21, true};
+  auto ints = arena.allocate<std::int32_t>(11u);
+  auto doubled = arena.allocate<std::int32_t, 64u>(11u);
+  std::iota(ints.begin(), ints.end(), 1);
+
+  // weaker alignments convert implicitly from stronger ones, not the other way around
+  avx::transform(ints, avx::AlignedSpan<std::int32_t>{doubled}, [](const avx::vec8i& x) { return x + x; });
+  R(doubled[0] << ' ' << doubled[10] << ' ' << arena.used() << ' ' << arena.hugePages());
+
+  arena.reset();
+  R(arena.used());
+}
+
+
+// unaligned pointers vs aligned spans vs aligned spans with streaming stores; ms for out = a + b, L1 and DRAM sized
+void memoryPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  const auto run = [](std::size_t n, std::size_t repeat) {
+    avx::AlignedVector<float> a(n, 1.f), b(n, 2.f), out(n);
+    const auto add = [](const avx::vec8f& x, const avx::vec8f& y) { return x + y; };
+
+    const auto time = [&](const char* name, auto fn) {
+      const auto t0 = clock::now();
+      for (auto i = 0u; i < repeat; ++i)
+        fn();
+      const auto t1 = clock::now();
+      R(name << ' ' << n << ' ' << std::chrono::duration_cast<ms>(t1 - t0).count() << ' ' << out[n / 2]);
+    };
+
+    time("pointers", [&] { avx::transform(a.data(), a.data() + n, b.data(), out.data(), add); });
+    time("aligned", [&] { avx::transform(avx::span(a), avx::span(b), avx::span(out), add); });
+    time("stream", [&] { avx::transform<true>(avx::span(a), avx::span(b), avx::span(out), add); });
+  };
+
+  run(1'024u, 1'000'000u);
+  run(64u * 1'024u * 1'024u, 10u);
+}
+
+
+void exprTest() {
+  std::vector<float> a{1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11};
+  std::vector<float> b(a.size(), 2.f);
+  std::vector<float> c(a.size(), 0.5f);
+  std::vector<float> z(a.size());
+
+  auto x = avx::view(a), y = avx::view(b), w = avx::view(c);
+  auto out = avx::view(z);
+
+  out = x * y + ceil(w);
+  R(z[0] << ' ' << z[10]);
+
+  out = blend(x, -x, x > 5.f) - 1.f;
+  R(z[0] << ' ' << z[10]);
+
+  out += 2.f * out;
+  out = min(max(out, -30.f), 10.f);
+  R(z[0] << ' ' << z[5] << ' ' << z[10]);
+
+  // a * b - c is fused, rounding once: the product's rounding error, which is zero if the product is rounded first
+  std::vector<float> v(avx::vec8f::Size, 1.f + std::numeric_limits<float>::epsilon());
+  std::vector<float> product(v.size()), error(v.size());
+  avx::view(product) = avx::view(v) * avx::view(v);
+  avx::view(error) = avx::view(v) * avx::view(v) - avx::view(product);
+  R(error[0]);
+}
+
+
+// z = a * b + ceil(c): hand-written loop vs one transform per operation (temporaries) vs expression; ms
+void exprPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  const auto n = 16u * 1'024u * 1'024u;
+  const auto repeat = 20u;
+
+  avx::AlignedVector<float> a(n, 1.5f), b(n, 2.f), c(n, 0.5f), z(n), t(n), u(n);
+
+  const auto time = [&](const char* name, auto fn) {
+    const auto t0 = clock::now();
+    for (auto i = 0u; i < repeat; ++i)
+      fn();
+    const auto t1 = clock::now();
+    R(name << ' ' << std::chrono::duration_cast<ms>(t1 - t0).count() << ' ' << z[n / 2]);
+  };
+
+  time("loop", [&] {
+    for (std::size_t i = 0; i < n; i += avx::vec8f::Size) {
+      const avx::vec8f x(&a[i], &a[i] + 8), y(&b[i], &b[i] + 8), w(&c[i], &c[i] + 8);
+      fusedMulAdd(x, y, ceil(w)).store(&z[i], &z[i] + 8);
+    }
+  });
+
+  time("temporaries", [&] {
+    avx::transform(a.data(), a.data() + n, b.data(), t.data(), [](const avx::vec8f& x, const avx::vec8f& y) { return x * y; });
+    avx::transform(c.data(), c.data() + n, u.data(), [](const avx::vec8f& x) { return ceil(x); });
+    avx::transform(t.data(), t.data() + n, u.data(), z.data(), [](const avx::vec8f& x, const avx::vec8f& y) { return x + y; });
+  });
+
+  time("expression", [&] { avx::view(z) = avx::view(a) * avx::view(b) + ceil(avx::view(c)); });
+}
+
+
+void parallelTest() {
+  R(avx::parallel::concurrency());
+
+  avx::Arena arena{64u << 20};
+  auto xs = arena.allocate<float>(10'000'003u);
+
+  // pages land on the node of the worker that later gets the same chunks
+  avx::parallel::iota(xs.begin(), xs.end(), 0.f);
+  R(xs[0] << ' ' << xs[1'000'000] << ' ' << xs[xs.size() - 1]);
+
+  avx::parallel::transform(xs.begin(), xs.end(), xs.begin(), [](const avx::vec8f& x) { return x * avx::vec8f{0.5f}; });
+  R(xs[1'000'000] << ' ' << avx::parallel::sum(xs.begin(), xs.begin() + 4'096));
+
+  // uneven work: later chunks are more expensive, idle workers steal them
+  std::vector<std::int32_t> ints(1'000'000u, 1);
+  const auto rv = avx::parallel::reduce(ints.data(), ints.size(), std::int64_t{0}, [&](std::size_t i, std::size_t j) {
+    std::int64_t acc{0};
+    for (; i < j; ++i)
+      for (std::size_t k = 0; k < i / 100'000u; ++k)
+        acc += ints[i];
+    return acc;
+  }, [](std::int64_t lhs, std::int64_t rhs) { return lhs + rhs; });
+  R(rv);
+}
+
+
+// memory bound passes over 1 GiB on one core vs all cores; ms
+void parallelPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  const auto n = 256u * 1'024u * 1'024u;
+  avx::Arena arena{2u * n * sizeof(float), true};
+  auto xs = arena.allocate<float>(n);
+  auto ys = arena.allocate<float>(n);
+
+  avx::parallel::fill(xs.begin(), xs.end(), 1.f);
+  avx::parallel::firstTouch(ys.begin(), ys.end());
+
+  const auto twice = [](const avx::vec8f& x) { return x + x; };
+
+  const auto time = [&](const char* name, auto fn) {
+    const auto t0 = clock::now();
+    const auto rv = fn();
+    const auto t1 = clock::now();
+    R(name << ' ' << std::chrono::duration_cast<ms>(t1 - t0).count() << ' ' << rv);
+  };
+
+  time("transform", [&] { avx::transform(xs.begin(), xs.end(), ys.begin(), twice); return ys[n / 2]; });
+  time("parallel::transform", [&] { avx::parallel::transform(xs.begin(), xs.end(), ys.begin(), twice); return ys[n / 2]; });
+  time("sum", [&] { return avx::sum(ys.begin(), ys.end()); });
+  time("parallel::sum", [&] { return avx::parallel::sum(ys.begin(), ys.end()); });
+}
+
+
+void divideTest() {
+  const avx::vec8i x{0, 1, -1, 7, -7, 100, std::numeric_limits<std::int32_t>::max(), std::numeric_limits<std::int32_t>::min()};
+  R(x * x);
+  R(avx::mulHi(x, x));
+
+  const avx::Divisor<std::int32_t> seven{7};
+  R(x / seven);
+  R(x % seven);
+
+  const avx::Divisor<std::uint32_t> buckets{1'000u};
+  R(x % buckets);
+
+  // all divisors in [-2^16, 2^16] and [1, 2^17], powers of two and their neighbours up to the type's limits, against
+  // the scalar operators on edge and random dividends; int32 min / -1 overflows and is left out
+  using limits = std::numeric_limits<std::int32_t>;
+  std::mt19937 gen{0};
+  avx::vec8i dividends[4] = {x, {2, -2, 3, -3, 65'535, -65'536, limits::max() - 1, limits::min() + 1}};
+  for (auto i = 2; i < 4; ++i)
+    for (std::size_t j{0}; j < 8; ++j)
+      dividends[i][j] = static_cast<std::int32_t>(gen());
+
+  std::vector<std::int64_t> signedDivisors, unsignedDivisors;
+  for (std::int64_t d{-65'536}; d <= 65'536; ++d)
+    signedDivisors.push_back(d);
+  for (std::int64_t d{1}; d <= 131'072; ++d)
+    unsignedDivisors.push_back(d);
+  for (int k = 17; k < 32; ++k)
+    for (const std::int64_t d : {-1, 0, 1}) {
+      signedDivisors.push_back((std::int64_t{1} << k) + d);
+      signedDivisors.push_back(-(std::int64_t{1} << k) + d);
+      unsignedDivisors.push_back((std::int64_t{1} << k) + d);
+      unsignedDivisors.push_back((std::int64_t{1} << (k + 1)) + d);
+    }
+
+  bool same{true};
+  std::size_t checked{0};
+
+  for (const auto wide : signedDivisors) {
+    if (wide == 0 || wide < limits::min() || wide > limits::max())
+      continue;
+
+    const auto d = static_cast<std::int32_t>(wide);
+    const avx::Divisor<std::int32_t> divisor{d};
+
+    for (const auto& each : dividends) {
+      const auto q = each / divisor, r = each % divisor;
+      for (std::size_t i{0}; i < 8; ++i) {
+        if (each[i] == limits::min() && d == -1)
+          continue;
+        same &= q[i] == each[i] / d && r[i] == each[i] % d;
+      }
+    }
+    ++checked;
+  }
+
+  for (const auto wide : unsignedDivisors) {
+    if (wide > std::numeric_limits<std::uint32_t>::max())
+      continue;
+
+    const auto d = static_cast<std::uint32_t>(wide);
+    const avx::Divisor<std::uint32_t> divisor{d};
+
+    for (const auto& each : dividends) {
+      const auto q = each / divisor, r = each % divisor;
+      for (std::size_t i{0}; i < 8; ++i) {
+        const auto n = static_cast<std::uint32_t>(each[i]);
+        same &= static_cast<std::uint32_t>(q[i]) == n / d && static_cast<std::uint32_t>(r[i]) == n % d;
+      }
+    }
+    ++checked;
+  }
+
+  R("same " << same << ' ' << checked << " divisors");
+}
+
+
+// bucket = hash % buckets for a runtime bucket count; ms
+void dividePerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  std::vector<std::int32_t> hashes(16u * 1'024u * 1'024u);
+  std::mt19937 gen{0};
+  std::generate(begin(hashes), end(hashes), [&] { return static_cast<std::int32_t>(gen()); });
+  std::vector<std::int32_t> out(hashes.size());
+
+  volatile std::uint32_t runtime = 1'021u;
+  const std::uint32_t buckets = runtime;
+
+  const auto t0 = clock::now();
+  for (std::size_t i{0}; i < hashes.size(); ++i)
+    out[i] = static_cast<std::int32_t>(static_cast<std::uint32_t>(hashes[i]) % buckets);
+  const auto t1 = clock::now();
+  R("scalar " << std::chrono::duration_cast<ms>(t1 - t0).count() << ' ' << out[12345]);
+
+  const avx::Divisor<std::uint32_t> divisor{buckets};
+  avx::transform(hashes.data(), hashes.data() + hashes.size(), out.data(), [&](const avx::vec8i& x) { return x % divisor; });
+  const auto t2 = clock::now();
+  R("Divisor " << std::chrono::duration_cast<ms>(t2 - t1).count() << ' ' << out[12345]);
+}
+
+
+void laneTest() {
+  const avx::vec4d d{0.5, -1.5, 2.5, 1e300};
+  R(d * d);
+  R(avx::narrow(d, d));
+  R(avx::convert(d, d));
+
+  const avx::vec4q q{-3, 5, std::numeric_limits<std::int64_t>::max(), 1ll << 40};
+  R(q * avx::vec4q{3});
+  R(avx::shiftRightSignExtend<1>(q));
+  R(avx::max(q, avx::vec4q{0}));
+
+  const avx::vec16s s{30'000};
+  R(s + s);
+  R(avx::addSaturate(s, s));
+  R(avx::mulFixedPoint(s, avx::vec16s{16'384}));
+  R(avx::narrow(avx::widenLow(s) * avx::vec8i{2}, avx::widenHigh(s)));
+
+  const avx::vec32b b{-100};
+  R(avx::subSaturate(b, avx::vec32b{100}));
+  R(avx::addSaturateUnsigned(b, b));
+  R(avx::widenLowUnsigned(b));
+  R(avx::hSum(b) << ' ' << avx::hSumUnsigned(b));
+}
+
+
+namespace {
+
+// two 16 bit audio streams mixed with Q15 gains, clamped to the sample range
+void mixScalar(const std::int16_t* x, const std::int16_t* y, std::int16_t* out, std::size_t n, std::int16_t gainX,
+               std::int16_t gainY) {
+  for (std::size_t i{0}; i < n; ++i) {
+    const auto scaledX = (x[i] * gainX + (1 << 14)) >> 15;
+    const auto scaledY = (y[i] * gainY + (1 << 14)) >> 15;
+    const auto mixed = std::min(std::max(scaledX + scaledY, -32768), 32767);
+    out[i] = static_cast<std::int16_t>(mixed);
+  }
+}
+
+void mixVec(const std::int16_t* x, const std::int16_t* y, std::int16_t* out, std::size_t n, std::int16_t gainX,
+            std::int16_t gainY) {
+  const avx::vec16s gx{gainX}, gy{gainY};
+  const auto Size = avx::vec16s::Size;
+
+  std::size_t i{0};
+  for (; i + Size <= n; i += Size) {
+    const avx::vec16s vx{x + i, x + i + Size}, vy{y + i, y + i + Size};
+    auto mixed = avx::addSaturate(avx::mulFixedPoint(vx, gx), avx::mulFixedPoint(vy, gy));
+    mixed.store(out + i, out + i + Size);
+  }
+
+  mixScalar(x + i, y + i, out + i, n - i, gainX, gainY);
+}
+}
+
+// mixing two int16 streams: vec16s with saturating adds against a scalar clamping loop; ms
+void lanePerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  // a block of samples that stays in L2, as when mixing in a streaming audio callback
+  const std::size_t n = 32u * 1'024u;
+  std::vector<std::int16_t> x(n), y(n), scalar(n), vec(n);
+
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<std::int16_t> samples;
+  std::generate(begin(x), end(x), [&] { return samples(gen); });
+  std::generate(begin(y), end(y), [&] { return samples(gen); });
+
+  const std::int16_t gainX = 29'491, gainY = 19'661; // 0.9 and 0.6
+
+  const auto t0 = clock::now();
+  for (int pass = 0; pass < 10'000; ++pass)
+    mixScalar(x.data(), y.data(), scalar.data(), n, gainX, gainY);
+  const auto t1 = clock::now();
+  for (int pass = 0; pass < 10'000; ++pass)
+    mixVec(x.data(), y.data(), vec.data(), n, gainX, gainY);
+  const auto t2 = clock::now();
+
+  R("scalar " << std::chrono::duration_cast<ms>(t1 - t0).count());
+  R("vec16s " << std::chrono::duration_cast<ms>(t2 - t1).count());
+  R("equal " << std::equal(begin(scalar), end(scalar), begin(vec)));
+}
+
+
+void sortTest() {
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<std::int32_t> few{-50, 50};
+
+  // network sizes and their neighbours, partition remainders, many duplicates
+  bool sorted{true}, argSorted{true}, merged{true};
+
+  for (std::size_t n : {0u, 1u, 7u, 8u, 9u, 16u, 17u, 33u, 64u, 65u, 100u, 1'000u, 12'345u, 100'000u}) {
+    std::vector<std::int32_t> ints(n);
+    std::generate(begin(ints), end(ints), [&] { return few(gen); });
+    std::vector<float> floats(n);
+    std::generate(begin(floats), end(floats), [&] { return static_cast<float>(few(gen)) * 0.25f; });
+
+    auto expected = ints;
+    std::sort(begin(expected), end(expected));
+    avx::sort(ints.data(), ints.data() + n);
+    sorted &= ints == expected;
+
+    const auto indices = avx::argSort(floats.data(), floats.data() + n);
+    std::vector<std::int32_t> iota(n);
+    std::iota(begin(iota), end(iota), 0);
+    argSorted &= std::is_permutation(begin(indices), end(indices), begin(iota));
+
+    auto fs = floats;
+    std::sort(begin(fs), end(fs));
+    for (std::size_t i{0}; i < n; ++i)
+      argSorted &= floats[indices[i]] == fs[i];
+
+    std::vector<std::int32_t> all(n + expected.size() / 3);
+    const auto third = std::vector<std::int32_t>(begin(expected), begin(expected) + n / 3);
+    auto reference = all;
+    std::merge(begin(expected), end(expected), begin(third), end(third), begin(reference));
+    avx::merge(expected.data(), expected.data() + n, third.data(), third.data() + third.size(), all.data());
+    merged &= all == reference;
+  }
+
+  // -0.f and 0.f compare equal: sorted they are in either order, but every sign has to survive
+  bool zeros{true};
+
+  for (std::size_t n : {8u, 16u, 58u, 64u, 1'000u}) {
+    std::vector<float> signs(n);
+    std::generate(begin(signs), end(signs), [&] { return gen() % 2 == 0 ? -0.f : 0.f; });
+    signs[n / 2] = 1.f;
+
+    const auto negative = [](const std::vector<float>& xs) {
+      return std::count_if(begin(xs), end(xs), [](float x) { return std::signbit(x); });
+    };
+
+    const auto before = negative(signs);
+    avx::sort(signs.data(), signs.data() + n);
+    zeros &= negative(signs) == before && std::is_sorted(begin(signs), end(signs)) && signs[n - 1] == 1.f;
+
+    auto both = signs;
+    std::shuffle(begin(both), end(both), gen);
+    std::vector<float> all(2 * n);
+    std::sort(begin(both), end(both));
+    avx::merge(signs.data(), signs.data() + n, both.data(), both.data() + n, all.data());
+    zeros &= negative(all) == 2 * before;
+  }
+
+  std::vector<std::int32_t> extremes{std::numeric_limits<std::int32_t>::max(), 3, std::numeric_limits<std::int32_t>::min(),
+                                     std::numeric_limits<std::int32_t>::max(), -1};
+  std::vector<std::int32_t> values{0, 1, 2, 3, 4};
+  avx::sort(extremes.data(), extremes.data() + extremes.size(), values.data());
+
+  R("sorted " << sorted << " argSorted " << argSorted << " merged " << merged << " zeros " << zeros);
+  R(extremes[0] << ' ' << extremes[4] << ' ' << values[0] << ' ' << values[1] << ' ' << values[2] << ' ' << values[3] + values[4]);
+}
+
+
+// one million random keys: std::sort against avx::sort; ms
+void sortPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  const std::size_t n = 1'000'000u;
+  std::mt19937 gen{0};
+
+  std::vector<std::int32_t> ints(n);
+  std::generate(begin(ints), end(ints), [&] { return static_cast<std::int32_t>(gen()); });
+  std::vector<float> floats(n);
+  std::uniform_real_distribution<float> uniform{-1.f, 1.f};
+  std::generate(begin(floats), end(floats), [&] { return uniform(gen); });
+
+  const auto time = [&](const char* name, auto fn) {
+    const auto t0 = clock::now();
+    fn();
+    const auto t1 = clock::now();
+    R(name << ' ' << std::chrono::duration_cast<ms>(t1 - t0).count());
+  };
+
+  auto a = ints, b = ints;
+  time("std::sort int32", [&] { std::sort(begin(a), end(a)); });
+  time("avx::sort int32", [&] { avx::sort(b.data(), b.data() + n); });
+  R("equal " << (a == b));
+
+  auto c = floats, d = floats;
+  time("std::sort float", [&] { std::sort(begin(c), end(c)); });
+  time("avx::sort float", [&] { avx::sort(d.data(), d.data() + n); });
+  R("equal " << (c == d));
+
+  std::vector<std::int32_t> indices(n);
+  time("std::sort argsort", [&] {
+    std::iota(begin(indices), end(indices), 0);
+    std::sort(begin(indices), end(indices), [&](std::int32_t i, std::int32_t j) { return floats[i] < floats[j]; });
+  });
+  time("avx::argSort", [&] { indices = avx::argSort(floats.data(), floats.data() + n); });
+  R("argSorted " << std::is_sorted(begin(indices), end(indices), [&](std::int32_t i, std::int32_t j) { return floats[i] < floats[j]; }));
+}
+
+
+void scanTest() {
+  const std::vector<std::int32_t> ints{3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5};
+  std::vector<std::int32_t> out(ints.size());
+
+  R(avx::inclusiveScan(ints.data(), ints.data() + ints.size(), out.data()));
+  R(avx::vec8i{out.data(), out.data() + 8});
+  R(avx::exclusiveScan(ints.data(), ints.data() + ints.size(), out.data(), 100));
+  R(avx::vec8i{out.data(), out.data() + 8} << ' ' << out[10]);
+
+  const auto odd = [](const avx::vec8i& x) { return (x & avx::vec8i{1}) == avx::vec8i{1}; };
+  const auto last = avx::copyIf(ints.data(), ints.data() + ints.size(), out.data(), odd);
+  R(avx::countIf(ints.data(), ints.data() + ints.size(), odd) << ' ' << last - out.data());
+  R(avx::vec8i{out.data(), out.data() + 8});
+
+  // serial against parallel, both against std
+  std::vector<float> xs(1'000'003u);
+  std::mt19937 gen{0};
+  std::uniform_real_distribution<float> uniform{-1.f, 1.f};
+  std::generate(begin(xs), end(xs), [&] { return uniform(gen); });
+
+  std::vector<std::int32_t> is(xs.size()), scanned(xs.size()), expected(xs.size());
+  std::transform(begin(xs), end(xs), begin(is), [](float x) { return static_cast<std::int32_t>(x * 100.f); });
+  std::partial_sum(begin(is), end(is), begin(expected));
+  avx::parallel::inclusiveScan(is.data(), is.data() + is.size(), scanned.data());
+  R("parallel::inclusiveScan " << (scanned == expected));
+
+  // exclusive from 100: the inclusive sums shifted by one, as std::exclusive_scan in C++17
+  std::vector<std::int32_t> exclusive(is.size());
+  exclusive[0] = 100;
+  std::transform(begin(expected), end(expected) - 1, begin(exclusive) + 1, [](std::int32_t x) { return x + 100; });
+  const auto total = avx::parallel::exclusiveScan(is.data(), is.data() + is.size(), scanned.data(), 100);
+  R("parallel::exclusiveScan " << (scanned == exclusive) << ' ' << (total == expected.back() + 100));
+
+  const auto positive = [](const avx::vec8f& x) { return x > avx::vec8f{0.f}; };
+  std::vector<float> kept, copied(xs.size()), copiedParallel(xs.size());
+  std::copy_if(begin(xs), end(xs), std::back_inserter(kept), [](float x) { return x > 0.f; });
+  copied.resize(avx::copyIf(xs.data(), xs.data() + xs.size(), copied.data(), positive) - copied.data());
+  copiedParallel.resize(avx::parallel::copyIf(xs.data(), xs.data() + xs.size(), copiedParallel.data(), positive) -
+                        copiedParallel.data());
+  R("copyIf " << (copied == kept) << " parallel::copyIf " << (copiedParallel == kept));
+}
+
+
+// prefix sums and compaction over 256 Mi floats, scalar, vec and parallel; ms
+void scanPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  const auto n = 256u * 1'024u * 1'024u;
+  avx::Arena arena{2u * n * sizeof(float), true};
+  auto xs = arena.allocate<float>(n);
+  auto ys = arena.allocate<float>(n);
+
+  avx::parallel::fill(xs.begin(), xs.end(), 1.f);
+  avx::parallel::firstTouch(ys.begin(), ys.end());
+  xs[n / 3] = -1.f;
+
+  const auto positive = [](const avx::vec8f& x) { return x > avx::vec8f{0.f}; };
+
+  const auto time = [&](const char* name, auto fn) {
+    const auto t0 = clock::now();
+    const auto rv = fn();
+    const auto t1 = clock::now();
+    R(name << ' ' << std::chrono::duration_cast<ms>(t1 - t0).count() << ' ' << rv);
+  };
+
+  time("std::partial_sum", [&] { std::partial_sum(xs.begin(), xs.end(), ys.begin()); return ys[n - 1]; });
+  time("inclusiveScan", [&] { return avx::inclusiveScan(xs.begin(), xs.end(), ys.begin()); });
+  time("parallel::inclusiveScan", [&] { return avx::parallel::inclusiveScan(xs.begin(), xs.end(), ys.begin()); });
+  time("std::copy_if", [&] { return std::copy_if(xs.begin(), xs.end(), ys.begin(), [](float x) { return x > 0.f; }) - ys.begin(); });
+  time("copyIf", [&] { return avx::copyIf(xs.begin(), xs.end(), ys.begin(), positive) - ys.begin(); });
+  time("parallel::copyIf", [&] { return avx::parallel::copyIf(xs.begin(), xs.end(), ys.begin(), positive) - ys.begin(); });
+}
+
+
+namespace {
+
+// rows of a few numeric and text fields, every seventh text field quoted with a separator, a doubled quote and a
+// newline in it; about the shape of a log or order export
+std::string makeCsv(std::size_t rows) {
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<int> number{0, 1'000'000};
+  std::string rv;
+
+  for (std::size_t row{0}; row < rows; ++row) {
+    rv += std::to_string(row) + ',' + std::to_string(number(gen)) + ",";
+    rv += row % 7 == 0 ? "\"Smith, \"\"Jr\"\"\nsecond line\"" : "some plain text field";
+    rv += "," + std::to_string(number(gen) / 100.) + ",2024-01-01T00:00:00Z\n";
+  }
+
+  return rv;
+}
+
+// field ends and row ends the straightforward way, a byte at a time
+std::pair<std::size_t, std::size_t> csvScalar(const char* first, const char* last) {
+  std::size_t fields{0}, rows{0};
+  bool quoted{false};
+
+  for (; first != last; ++first) {
+    if (*first == '"')
+      quoted = !quoted;
+    else if (!quoted && *first == ',')
+      ++fields;
+    else if (!quoted && *first == '\n')
+      ++fields, ++rows;
+  }
+
+  return {fields, rows};
+}
+
+std::pair<std::size_t, std::size_t> csvVec(const char* first, const char* last) {
+  std::size_t fields{0}, rows{0};
+  avx::forEachCsvDelimiter(first, last, [&](std::size_t, bool newline) { ++fields, rows += newline; });
+  return {fields, rows};
+}
+}
+
+void searchTest() {
+  const std::string text = "the quick brown fox jumps over the lazy dog, then naps; the end\n";
+  const auto* first = text.data();
+  const auto* last = first + text.size();
+
+  R(avx::find(first, last, 'z') - first << ' ' << avx::find(first, last, '#') - first);
+  R(avx::findAny(first, last, avx::needles(',', ';', '\n')) - first << ' ' << avx::length(first + 3));
+
+  const std::string needle = "the end";
+  R(avx::find(first, last, needle.data(), needle.data() + needle.size()) - first << ' ' << text.find(needle));
+
+  std::size_t matches{0};
+  avx::forEachMatch(first, last, avx::needles(' '), [&](std::size_t) { ++matches; });
+  R(matches << ' ' << std::count(begin(text), end(text), ' '));
+
+  // every offset and length against the std equivalents
+  std::string bytes(1'000u, 'a');
+  bool found{true};
+  for (std::size_t i{0}; i < bytes.size(); i += 37) {
+    bytes[i] = 'x';
+    for (std::size_t from{0}; from < 70; ++from) {
+      const auto* expected = std::find(bytes.data() + from, bytes.data() + bytes.size(), 'x');
+      found &= avx::find(bytes.data() + from, bytes.data() + bytes.size(), 'x') == expected;
+      found &= avx::length(bytes.data() + from) == std::strlen(bytes.data() + from);
+      found &= avx::find(bytes.data() + from, bytes.data() + bytes.size(), "ax", "ax" + 2) ==
+               std::search(bytes.data() + from, bytes.data() + bytes.size(), "ax", "ax" + 2);
+    }
+    bytes[i] = 'a';
+  }
+  R("found " << found);
+
+  const auto csv = makeCsv(1'000u);
+  for (std::size_t n : {csv.size(), std::size_t{4'097}, std::size_t{63}})
+    R(csvScalar(csv.data(), csv.data() + n).first << ' ' << csvScalar(csv.data(), csv.data() + n).second << ' '
+      << csvVec(csv.data(), csv.data() + n).first << ' ' << csvVec(csv.data(), csv.data() + n).second);
+}
+
+
+// newline search and csv field ends over an L3-sized buffer against memchr and a byte-wise loop; GB/s
+void searchPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ns = std::chrono::nanoseconds;
+
+  const auto csv = makeCsv(200'000u);
+  const auto* first = csv.data();
+  const auto* last = first + csv.size();
+  const auto repeat = 20u;
+
+  const auto time = [&](const char* name, auto fn) {
+    std::size_t rv{0};
+    const auto t0 = clock::now();
+    for (auto n = 0u; n < repeat; ++n)
+      rv += fn();
+    const auto t1 = clock::now();
+    R(name << ' ' << static_cast<double>(repeat * csv.size()) / std::chrono::duration_cast<ns>(t1 - t0).count() << ' '
+           << rv);
+  };
+
+  time("memchr lines", [&] {
+    std::size_t lines{0};
+    for (const auto* it = first; (it = static_cast<const char*>(std::memchr(it, '\n', last - it))) != nullptr; ++it)
+      ++lines;
+    return lines;
+  });
+  time("find lines", [&] {
+    std::size_t lines{0};
+    for (const auto* it = first; (it = avx::find(it, last, '\n')) != last; ++it)
+      ++lines;
+    return lines;
+  });
+  time("forEachMatch lines", [&] {
+    std::size_t lines{0};
+    avx::forEachMatch(first, last, avx::needles('\n'), [&](std::size_t) { ++lines; });
+    return lines;
+  });
+  // a byte that is not there: the whole buffer; volatile, memchr is pure and would be hoisted out of the loop
+  volatile char absent = '#';
+  time("memchr whole", [&] { return static_cast<std::size_t>(std::memchr(first, absent, csv.size()) == nullptr); });
+  time("find whole", [&] { return static_cast<std::size_t>(avx::find(first, last, absent) == last); });
+  time("csv scalar", [&] { return csvScalar(first, last).first; });
+  time("csv vec", [&] { return csvVec(first, last).first; });
+}
+
+
+namespace {
+
+// c = a * b the textbook way, i-k-j so that the inner loop runs along rows
+void gemmNaive(std::size_t m, std::size_t n, std::size_t k, const float* a, const float* b, float* c) {
+  std::fill(c, c + m * n, 0.f);
+  for (std::size_t i{0}; i < m; ++i)
+    for (std::size_t p{0}; p < k; ++p)
+      for (std::size_t j{0}; j < n; ++j)
+        c[i * n + j] += a[i * k + p] * b[p * n + j];
+}
+
+std::vector<float> randomMatrix(std::size_t rows, std::size_t cols, std::mt19937& gen) {
+  std::uniform_real_distribution<float> uniform{-1.f, 1.f};
+  std::vector<float> rv(rows * cols);
+  std::generate(begin(rv), end(rv), [&] { return uniform(gen); });
+  return rv;
+}
+
+float maxDifference(const std::vector<float>& x, const std::vector<float>& y) {
+  float rv{0.f};
+  for (std::size_t i{0}; i < x.size(); ++i)
+    rv = std::max(rv, std::abs(x[i] - y[i]));
+  return rv;
+}
+}
+
+void gemmTest() {
+  avx::vec8f rows[8];
+  for (int i = 0; i < 8; ++i)
+    rows[i] = avx::vec8f{static_cast<float>(i * 10)} + avx::vec8f{0, 1, 2, 3, 4, 5, 6, 7};
+  avx::transpose(rows);
+  R(rows[0]);
+  R(rows[7]);
+
+  std::mt19937 gen{0};
+
+  // edges in every dimension, more than one block of k, of a's rows and of b's columns
+  for (const auto& size : {std::vector<std::size_t>{1, 1, 1}, {6, 16, 8}, {7, 17, 3}, {13, 40, 300}, {250, 3100, 70}}) {
+    const auto m = size[0], n = size[1], k = size[2];
+    const auto a = randomMatrix(m, k, gen), b = randomMatrix(k, n, gen);
+    std::vector<float> expected(m * n), c(m * n, 1.f), parallel(m * n, 1.f);
+
+    gemmNaive(m, n, k, a.data(), b.data(), expected.data());
+    avx::gemm(m, n, k, a.data(), k, b.data(), n, c.data(), n);
+    avx::parallel::gemm(m, n, k, a.data(), k, b.data(), n, parallel.data(), n);
+    const auto error = std::max(maxDifference(c, expected), maxDifference(parallel, expected));
+
+    avx::gemm(m, n, k, a.data(), k, b.data(), n, c.data(), n, true);
+    for (auto& each : expected)
+      each *= 2.f;
+
+    std::vector<float> transposed(k * m), back(m * k);
+    avx::transpose(m, k, a.data(), k, transposed.data(), m);
+    avx::transpose(k, m, transposed.data(), m, back.data(), k);
+
+    R(m << 'x' << n << 'x' << k << ' ' << (error < 1e-4f) << ' ' << (maxDifference(c, expected) < 1e-4f) << ' '
+        << (back == a) << ' ' << (transposed[m - 1] == a[(m - 1) * k]));
+  }
+
+  // empty products: c, here a single sentinel past the empty matrix, stays as it is
+  for (const auto& size : {std::vector<std::size_t>{0, 5, 3}, {5, 0, 3}, {0, 0, 0}, {0, 5, 0}}) {
+    const auto m = size[0], n = size[1], k = size[2];
+    const auto a = randomMatrix(m, k, gen), b = randomMatrix(k, n, gen);
+    std::vector<float> c(m * n + 1u, 1.f);
+
+    avx::gemm(m, n, k, a.data(), k, b.data(), n, c.data(), n);
+    avx::parallel::gemm(m, n, k, a.data(), k, b.data(), n, c.data(), n);
+    avx::parallel::gemm(m, n, k, a.data(), k, b.data(), n, c.data(), n, true);
+
+    R(m << 'x' << n << 'x' << k << ' ' << (c == std::vector<float>(m * n + 1u, 1.f)));
+  }
+}
+
+
+// square products in GFLOP/s against the fused multiply add peak of one core, measured with eight independent chains
+void gemmPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ns = std::chrono::nanoseconds;
+
+  const auto peak = [&] {
+    avx::vec8f x0{1.f}, x1{1.f}, x2{1.f}, x3{1.f}, x4{1.f}, x5{1.f}, x6{1.f}, x7{1.f};
+    avx::vec8f x8{1.f}, x9{1.f}, x10{1.f}, x11{1.f}, y{0.999f};
+    const auto iterations = 100'000'000u;
+
+    const auto t0 = clock::now();
+    for (auto i = 0u; i < iterations; ++i) {
+      x0 = avx::fusedMulAdd(x0, y, y), x1 = avx::fusedMulAdd(x1, y, y), x2 = avx::fusedMulAdd(x2, y, y);
+      x3 = avx::fusedMulAdd(x3, y, y), x4 = avx::fusedMulAdd(x4, y, y), x5 = avx::fusedMulAdd(x5, y, y);
+      x6 = avx::fusedMulAdd(x6, y, y), x7 = avx::fusedMulAdd(x7, y, y), x8 = avx::fusedMulAdd(x8, y, y);
+      x9 = avx::fusedMulAdd(x9, y, y), x10 = avx::fusedMulAdd(x10, y, y), x11 = avx::fusedMulAdd(x11, y, y);
+    }
+    const auto t1 = clock::now();
+
+    const auto sum = x0 + x1 + x2 + x3 + x4 + x5 + x6 + x7 + x8 + x9 + x10 + x11;
+    R("peak " << 12. * 16. * iterations / std::chrono::duration_cast<ns>(t1 - t0).count() << " GFLOP/s " << sum[0]);
+  };
+  peak();
+
+  std::mt19937 gen{0};
+
+  for (std::size_t n : {64u, 256u, 1'024u}) {
+    const auto a = randomMatrix(n, n, gen), b = randomMatrix(n, n, gen);
+    std::vector<float> c(n * n);
+    const auto flops = 2. * n * n * n;
+    const auto repeat = std::max<std::size_t>(1u, (1u << 30) / (n * n * n));
+
+    const auto time = [&](const char* name, auto fn) {
+      const auto t0 = clock::now();
+      for (std::size_t i{0}; i < repeat; ++i)
+        fn();
+      const auto t1 = clock::now();
+      R(n << ' ' << name << ' ' << flops * repeat / std::chrono::duration_cast<ns>(t1 - t0).count() << " GFLOP/s "
+          << c[n / 2]);
+    };
+
+    time("naive", [&] { gemmNaive(n, n, n, a.data(), b.data(), c.data()); });
+    time("gemm", [&] { avx::gemm(n, n, n, a.data(), n, b.data(), n, c.data(), n); });
+    time("parallel::gemm", [&] { avx::parallel::gemm(n, n, n, a.data(), n, b.data(), n, c.data(), n); });
+  }
+}
+
+
+void halfTest() {
+  const float values[] = {1.f, -2.5f, 65504.f, 1e-8f, 3.14159265f, 70000.f, 1e30f, std::numeric_limits<float>::quiet_NaN()};
+  for (const auto x : values)
+    R(x << ' ' << avx::toFloat(avx::toHalf(x)) << ' ' << avx::toFloat(avx::toBFloat16(x)));
+
+  // vec8f conversions against the scalar ones, on every 16 bit pattern; nans only as nans
+  bool same{true};
+  for (std::uint32_t bits{0}; bits < (1u << 16); bits += 8) {
+    avx::Half halves[8];
+    avx::BFloat16 bfloats[8];
+    for (std::uint16_t i{0}; i < 8; ++i)
+      halves[i] = {static_cast<std::uint16_t>(bits + i)}, bfloats[i] = {static_cast<std::uint16_t>(bits + i)};
+
+    avx::vec8f h, b;
+    h.load(halves, halves + 8);
+    b.load(bfloats, bfloats + 8);
+
+    for (std::size_t i{0}; i < 8; ++i) {
+      const auto expected = avx::toFloat(halves[i]), got = h[i], widened = avx::toFloat(bfloats[i]);
+      same &= expected == got || (std::isnan(expected) && std::isnan(got));
+      same &= std::memcmp(&b[i], &widened, sizeof(float)) == 0;
+    }
+
+    // and back
+    avx::Half halvesBack[8];
+    avx::BFloat16 bfloatsBack[8];
+    (b * avx::vec8f{1.001f}).store(bfloatsBack, bfloatsBack + 8);
+    (h * avx::vec8f{0.999f}).store(halvesBack, halvesBack + 8);
+    for (std::size_t i{0}; i < 8; ++i) {
+      same &= bfloatsBack[i].bits == avx::toBFloat16(b[i] * 1.001f).bits;
+      same &= halvesBack[i].bits == avx::toHalf(h[i] * 0.999f).bits || std::isnan(h[i]);
+    }
+  }
+  R("same " << same);
+
+  std::vector<float> xs(1'003u);
+  std::iota(begin(xs), end(xs), 0.f);
+  avx::HalfVector<avx::Half> halves(xs.size());
+  avx::HalfVector<avx::BFloat16> bfloats(xs.size());
+  avx::convert(xs.data(), xs.data() + xs.size(), halves.data());
+  avx::convert(xs.data(), xs.data() + xs.size(), bfloats.data());
+
+  R(avx::sum(halves.data(), halves.data() + halves.size()) << ' ' << avx::sum(bfloats.data(), bfloats.data() + bfloats.size())
+                                                            << ' ' << std::accumulate(begin(xs), end(xs), 0.));
+
+  avx::transform(halves.data(), halves.data() + halves.size(), xs.data(), [](const avx::vec8f& x) { return x * x; });
+  R(xs[1'002] << ' ' << avx::toFloat(halves[1'002]));
+}
+
+
+// read-heavy scans over 64 Mi elements in DRAM: float against half and bfloat16 storage; ms and GB/s of storage read
+void halfPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ns = std::chrono::nanoseconds;
+
+  const std::size_t n = 64u * 1'024u * 1'024u;
+  avx::AlignedVector<float, 32u> xs(n);
+  std::mt19937 gen{0};
+  std::uniform_real_distribution<float> uniform{0.f, 1.f};
+  std::generate(begin(xs), end(xs), [&] { return uniform(gen); });
+
+  avx::HalfVector<avx::Half> halves(n);
+  avx::HalfVector<avx::BFloat16> bfloats(n);
+  avx::convert(xs.data(), xs.data() + n, halves.data());
+  avx::convert(xs.data(), xs.data() + n, bfloats.data());
+
+  const auto time = [&](const char* name, std::size_t bytes, auto fn) {
+    const auto t0 = clock::now();
+    const auto rv = fn();
+    const auto t1 = clock::now();
+    const auto elapsed = std::chrono::duration_cast<ns>(t1 - t0).count();
+    R(name << ' ' << elapsed / 1'000'000 << " ms " << static_cast<double>(bytes) / elapsed << " GB/s " << rv);
+  };
+
+  for (int pass = 0; pass < 2; ++pass) {
+    time("sum float", n * 4u, [&] { return avx::sum(xs.data(), xs.data() + n); });
+    time("sum half", n * 2u, [&] { return avx::sum(halves.data(), halves.data() + n); });
+    time("sum bfloat16", n * 2u, [&] { return avx::sum(bfloats.data(), bfloats.data() + n); });
+  }
+}
+
+
+void copyTest() {
+  R("last level cache " << avx::cpu::lastLevelCacheBytes() / 1'024u << " KiB");
+
+  // every store kind from every misalignment and for lengths around a few cache lines, against std::copy and std::fill
+  std::vector<float> xs(1'100u);
+  std::iota(begin(xs), end(xs), 0.f);
+  avx::AlignedVector<float, 64u> out(xs.size() + 16u);
+
+  bool same{true};
+  for (const auto stores : {avx::Stores::regular, avx::Stores::streaming, avx::Stores::automatic}) {
+    for (std::size_t offset{0}; offset < 16u; ++offset) {
+      for (const std::size_t n : {0u, 1u, 7u, 16u, 17u, 63u, 64u, 100u, 1'000u, 1'100u}) {
+        std::fill(begin(out), end(out), -1.f);
+        avx::copy(xs.data(), xs.data() + n, out.data() + offset, stores);
+        same &= std::equal(xs.data(), xs.data() + n, out.data() + offset);
+        same &= std::all_of(out.data() + offset + n, out.data() + out.size(), [](float x) { return x == -1.f; });
+
+        avx::fill(out.data() + offset, out.data() + offset + n, 2.f, stores);
+        same &= std::all_of(out.data() + offset, out.data() + offset + n, [](float x) { return x == 2.f; });
+        same &= std::all_of(out.data(), out.data() + offset, [](float x) { return x == -1.f; });
+
+        avx::transform(xs.data(), xs.data() + n, out.data() + offset, [](const avx::vec8f& x) { return x * x; }, stores);
+        for (std::size_t i{0}; i < n; ++i)
+          same &= out[offset + i] == xs[i] * xs[i];
+      }
+    }
+  }
+  R("same " << same);
+}
+
+
+// copies and fills of 256 MiB, far beyond the caches: regular against streaming stores and libc; ms and GB/s moved
+void copyPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ns = std::chrono::nanoseconds;
+
+  const std::size_t n = 64u * 1'024u * 1'024u;
+  avx::AlignedVector<float, 64u> xs(n, 1.f), out(n, 0.f);
+
+  const auto time = [&](const char* name, std::size_t bytes, auto fn) {
+    const auto t0 = clock::now();
+    fn();
+    const auto t1 = clock::now();
+    const auto elapsed = std::chrono::duration_cast<ns>(t1 - t0).count();
+    R(name << ' ' << elapsed / 1'000'000 << " ms " << static_cast<double>(bytes) / elapsed << " GB/s " << out[n - 1]);
+  };
+
+  for (int pass = 0; pass < 2; ++pass) {
+    time("copy regular", n * 8u, [&] { avx::copy(xs.data(), xs.data() + n, out.data(), avx::Stores::regular); });
+    time("copy stream", n * 8u, [&] { avx::copy(xs.data(), xs.data() + n, out.data(), avx::Stores::streaming); });
+    time("copy libc", n * 8u, [&] { std::memcpy(out.data(), xs.data(), n * sizeof(float)); });
+    time("fill regular", n * 4u, [&] { avx::fill(out.data(), out.data() + n, 2.f, avx::Stores::regular); });
+    time("fill stream", n * 4u, [&] { avx::fill(out.data(), out.data() + n, 3.f, avx::Stores::streaming); });
+    time("fill libc", n * 4u, [&] { std::memset(out.data(), 0, n * sizeof(float)); });
+  }
+}
+
+
+void fileTest() {
+  const std::string path = "/tmp/avx-playground-in.bin", outPath = "/tmp/avx-playground-out.bin";
+
+  // not a whole number of pages, chunks of three pages and a bit
+  const std::size_t n = 1'000'003u, chunkBytes = 3u * 4'096u + 5u;
+  std::vector<float> xs(n);
+  std::iota(begin(xs), end(xs), 0.f);
+
+  {
+    avx::MappedFile file{path, n * sizeof(float)};
+    avx::copy(xs.data(), xs.data() + n, file.data<float>());
+  }
+
+  avx::MappedFile in{path};
+  R(in.size() / sizeof(float) << " floats");
+
+  double sum{0};
+  std::size_t chunks{0};
+  avx::forEachChunk<float>(in, [&](const float* first, const float* last) {
+    sum += avx::sum(first, last);
+    ++chunks;
+  }, chunkBytes);
+  R(chunks << " chunks, sum " << sum << ' ' << std::accumulate(begin(xs), end(xs), 0.));
+
+  {
+    avx::MappedFile out{outPath, in.size()};
+    avx::transform<float>(in, out, [](const avx::vec8f& x) { return x * avx::vec8f{2.f} + avx::vec8f{1.f}; },
+                          chunkBytes);
+  }
+
+  avx::MappedFile out{outPath};
+  const auto* ys = out.data<float>();
+  bool same{out.size() == in.size()};
+  for (std::size_t i{0}; same && i < n; ++i)
+    same &= ys[i] == xs[i] * 2.f + 1.f;
+  R("same " << same);
+
+  // the same bytes as int32 columns through vec8i kernels
+  {
+    avx::MappedFile ints{outPath, in.size()};
+    avx::transform<std::int32_t>(in, ints, [](const avx::vec8i& x) { return x + avx::vec8i{1}; }, chunkBytes);
+  }
+
+  avx::MappedFile ints{outPath};
+  const auto* bits = in.data<std::int32_t>();
+  same = true;
+  for (std::size_t i{0}; i < n; ++i)
+    same &= ints.data<std::int32_t>()[i] == bits[i] + 1;
+  R("same " << same);
+
+  std::remove(path.c_str());
+  std::remove(outPath.c_str());
+}
+
+
+// a 1 GiB column file: sum and transform it chunk by chunk against reading it into memory first; ms and GB/s read.
+// Run once with a cold page cache (echo 3 > /proc/sys/vm/drop_caches) for disk bandwidth, the second pass is warm.
+void filePerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ns = std::chrono::nanoseconds;
+
+  const std::string path = "/tmp/avx-playground-in.bin", outPath = "/tmp/avx-playground-out.bin";
+  const std::size_t n = 256u * 1'024u * 1'024u, bytes = n * sizeof(float);
+
+  {
+    avx::MappedFile file{path, bytes};
+    avx::fill(file.data<float>(), file.data<float>() + n, 1.f);
+  }
+
+  const auto time = [&](const char* name, auto fn) {
+    const auto t0 = clock::now();
+    const auto rv = fn();
+    const auto t1 = clock::now();
+    const auto elapsed = std::chrono::duration_cast<ns>(t1 - t0).count();
+    R(name << ' ' << elapsed / 1'000'000 << " ms " << static_cast<double>(bytes) / elapsed << " GB/s " << rv);
+  };
+
+  for (int pass = 0; pass < 2; ++pass) {
+    time("sum read", [&] {
+      std::vector<float> xs(n);
+      std::FILE* file = std::fopen(path.c_str(), "rb");
+      const auto read = std::fread(xs.data(), sizeof(float), n, file);
+      std::fclose(file);
+      return read == n ? avx::sum(xs.data(), xs.data() + n) : 0.f;
+    });
+
+    time("sum mapped", [&] {
+      avx::MappedFile in{path};
+      double rv{0};
+      avx::forEachChunk<float>(in, [&](const float* first, const float* last) { rv += avx::sum(first, last); });
+      return rv;
+    });
+
+    time("transform mapped", [&] {
+      avx::MappedFile in{path};
+      avx::MappedFile out{outPath, in.size()};
+      avx::transform<float>(in, out, [](const avx::vec8f& x) { return x + avx::vec8f{1.f}; });
+      return out.data<float>()[n - 1];
+    });
+  }
+
+  std::remove(path.c_str());
+  std::remove(outPath.c_str());
+}
+
+
+void interleaveTest() {
+  // 8 + 3 points x y z: all fields to registers, normalized, written back; against the scalar loop
+  std::vector<float> points(11u * 3u);
+  std::iota(begin(points), end(points), 1.f);
+  auto expected = points;
+
+  for (std::size_t i{0}; i < expected.size(); i += 3) {
+    const auto norm = std::sqrt(expected[i] * expected[i] + expected[i + 1] * expected[i + 1] +
+                                expected[i + 2] * expected[i + 2]);
+    expected[i] /= norm, expected[i + 1] /= norm, expected[i + 2] /= norm;
+  }
+
+  const auto normalize = [](avx::vec8f& x, avx::vec8f& y, avx::vec8f& z) {
+    const auto norm = sqrt(x * x + y * y + z * z);
+    x = x / norm, y = y / norm, z = z / norm;
+  };
+
+  avx::vec8f x, y, z;
+  avx::load3(points.data(), points.data() + 24, x, y, z);
+  R(x << "| " << y << "| " << z);
+  normalize(x, y, z);
+  avx::store3(x, y, z, points.data(), points.data() + 24);
+
+  // the three points left, y and z of the unused lanes are zero: the zero norm's nans are never stored
+  avx::load3_partial(points.data() + 24, points.data() + 33, x, y, z);
+  normalize(x, y, z);
+  avx::store3_partial(x, y, z, points.data() + 24, points.data() + 33);
+
+  bool same{true};
+  for (std::size_t i{0}; i < points.size(); ++i)
+    same &= std::abs(points[i] - expected[i]) < 1e-6f;
+  R("same " << same);
+
+  // pairs and RGBA pixels round trip
+  std::vector<std::int32_t> pixels(32u);
+  std::iota(begin(pixels), end(pixels), 0);
+  avx::vec8i r, g, b, a;
+  avx::load4(pixels.data(), pixels.data() + 32, r, g, b, a);
+  R(r << "| " << a);
+  std::vector<std::int32_t> back(32u);
+  avx::store4(r, g, b, a, back.data(), back.data() + 32);
+  avx::vec8i even, odd;
+  avx::load2(pixels.data(), pixels.data() + 16, even, odd);
+  R(even << "| " << odd);
+  avx::store2(even, odd, back.data(), back.data() + 16);
+  R("same " << (back == pixels));
+
+  // vec ranges through the standard algorithms
+  std::vector<float> xs(64u), ys(64u);
+  std::iota(begin(xs), end(xs), 0.f);
+  const auto vecs = avx::make_vec_range<8>(xs.data(), xs.data() + xs.size());
+  std::transform(vecs.begin(), vecs.end(), avx::make_vec_iterator<8>(ys.data()),
+                 [](const auto& v) -> avx::vec8f { return v * avx::vec8f{2.f}; });
+  const avx::vec8f sum = std::accumulate(vecs.begin(), vecs.end(), avx::vec8f{0.f});
+  R(hSum(sum) << ' ' << std::accumulate(begin(ys), end(ys), 0.f) / 2.f);
+
+  std::size_t blocks{0};
+  for (avx::vec8f v : vecs)
+    blocks += v[0] == static_cast<float>(blocks * 8u);
+  R(blocks << ' ' << (vecs.end() - vecs.begin()));
+
+  // every other row of an 8 x 8 matrix: a stride of two rows, filled from the standard algorithm
+  std::fill(avx::make_vec_iterator<8>(ys.data() + 16, 16), avx::make_vec_iterator<8>(ys.data() + 48, 16),
+            avx::vec8f{-1.f});
+  R(ys[15] << ' ' << ys[16] << ' ' << ys[23] << ' ' << ys[24] << ' ' << ys[32] << ' ' << ys[48]);
+}
+
+
+// normalizing 1 Mi interleaved xyz points in place: scalar loop against load3/store3; ms
+void interleavePerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  const std::size_t n = 1'024u * 1'024u;
+  std::vector<float> points(n * 3u);
+  std::mt19937 gen{0};
+  std::uniform_real_distribution<float> uniform{0.1f, 1.f};
+  std::generate(begin(points), end(points), [&] { return uniform(gen); });
+  auto copy = points;
+
+  const auto time = [&](const char* name, auto fn) {
+    const auto t0 = clock::now();
+    for (int rep = 0; rep < 20; ++rep)
+      fn();
+    const auto t1 = clock::now();
+    R(name << ' ' << std::chrono::duration_cast<ms>(t1 - t0).count() << " ms " << points[n * 3u - 1]);
+  };
+
+  for (int pass = 0; pass < 2; ++pass) {
+    time("scalar", [&] {
+      for (std::size_t i{0}; i < n * 3u; i += 3) {
+        const auto norm =
+            std::sqrt(points[i] * points[i] + points[i + 1] * points[i + 1] + points[i + 2] * points[i + 2]);
+        points[i] /= norm, points[i + 1] /= norm, points[i + 2] /= norm;
+      }
+    });
+    points = copy;
+
+    time("load3", [&] {
+      for (std::size_t i{0}; i < n * 3u; i += 24) {
+        auto* first = points.data() + i;
+        avx::vec8f x, y, z;
+        avx::load3(first, first + 24, x, y, z);
+        const auto norm = sqrt(x * x + y * y + z * z);
+        avx::store3(x / norm, y / norm, z / norm, first, first + 24);
+      }
+    });
+    points = copy;
+  }
+}
+
+
+void hashTest() {
+  // lane-wise hashes against the scalar ones
+  avx::vec8i keys{-1, 0, 1, 2, 42, 1'000'000, std::numeric_limits<std::int32_t>::min(), 0x12345678};
+  const auto murmur = avx::murmur3Mix(keys), xx = avx::xxhash32(keys, 7u);
+
+  bool same{true};
+  for (std::size_t i{0}; i < 8; ++i) {
+    const auto key = static_cast<std::uint32_t>(keys[i]);
+    same &= static_cast<std::uint32_t>(murmur[i]) == avx::murmur3Mix(key);
+    same &= static_cast<std::uint32_t>(xx[i]) == avx::xxhash32(key, 7u);
+  }
+  R("same " << same << ' ' << std::hex << avx::murmur3Mix(1u) << ' ' << avx::xxhash32(0u) << std::dec);
+
+  // counts per key through inserts, erases and growth, against std::unordered_map
+  avx::HashMap<std::int32_t> counts;
+  std::unordered_map<std::int32_t, std::int32_t> expected;
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<std::int32_t> keysIn{-5'000, 5'000};
+
+  for (int i = 0; i < 100'000; ++i) {
+    const auto key = keysIn(gen);
+    if (i % 7 == 0) {
+      same &= counts.erase(key) == (expected.erase(key) == 1);
+    } else {
+      counts[key] += 1;
+      expected[key] += 1;
+    }
+  }
+
+  same &= counts.size() == expected.size();
+  counts.forEach([&](std::int32_t key, std::int32_t count) { same &= expected.at(key) == count; });
+  R("same " << same << ' ' << counts.size() << " keys in " << counts.capacity() << " slots");
+
+  // batched lookups, hits and misses; lookups work on const tables
+  const auto& lookup = counts;
+  std::vector<std::int32_t> probes(1'003u), found(probes.size());
+  std::generate(begin(probes), end(probes), [&] { return keysIn(gen) * 2; });
+  const auto hits = lookup.find(probes.data(), probes.data() + probes.size(), found.data(), -1);
+
+  std::size_t expectedHits{0};
+  for (std::size_t i{0}; i < probes.size(); ++i) {
+    const auto it = expected.find(probes[i]);
+    expectedHits += it != expected.end();
+    same &= found[i] == (it != expected.end() ? it->second : -1);
+    same &= lookup.find(probes[i]) == nullptr ? it == expected.end() : *lookup.find(probes[i]) == it->second;
+  }
+  R("same " << same << ' ' << hits << ' ' << expectedHits);
+
+  avx::HashSet set;
+  for (const auto key : probes)
+    set.insert(key);
+  const auto& members = set;
+  std::unique_ptr<bool[]> contained{new bool[probes.size()]};
+  R(members.contains(probes.data(), probes.data() + probes.size(), contained.get()) << ' ' << probes.size() << ' '
+                                                                                       << members.contains(-1) << ' '
+                                                                                       << members.size());
+}
+
+
+// the probe side of a join: 16 Mi random keys against 16 Mi build side keys, a table far larger than the last level
+// cache, about 40% hits; std::unordered_map against HashMap one key at a time and batched; ms
+void hashPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  const std::size_t buildSize = 16u * 1'024u * 1'024u, probeSize = 16u * 1'024u * 1'024u;
+  std::mt19937 gen{0};
+  std::uniform_int_distribution<std::int32_t> keys{0, static_cast<std::int32_t>(buildSize) * 2};
+
+  std::vector<std::int32_t> build(buildSize), probes(probeSize), out(probeSize);
+  std::generate(begin(build), end(build), [&] { return keys(gen); });
+  std::generate(begin(probes), end(probes), [&] { return keys(gen); });
+
+  std::unordered_map<std::int32_t, std::int32_t> stdMap;
+  avx::HashMap<std::int32_t> map;
+  for (std::size_t i{0}; i < buildSize; ++i)
+    stdMap[build[i]] = static_cast<std::int32_t>(i), map[build[i]] = static_cast<std::int32_t>(i);
+
+  const auto time = [&](const char* name, auto fn) {
+    const auto t0 = clock::now();
+    const auto rv = fn();
+    const auto t1 = clock::now();
+    R(name << ' ' << std::chrono::duration_cast<ms>(t1 - t0).count() << " ms " << rv);
+  };
+
+  for (int pass = 0; pass < 2; ++pass) {
+    time("std::unordered_map", [&] {
+      std::size_t hits{0};
+      for (std::size_t i{0}; i < probeSize; ++i) {
+        const auto it = stdMap.find(probes[i]);
+        out[i] = it != stdMap.end() ? it->second : -1;
+        hits += it != stdMap.end();
+      }
+      return hits;
+    });
+
+    time("HashMap", [&] {
+      std::size_t hits{0};
+      for (std::size_t i{0}; i < probeSize; ++i) {
+        const auto* value = map.find(probes[i]);
+        out[i] = value != nullptr ? *value : -1;
+        hits += value != nullptr;
+      }
+      return hits;
+    });
+
+    time("HashMap batched", [&] { return map.find(probes.data(), probes.data() + probeSize, out.data(), -1); });
+  }
+}
+
+
+void randomTest() {
+  // Philox4x32-10 known answers from Random123's kat_vectors, counter and key the same in all lanes
+  const auto philox = [](std::uint32_t c0, std::uint32_t c1, std::uint32_t c2, std::uint32_t c3, std::uint32_t k0,
+                         std::uint32_t k1) {
+    avx::vec8i counter[4] = {avx::detail::broadcast(c0), avx::detail::broadcast(c1), avx::detail::broadcast(c2),
+                             avx::detail::broadcast(c3)};
+    avx::Philox4x32::bijection(counter, k0, k1);
+    R(std::hex << static_cast<std::uint32_t>(counter[0][0]) << ' ' << static_cast<std::uint32_t>(counter[1][0]) << ' '
+               << static_cast<std::uint32_t>(counter[2][0]) << ' ' << static_cast<std::uint32_t>(counter[3][7])
+               << std::dec);
+  };
+  philox(0u, 0u, 0u, 0u, 0u, 0u);
+  philox(~0u, ~0u, ~0u, ~0u, ~0u, ~0u);
+  philox(0x243F6A88u, 0x85A308D3u, 0x13198A2Eu, 0x03707344u, 0xA4093822u, 0x299F31D0u);
+
+  // xoshiro128+ lanes against the scalar sequence jumped ahead per lane
+  avx::Xoshiro128Plus xoshiro{42u, 3u};
+  auto seed = std::uint64_t{42u};
+  const auto low = avx::detail::splitMix64(seed), high = avx::detail::splitMix64(seed);
+  avx::detail::Xoshiro128 lane{{static_cast<std::uint32_t>(low), static_cast<std::uint32_t>(low >> 32),
+                                static_cast<std::uint32_t>(high), static_cast<std::uint32_t>(high >> 32)}};
+  for (int i = 0; i < 3; ++i)
+    lane.jump(avx::detail::Jump96);
+
+  std::vector<avx::detail::Xoshiro128> lanes;
+  for (int i = 0; i < 8; ++i, lane.jump(avx::detail::Jump64))
+    lanes.push_back(lane);
+
+  bool same{true};
+  for (int step = 0; step < 100; ++step) {
+    const auto x = xoshiro.next();
+    for (std::size_t i{0}; i < 8; ++i) {
+      same &= static_cast<std::uint32_t>(x[i]) == lanes[i].s[0] + lanes[i].s[3];
+      lanes[i].next();
+    }
+  }
+  R("same " << same);
+
+  // moments: uniform mean 1/2 and variance 1/12, normal 0 and 1
+  const auto moments = [](const char* name, const std::vector<float>& xs) {
+    const auto n = static_cast<double>(xs.size());
+    const auto mean = std::accumulate(begin(xs), end(xs), 0.) / n;
+    const auto var = std::accumulate(begin(xs), end(xs), 0., [&](double acc, float x) {
+      return acc + (x - mean) * (x - mean);
+    }) / n;
+    const auto minmax = std::minmax_element(begin(xs), end(xs));
+    R(name << " mean " << mean << " var " << var << " min " << *minmax.first << " max " << *minmax.second);
+  };
+
+  std::vector<float> xs(1'000'003u);
+  avx::Philox4x32 engine{7u};
+  avx::fillUniform(engine, xs.data(), xs.data() + xs.size());
+  moments("uniform philox", xs);
+  avx::fillUniform(xoshiro, xs.data(), xs.data() + xs.size(), -1.f, 1.f);
+  moments("uniform xoshiro [-1, 1)", xs);
+  avx::fillNormal(engine, xs.data(), xs.data() + xs.size());
+  moments("normal philox", xs);
+  avx::fillNormal(xoshiro, xs.data(), xs.data() + xs.size(), 10.f, 2.f);
+  moments("normal xoshiro (10, 2)", xs);
+
+  // seeking: position p is the p-th next()
+  avx::Philox4x32 ahead{7u, 1u};
+  avx::vec8i sequence[11];
+  for (auto& each : sequence)
+    each = ahead.next();
+  ahead.seek(6u);
+  R("seek " << avx::isCFlagSet(ahead.next() == sequence[6], avx::vec8i{-1}) << ' '
+            << avx::isCFlagSet(ahead.next() == sequence[7], avx::vec8i{-1}));
+
+  // multi-core fills: the same values whatever the schedule and the array's address -- here 12 bytes past the start of
+  // another allocation -- and the same as the single-core fill from Philox4x32(seed)
+  std::vector<float> ys(xs.size() + 3u), zs(xs.size());
+  const auto* offset = ys.data() + 3;
+  avx::parallel::fillNormal(1u, xs.data(), xs.data() + xs.size(), 0.f, 1.f, avx::parallel::Schedule::fixed);
+  avx::parallel::fillNormal(1u, ys.data() + 3, ys.data() + ys.size(), 0.f, 1.f, avx::parallel::Schedule::stealing);
+  avx::Philox4x32 serial{1u};
+  avx::fillNormal(serial, zs.data(), zs.data() + zs.size());
+  same = std::equal(begin(xs), end(xs), offset) && xs == zs;
+
+  avx::parallel::fillUniform(2u, xs.data(), xs.data() + xs.size(), -1.f, 1.f);
+  avx::parallel::fillUniform(2u, ys.data() + 3, ys.data() + ys.size(), -1.f, 1.f);
+  avx::Philox4x32 uniform{2u};
+  avx::fillUniform(uniform, zs.data(), zs.data() + zs.size(), -1.f, 1.f);
+  same &= std::equal(begin(xs), end(xs), offset) && xs == zs;
+
+  R("same " << same);
+  avx::parallel::fillNormal(1u, xs.data(), xs.data() + xs.size());
+  moments("parallel normal", xs);
+}
+
+
+// 64 Mi floats uniform in [0, 1) and normal; std::mt19937 with the standard distributions against the engines, and
+// the parallel fills; ms
+void randomPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ms = std::chrono::milliseconds;
+
+  std::vector<float> xs(64u * 1'024u * 1'024u);
+
+  const auto time = [&](const char* name, auto fn) {
+    const auto t0 = clock::now();
+    fn();
+    const auto t1 = clock::now();
+    R(name << ' ' << std::chrono::duration_cast<ms>(t1 - t0).count() << " ms " << xs[xs.size() / 2]);
+  };
+
+  std::mt19937 gen{0};
+  avx::Xoshiro128Plus xoshiro{0u};
+  avx::Philox4x32 philox{0u};
+
+  for (int pass = 0; pass < 2; ++pass) {
+    time("uniform std::mt19937", [&] {
+      std::uniform_real_distribution<float> dist{0.f, 1.f};
+      std::generate(begin(xs), end(xs), [&] { return dist(gen); });
+    });
+    time("uniform xoshiro128+", [&] { avx::fillUniform(xoshiro, xs.data(), xs.data() + xs.size()); });
+    time("uniform philox", [&] { avx::fillUniform(philox, xs.data(), xs.data() + xs.size()); });
+    time("uniform parallel", [&] { avx::parallel::fillUniform(0u, xs.data(), xs.data() + xs.size()); });
+
+    time("normal std::mt19937", [&] {
+      std::normal_distribution<float> dist{0.f, 1.f};
+      std::generate(begin(xs), end(xs), [&] { return dist(gen); });
+    });
+    time("normal xoshiro128+", [&] { avx::fillNormal(xoshiro, xs.data(), xs.data() + xs.size()); });
+    time("normal philox", [&] { avx::fillNormal(philox, xs.data(), xs.data() + xs.size()); });
+    time("normal parallel", [&] { avx::parallel::fillNormal(0u, xs.data(), xs.data() + xs.size()); });
+  }
+}
+
+
+void lowerBoundTest() {
+  std::mt19937 gen{0};
+  bool same{true};
+
+  // sizes around the tree's node and level boundaries, duplicates, queries outside the keys' range
+  for (const std::size_t n : {0u, 1u, 7u, 16u, 17u, 33u, 289u, 300u, 4'913u, 100'000u}) {
+    std::uniform_int_distribution<std::int32_t> keys{-1'000, 1'000};
+    std::vector<std::int32_t> sorted(n), queries(1'003u), bounds(queries.size()), tree(queries.size());
+
+    std::generate(begin(sorted), end(sorted), [&] { return keys(gen); });
+    std::sort(begin(sorted), end(sorted));
+    std::generate(begin(queries), end(queries), [&] { return keys(gen) + keys(gen) / 500; });
+    queries[0] = std::numeric_limits<std::int32_t>::min(), queries[1] = std::numeric_limits<std::int32_t>::max();
+
+    avx::lowerBound(sorted.data(), sorted.data() + n, queries.data(), queries.data() + queries.size(), bounds.data());
+
+    const avx::SearchTree<std::int32_t> index{sorted.data(), sorted.data() + n};
+    index.lowerBound(queries.data(), queries.data() + queries.size(), tree.data());
+
+    for (std::size_t i{0}; i < queries.size(); ++i) {
+      const auto expected = std::lower_bound(begin(sorted), end(sorted), queries[i]) - begin(sorted);
+      same &= bounds[i] == expected && tree[i] == expected;
+      same &= static_cast<std::ptrdiff_t>(index.lowerBound(queries[i])) == expected;
+    }
+  }
+  R("same " << same);
+
+  // floats, with infinities among keys and queries
+  std::uniform_real_distribution<float> values{-1.f, 1.f};
+  std::vector<float> sorted(1'000u), queries(777u);
+  std::vector<std::int32_t> bounds(queries.size()), tree(queries.size());
+  std::generate(begin(sorted), end(sorted), [&] { return values(gen); });
+  sorted[0] = std::numeric_limits<float>::infinity(), sorted[1] = -std::numeric_limits<float>::infinity();
+  std::sort(begin(sorted), end(sorted));
+  std::generate(begin(queries), end(queries), [&] { return values(gen); });
+  queries[0] = std::numeric_limits<float>::infinity(), queries[1] = -std::numeric_limits<float>::infinity();
+
+  avx::lowerBound(sorted.data(), sorted.data() + sorted.size(), queries.data(), queries.data() + queries.size(),
+                  bounds.data());
+  avx::SearchTree<float>{sorted.data(), sorted.data() + sorted.size()}.lowerBound(queries.data(),
+                                                                                  queries.data() + queries.size(),
+                                                                                  tree.data());
+  for (std::size_t i{0}; i < queries.size(); ++i) {
+    const auto expected = std::lower_bound(begin(sorted), end(sorted), queries[i]) - begin(sorted);
+    same &= bounds[i] == expected && tree[i] == expected;
+  }
+  R("same " << same << ' ' << bounds[0] << ' ' << bounds[1]);
+}
+
+
+// 4 Mi random queries against sorted int32 arrays sized for L2, L3 and DRAM: std::lower_bound one query at a time,
+// lowerBound in lockstep, the SearchTree one at a time and batched; ns per query
+void lowerBoundPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ns = std::chrono::nanoseconds;
+
+  const std::size_t querySize = 4u * 1'024u * 1'024u;
+  std::mt19937 gen{0};
+
+  for (const std::size_t n : {32u * 1'024u, 4u * 1'024u * 1'024u, 128u * 1'024u * 1'024u}) {
+    std::uniform_int_distribution<std::int32_t> keys{0, std::numeric_limits<std::int32_t>::max()};
+    std::vector<std::int32_t> sorted(n), queries(querySize), out(querySize);
+    std::generate(begin(sorted), end(sorted), [&] { return keys(gen); });
+    std::sort(begin(sorted), end(sorted));
+    std::generate(begin(queries), end(queries), [&] { return keys(gen); });
+
+    const avx::SearchTree<std::int32_t> index{sorted.data(), sorted.data() + n};
+
+    const auto time = [&](const char* name, auto fn) {
+      const auto t0 = clock::now();
+      fn();
+      const auto t1 = clock::now();
+      const auto perQuery = static_cast<double>(std::chrono::duration_cast<ns>(t1 - t0).count()) / querySize;
+      R(n * sizeof(std::int32_t) / 1'024u << " KiB " << name << ' ' << perQuery << " ns " << out[querySize / 2]);
+    };
+
+    for (int pass = 0; pass < 2; ++pass) {
+      time("std::lower_bound", [&] {
+        for (std::size_t i{0}; i < querySize; ++i)
+          out[i] = static_cast<std::int32_t>(std::lower_bound(begin(sorted), end(sorted), queries[i]) - begin(sorted));
+      });
+      time("lowerBound", [&] {
+        avx::lowerBound(sorted.data(), sorted.data() + n, queries.data(), queries.data() + querySize, out.data());
+      });
+      time("SearchTree", [&] {
+        for (std::size_t i{0}; i < querySize; ++i)
+          out[i] = static_cast<std::int32_t>(index.lowerBound(queries[i]));
+      });
+      time("SearchTree batched", [&] { index.lowerBound(queries.data(), queries.data() + querySize, out.data()); });
+    }
+  }
+}
+
+
+// kernels wrapped in scopes, their stats as json; events this machine or kernel does not count are null
+void countersTest() {
+  avx::counters::enable();
+  avx::counters::reset();
+
+  std::vector<float> xs(16u * 1'024u * 1'024u, 1.f), ys(xs.size());
+
+  for (int i = 0; i < 3; ++i) {
+    const avx::counters::Scope scope{"copy"};
+    avx::copy(xs.data(), xs.data() + xs.size(), ys.data());
+  }
+
+  float total{0.f};
+  for (int i = 0; i < 5; ++i) {
+    const avx::counters::Scope scope{"sum"};
+    total += avx::sum(ys.data(), ys.data() + ys.size());
+  }
+
+  {
+    const avx::counters::Scope scope{"exp"};
+    avx::transform(xs.data(), xs.data() + xs.size(), ys.data(), [](const avx::vec8f& x) { return avx::exp(x); });
+  }
+
+  // disabled scopes are not counted
+  avx::counters::enable(false);
+  { const avx::counters::Scope scope{"sum"}; }
+
+  R(total);
+  for (const auto& each : avx::counters::stats())
+    R(each.first << ' ' << each.second.calls);
+  avx::counters::printJson();
+}
+
+
+// the cost of a scope disabled, enabled, and without the vzeroupper; ns per scope
+void countersPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using ns = std::chrono::nanoseconds;
+
+  const auto time = [&](const char* name, std::size_t n, auto fn) {
+    const auto t0 = clock::now();
+    for (std::size_t i{0}; i < n; ++i)
+      fn();
+    const auto t1 = clock::now();
+    R(name << ' ' << static_cast<double>(std::chrono::duration_cast<ns>(t1 - t0).count()) / n << " ns");
+  };
+
+  for (int pass = 0; pass < 2; ++pass) {
+    avx::counters::enable(false);
+    time("disabled", 100'000'000u, [] { const avx::counters::Scope scope{"empty"}; });
+    time("disabled, no vzeroupper", 100'000'000u,
+         [] { const avx::counters::Scope scope{"empty", avx::counters::Exit::none}; });
+
+    avx::counters::enable();
+    time("enabled", 100'000u, [] { const avx::counters::Scope scope{"empty"}; });
+    avx::counters::enable(false);
+  }
+}
+
+
+void bitmapTest() {
+  std::mt19937 gen{0};
+  bool same{true};
+
+  // popcounts per byte against the scalar ones
+  avx::vec32b bytes;
+  std::uniform_int_distribution<int> byte{-128, 127};
+  for (auto& each : bytes)
+    each = static_cast<std::int8_t>(byte(gen));
+  const auto counts = avx::popcount(bytes);
+  for (std::size_t i{0}; i < 32; ++i)
+    same &= counts[i] == __builtin_popcount(static_cast<std::uint8_t>(bytes[i]));
+  R("same " << same);
+
+  // sizes below, at and past Harley-Seal's sixteen blocks, sparse and dense
+  for (const std::size_t n : {0u, 1u, 255u, 256u, 4'095u, 4'096u, 4'097u, 100'003u}) {
+    for (const double density : {0.01, 0.5, 0.99}) {
+      std::bernoulli_distribution bit{density};
+      std::vector<bool> a(n), b(n), c(n);
+      std::vector<std::int32_t> ia, ib, ic;
+
+      for (std::size_t i{0}; i < n; ++i) {
+        if ((a[i] = bit(gen)))
+          ia.push_back(static_cast<std::int32_t>(i));
+        if ((b[i] = bit(gen)))
+          ib.push_back(static_cast<std::int32_t>(i));
+        if ((c[i] = bit(gen)))
+          ic.push_back(static_cast<std::int32_t>(i));
+      }
+
+      const avx::Bitmap x{n, ia.data(), ia.data() + ia.size()}, y{n, ib.data(), ib.data() + ib.size()},
+          z{n, ic.data(), ic.data() + ic.size()};
+      same &= x.count() == ia.size();
+
+      // the bitmaps' indices are the ones they were built from, into exactly as many slots and into more
+      std::vector<std::int32_t> indices(x.count()), slack(x.count() + 13u, -1);
+      same &= x.indices(indices.data(), indices.data() + indices.size()) == ia.size() && indices == ia;
+      same &= x.indices(slack.data(), slack.data() + slack.size()) == ia.size() &&
+              std::equal(begin(ia), end(ia), begin(slack));
+
+      std::size_t both{0}, any{0}, only{0}, odd{0};
+      for (std::size_t i{0}; i < n; ++i) {
+        both += a[i] && b[i] && c[i];
+        any += a[i] || b[i] || c[i];
+        only += a[i] && !b[i] && !c[i];
+        odd += a[i] ^ b[i] ^ c[i];
+      }
+
+      avx::Bitmap out{n};
+      same &= avx::intersect(out, x, y, z) == both && out.count() == both && avx::intersectCount(x, y, z) == both;
+      same &= avx::unite(out, x, y, z) == any && out.count() == any && avx::uniteCount(x, y, z) == any;
+      same &= avx::subtract(out, x, y, z) == only && out.count() == only && avx::subtractCount(x, y, z) == only;
+      same &= avx::symmetricDifference(out, x, y, z) == odd && avx::symmetricDifferenceCount(x, y, z) == odd;
+
+      for (std::size_t i{0}; i < n; ++i)
+        same &= out.test(i) == (a[i] ^ b[i] ^ c[i]);
+    }
+  }
+  R("same " << same);
+}
+
+
+// bitmaps of 1 Mi bits (128 KiB each, in L2) and 1 Gi bits (128 MiB each, in DRAM), about half the bits set: popcount
+// with scalar popcnt against Harley-Seal, the intersection of two in a scalar loop, written out then counted, and
+// fused, and the conversion to indices; us
+void bitmapPerf() {
+  using clock = std::chrono::high_resolution_clock;
+  using us = std::chrono::microseconds;
+
+  for (const std::size_t n : {1'024u * 1'024u, 1'024u * 1'024u * 1'024u}) {
+    avx::Bitmap x{n}, y{n}, out{n};
+
+    std::mt19937_64 gen{0};
+    std::generate(x.words(), x.words() + n / 64u, std::ref(gen));
+    std::generate(y.words(), y.words() + n / 64u, std::ref(gen));
+
+    std::vector<std::int32_t> indices(x.count());
+
+    // about a gigabit per measurement
+    const auto repeat = 1'024u * 1'024u * 1'024u / n;
+
+    const auto time = [&](const char* name, auto fn) {
+      const auto t0 = clock::now();
+      std::size_t rv{0};
+      for (std::size_t i{0}; i < repeat; ++i)
+        rv += fn();
+      const auto t1 = clock::now();
+      const auto perPass = static_cast<double>(std::chrono::duration_cast<us>(t1 - t0).count()) / repeat;
+      R(n / 8u / 1'024u << " KiB " << name << ' ' << perPass << " us " << rv / repeat);
+    };
+
+    for (int pass = 0; pass < 2; ++pass) {
+      time("popcnt", [&] {
+        std::size_t rv{0};
+        for (std::size_t i{0}; i < n / 64u; ++i)
+          rv += static_cast<std::size_t>(__builtin_popcountll(x.words()[i]));
+        return rv;
+      });
+      time("Harley-Seal", [&] { return x.count(); });
+
+      time("and, popcnt", [&] {
+        std::size_t rv{0};
+        for (std::size_t i{0}; i < n / 64u; ++i) {
+          out.words()[i] = x.words()[i] & y.words()[i];
+          rv += static_cast<std::size_t>(__builtin_popcountll(out.words()[i]));
+        }
+        return rv;
+      });
+      time("intersect then count", [&] {
+        avx::intersect(out, x, y);
+        return out.count();
+      });
+      time("intersect", [&] { return avx::intersect(out, x, y); });
+      time("intersectCount", [&] { return avx::intersectCount(x, y); });
+      time("indices", [&] { return x.indices(indices.data(), indices.data() + indices.size()); });
+    }
+  }
+}
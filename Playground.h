@@ -0,0 +1,57 @@
+#pragma once
+
+// vec<T, N> playground, built with ISAFLAGS.avx2; only call into it after checking avx::cpu::isa()
+
+void blendTest();
+void dotTest();
+void permuteTest();
+void shuffleTest();
+void unpackTest();
+void fmaTest();
+
+void shiftTest();
+void bitTest();
+void comparisonTest();
+void tailTest();
+void lookupTest();
+void lookupPerf();
+void mathTest();
+void mathPerf();
+void reduceTest();
+void reducePerf();
+void memoryTest();
+void memoryPerf();
+void exprTest();
+void exprPerf();
+void parallelTest();
+void parallelPerf();
+void divideTest();
+void dividePerf();
+void laneTest();
+void lanePerf();
+void sortTest();
+void sortPerf();
+void scanTest();
+void scanPerf();
+void searchTest();
+void searchPerf();
+void gemmTest();
+void gemmPerf();
+void halfTest();
+void halfPerf();
+void copyTest();
+void copyPerf();
+void fileTest();
+void filePerf();
+void interleaveTest();
+void interleavePerf();
+void hashTest();
+void hashPerf();
+void randomTest();
+void randomPerf();
+void lowerBoundTest();
+void lowerBoundPerf();
+void countersTest();
+void countersPerf();
+void bitmapTest();
+void bitmapPerf();
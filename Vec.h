@@ -1,6 +1,34 @@
 #pragma once
 
-#include "Vec8Float.h" // 8 x 32bit single precision floating point values
-#include "Vec8Int.h"   // 8 x 32bit signed integer values
+#include "Vec8Float.h"     // 8 x 32bit single precision floating point values
+#include "Vec8Int.h"       // 8 x 32bit signed integer values
+#include "VecDivide.h"     // division by invariant divisors
+#include "Vec4Double.h"    // 4 x 64bit double precision floating point values
+#include "Vec4Long.h"      // 4 x 64bit signed integer values
+#include "Vec16Short.h"    // 16 x 16bit signed integer values
+#include "Vec32Byte.h"     // 32 x 8bit signed integer values
+#if defined(__AVX512F__)
+#include "Vec16Float.h"    // 16 x 32bit single precision floating point values, AVX-512
+#include "Vec16Int.h"      // 16 x 32bit signed integer values and mask16, AVX-512
+#endif
+#include "VecMemory.h"     // aligned allocator, aligned spans and arena
+#include "VecHalf.h"       // half and bfloat16 arrays through vec8f kernels
+#include "Vec8FloatMath.h" // exp, log, sin, cos, tanh, pow
+#include "VecLoop.h"       // masked head and tail loops over arrays of any length
+#include "VecCopy.h"       // copy, fill and transform with automatic non-temporal stores
+#include "VecFile.h"       // memory-mapped column files streamed through kernels in chunks
+#include "VecExpr.h"       // lazy fused whole-array expressions
+#include "VecLookup.h"     // gathers and in-register table lookups
+#include "VecInterleave.h" // load2/3/4 and store2/3/4: arrays of structs to registers per field and back
+#include "VecReduce.h"     // sum, min, max, argmin, argmax, dot over arrays
+#include "VecSort.h"       // sorting networks, quicksort, argsort and merge
+#include "VecScan.h"       // prefix sums and stream compaction
+#include "VecSearch.h"     // byte search: memchr, strlen, substrings, csv delimiters
+#include "VecLowerBound.h" // batched lower_bound over sorted arrays and an implicit B-tree layout
+#include "VecHash.h"       // vec8i hashing, Swiss table set and map with batched lookups
+#include "VecBitmap.h"     // bitmaps: and, or, andnot, xor fused with Harley-Seal popcounts, index lists
+#include "VecRandom.h"     // xoshiro128+ and Philox engines: uniform and normal vec8f, bulk fills
+#include "VecMatrix.h"     // 8 x 8 transpose and blocked sgemm
+#include "VecParallel.h"   // transform and sum on all cores
 
 // XXX: yes, there is a lot missing :)
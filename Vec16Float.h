@@ -0,0 +1,256 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <immintrin.h>
+#include "VecBase.h"
+#include "Vec8Float.h"
+#include "Vec16Int.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// AVX-512F only: and, or, xor on ps need AVX-512DQ, bitwise ops go through the integer domain instead; the intrinsics
+// are the zero-masking forms with all lanes set, see Vec16Int.h
+using vec16f = vec<float, 16u>;
+
+template <>
+struct vec<float, 16u> final {
+  using Value = float;
+  using Mask = mask16;
+  static const constexpr std::size_t Size = 16u;
+
+  // thin abstraction; instead of explicit conversion operator and the need for static-casting, just use .zmm
+  __m512 zmm;
+
+  // zero rather than _mm512_undefined_ps, see vec8f
+  vec() : zmm(_mm512_setzero_ps()) {}
+  vec(__m512 x) : zmm(x) {}
+  vec(Value scalar) { load(scalar); }
+  vec(const Value* first, const Value* last) { load(first, last); }
+
+  // load
+  void load(Value scalar) { zmm = _mm512_set1_ps(scalar); }
+
+  void load(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    zmm = _mm512_loadu_ps(first);
+  }
+
+  void load_aligned(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    zmm = _mm512_load_ps(first);
+  }
+
+  // lanes in the mask are loaded, others are zero; masked-out memory is never touched, no fault either
+  void load_masked(const Value* first, const mask16& mask) { zmm = _mm512_maskz_loadu_ps(mask.k, first); }
+
+  // [first, last) may be shorter than Size, remaining lanes are zero
+  void load_partial(const Value* first, const Value* last) {
+    assert(last - first >= 0 && static_cast<std::size_t>(last - first) <= Size);
+    load_masked(first, laneMask16(last - first));
+  }
+
+  // consecutive values from first into the lanes in the mask, in lane order; others are zero
+  void load_expanded(const Value* first, const mask16& mask) { zmm = _mm512_maskz_expandloadu_ps(mask.k, first); }
+
+  // lane i = base[index[i]]
+  void gather(const Value* base, const vec16i& index) {
+    zmm = _mm512_mask_i32gather_ps(_mm512_setzero_ps(), 0xFFFF, index.zmm, base, sizeof(Value));
+  }
+
+  // as above for lanes in the mask; others keep their value and their memory is never touched
+  void gather_masked(const Value* base, const vec16i& index, const mask16& mask) {
+    zmm = _mm512_mask_i32gather_ps(zmm, mask.k, index.zmm, base, sizeof(Value));
+  }
+
+  // store
+  void store(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm512_storeu_ps(first, zmm);
+  }
+
+  void store_aligned(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm512_store_ps(first, zmm);
+  }
+
+  void store_aligned_stream(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm512_stream_ps(first, zmm);
+  }
+
+  // only lanes in the mask are written
+  void store_masked(Value* first, const mask16& mask) { _mm512_mask_storeu_ps(first, mask.k, zmm); }
+
+  // [first, last) may be shorter than Size, writes the first last - first lanes only
+  void store_partial(Value* first, Value* last) {
+    assert(last - first >= 0 && static_cast<std::size_t>(last - first) <= Size);
+    store_masked(first, laneMask16(last - first));
+  }
+
+  // the lanes in the mask to consecutive values from first, in lane order; returns the number written
+  std::size_t store_compressed(Value* first, const mask16& mask) {
+    _mm512_mask_compressstoreu_ps(first, mask.k, zmm);
+    return static_cast<std::size_t>(count(mask));
+  }
+
+  // base[index[i]] = lane i; on duplicate indices the highest lane wins
+  void scatter(Value* base, const vec16i& index) { _mm512_i32scatter_ps(base, index.zmm, zmm, sizeof(Value)); }
+
+  // as above for lanes in the mask
+  void scatter_masked(Value* base, const vec16i& index, const mask16& mask) {
+    _mm512_mask_i32scatter_ps(base, mask.k, index.zmm, zmm, sizeof(Value));
+  }
+
+  // misc
+  void zero() { zmm = _mm512_setzero_ps(); }
+
+  // compound ops, no implicit conversion needed for lhs
+  vec16f& operator+=(const vec16f& rhs) {
+    zmm = _mm512_add_ps(zmm, rhs.zmm);
+    return *this;
+  }
+
+  vec16f& operator-=(const vec16f& rhs) {
+    zmm = _mm512_sub_ps(zmm, rhs.zmm);
+    return *this;
+  }
+
+  vec16f& operator*=(const vec16f& rhs) {
+    zmm = _mm512_mul_ps(zmm, rhs.zmm);
+    return *this;
+  }
+
+  vec16f& operator/=(const vec16f& rhs) {
+    zmm = _mm512_div_ps(zmm, rhs.zmm);
+    return *this;
+  }
+
+  // subscript
+  Value& operator[](std::size_t index) {
+    assert(index < Size);
+    return *(reinterpret_cast<Value*>(&zmm) + index);
+  }
+
+  const Value& operator[](std::size_t index) const {
+    assert(index < Size);
+    return *(reinterpret_cast<const Value*>(&zmm) + index);
+  }
+};
+
+
+// free standing functions, participate in implicit conversion for lhs and rhs
+inline vec16f operator+(const vec16f& lhs, const vec16f& rhs) { return {_mm512_add_ps(lhs.zmm, rhs.zmm)}; }
+inline vec16f operator-(const vec16f& lhs, const vec16f& rhs) { return {_mm512_sub_ps(lhs.zmm, rhs.zmm)}; }
+inline vec16f operator*(const vec16f& lhs, const vec16f& rhs) { return {_mm512_mul_ps(lhs.zmm, rhs.zmm)}; }
+inline vec16f operator/(const vec16f& lhs, const vec16f& rhs) { return {_mm512_div_ps(lhs.zmm, rhs.zmm)}; }
+
+// conversions; convert rounds according to MXCSR (to nearest by default), reinterpret keeps the bits as they are
+inline vec16i convert(const vec16f& x) { return {_mm512_maskz_cvtps_epi32(0xFFFF, x.zmm)}; }
+inline vec16i convertTruncate(const vec16f& x) { return {_mm512_maskz_cvttps_epi32(0xFFFF, x.zmm)}; }
+inline vec16f convert(const vec16i& x) { return {_mm512_maskz_cvtepi32_ps(0xFFFF, x.zmm)}; }
+
+inline vec16i reinterpret(const vec16f& x) { return {_mm512_castps_si512(x.zmm)}; }
+inline vec16f reinterpret(const vec16i& x) { return {_mm512_castsi512_ps(x.zmm)}; }
+
+inline vec16f operator|(const vec16f& lhs, const vec16f& rhs) { return reinterpret(reinterpret(lhs) | reinterpret(rhs)); }
+inline vec16f operator&(const vec16f& lhs, const vec16f& rhs) { return reinterpret(reinterpret(lhs) & reinterpret(rhs)); }
+inline vec16f operator^(const vec16f& lhs, const vec16f& rhs) { return reinterpret(reinterpret(lhs) ^ reinterpret(rhs)); }
+
+// unary
+inline vec16f operator~(const vec16f& x) { return reinterpret(~reinterpret(x)); }
+inline vec16f operator-(const vec16f& x) { return x ^ vec16f{-0.f}; }
+
+
+// predicates as for vec8f, see there; the result is a mask16, not a vector
+template <int ComparisonMask8Bit>
+inline mask16 compare(const vec16f& lhs, const vec16f& rhs) { return {_mm512_cmp_ps_mask(lhs.zmm, rhs.zmm, ComparisonMask8Bit)}; }
+
+inline mask16 operator==(const vec16f& lhs, const vec16f& rhs) { return compare<0>(lhs, rhs); }
+inline mask16 operator!=(const vec16f& lhs, const vec16f& rhs) { return compare<4>(lhs, rhs); }
+inline mask16 operator<(const vec16f& lhs, const vec16f& rhs) { return compare<1>(lhs, rhs); }
+inline mask16 operator>(const vec16f& lhs, const vec16f& rhs) { return compare<14>(lhs, rhs); }
+inline mask16 operator<=(const vec16f& lhs, const vec16f& rhs) { return compare<2>(lhs, rhs); }
+inline mask16 operator>=(const vec16f& lhs, const vec16f& rhs) { return compare<13>(lhs, rhs); }
+
+
+// masked operations: lanes in the mask are computed, the others are taken from src
+inline vec16f blend(const vec16f& lhs, const vec16f& rhs, const mask16& mask) { return {_mm512_mask_blend_ps(mask.k, lhs.zmm, rhs.zmm)}; }
+inline vec16f zeroMasked(const vec16f& x, const mask16& mask) { return {_mm512_maskz_mov_ps(mask.k, x.zmm)}; }
+
+inline vec16f addMasked(const vec16f& src, const mask16& mask, const vec16f& lhs, const vec16f& rhs) {
+  return {_mm512_mask_add_ps(src.zmm, mask.k, lhs.zmm, rhs.zmm)};
+}
+
+inline vec16f subMasked(const vec16f& src, const mask16& mask, const vec16f& lhs, const vec16f& rhs) {
+  return {_mm512_mask_sub_ps(src.zmm, mask.k, lhs.zmm, rhs.zmm)};
+}
+
+inline vec16f mulMasked(const vec16f& src, const mask16& mask, const vec16f& lhs, const vec16f& rhs) {
+  return {_mm512_mask_mul_ps(src.zmm, mask.k, lhs.zmm, rhs.zmm)};
+}
+
+inline vec16f divMasked(const vec16f& src, const mask16& mask, const vec16f& lhs, const vec16f& rhs) {
+  return {_mm512_mask_div_ps(src.zmm, mask.k, lhs.zmm, rhs.zmm)};
+}
+
+// the lanes in the mask moved to the front in lane order, the rest zero; expand is the inverse
+inline vec16f compress(const vec16f& x, const mask16& mask) { return {_mm512_maskz_compress_ps(mask.k, x.zmm)}; }
+inline vec16f expand(const vec16f& x, const mask16& mask) { return {_mm512_maskz_expand_ps(mask.k, x.zmm)}; }
+
+
+// misc
+// lane i = x[index[i] % 16], across the whole register
+inline vec16f permute(const vec16f& x, const vec16i& index) { return {_mm512_maskz_permutexvar_ps(0xFFFF, index.zmm, x.zmm)}; }
+
+inline vec16f unpackHigh(const vec16f& lhs, const vec16f& rhs) { return {_mm512_maskz_unpackhi_ps(0xFFFF, lhs.zmm, rhs.zmm)}; }
+inline vec16f unpackLow(const vec16f& lhs, const vec16f& rhs) { return {_mm512_maskz_unpacklo_ps(0xFFFF, lhs.zmm, rhs.zmm)}; }
+
+// lanes 0-7 resp. 8-15 as vec8f, and back
+inline vec8f low(const vec16f& x) { return reinterpret(low(reinterpret(x))); }
+inline vec8f high(const vec16f& x) { return reinterpret(high(reinterpret(x))); }
+inline vec16f combine(const vec8f& low, const vec8f& high) {
+  return reinterpret(combine(reinterpret(low), reinterpret(high)));
+}
+
+
+// math
+template <int RoundingMode = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC>
+inline vec16f round(const vec16f& x) { return {_mm512_maskz_roundscale_ps(0xFFFF, x.zmm, RoundingMode)}; }
+
+inline vec16f ceil(const vec16f& x) { return round<_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC>(x); }
+inline vec16f floor(const vec16f& x) { return round<_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC>(x); }
+
+inline vec16f min(const vec16f& lhs, const vec16f& rhs) { return {_mm512_maskz_min_ps(0xFFFF, lhs.zmm, rhs.zmm)}; }
+inline vec16f max(const vec16f& lhs, const vec16f& rhs) { return {_mm512_maskz_max_ps(0xFFFF, lhs.zmm, rhs.zmm)}; }
+
+inline vec16f abs(const vec16f& x) { return {_mm512_abs_ps(x.zmm)}; }
+
+inline vec16f sqrt(const vec16f& x) { return {_mm512_maskz_sqrt_ps(0xFFFF, x.zmm)}; }
+// maximum relative error for this approximation is less than 2^-14
+inline vec16f reciprocalSqrt(const vec16f& x) { return {_mm512_maskz_rsqrt14_ps(0xFFFF, x.zmm)}; }
+
+// maximum relative error for this approximation is less than 2^-14
+inline vec16f reciprocal(const vec16f& x) { return {_mm512_maskz_rcp14_ps(0xFFFF, x.zmm)}; }
+
+// full reductions of all sixteen lanes to a scalar, halving to vec8f first; once per array, not per block
+inline float hSum(const vec16f& x) { return hSum(low(x) + high(x)); }
+inline float hMin(const vec16f& x) { return hMin(min(low(x), high(x))); }
+inline float hMax(const vec16f& x) { return hMax(max(low(x), high(x))); }
+
+
+// FMA, see vec8f
+inline vec16f fusedMulAdd(const vec16f& a, const vec16f& b, const vec16f& c) { return {_mm512_fmadd_ps(a.zmm, b.zmm, c.zmm)}; }
+inline vec16f fusedMulSub(const vec16f& a, const vec16f& b, const vec16f& c) { return {_mm512_fmsub_ps(a.zmm, b.zmm, c.zmm)}; }
+inline vec16f fusedMulNegateAdd(const vec16f& a, const vec16f& b, const vec16f& c) { return {_mm512_fnmadd_ps(a.zmm, b.zmm, c.zmm)}; }
+inline vec16f fusedMulNegateSub(const vec16f& a, const vec16f& b, const vec16f& c) { return {_mm512_fnmsub_ps(a.zmm, b.zmm, c.zmm)}; }
+inline vec16f fusedMulAddSub(const vec16f& a, const vec16f& b, const vec16f& c) { return {_mm512_fmaddsub_ps(a.zmm, b.zmm, c.zmm)}; }
+inline vec16f fusedMulSubAdd(const vec16f& a, const vec16f& b, const vec16f& c) { return {_mm512_fmsubadd_ps(a.zmm, b.zmm, c.zmm)}; }
+
+// masked fusedMulAdd: (a * b) + c in the lanes in the mask, a elsewhere
+inline vec16f fusedMulAddMasked(const vec16f& a, const mask16& mask, const vec16f& b, const vec16f& c) {
+  return {_mm512_mask_fmadd_ps(a.zmm, mask.k, b.zmm, c.zmm)};
+}
+}
+}
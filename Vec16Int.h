@@ -0,0 +1,273 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include "VecBase.h"
+#include "Vec8Int.h"
+
+#if !defined(__AVX512F__)
+#error "vec16i needs AVX-512, build with ISAFLAGS.avx512; see Vec.h"
+#endif
+
+// GCC 12's plain AVX-512 intrinsics, even the casts, start from _mm512_undefined_* and trip -Wuninitialized once
+// inlined; their zero-masking forms with all lanes set compile to the same instructions and are used instead
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// AVX-512 mask register, one bit per lane: what vec16f and vec16i comparisons return and masked operations take,
+// instead of the all ones resp. all zeros lanes of vec8f and vec8i
+struct mask16 final {
+  __mmask16 k;
+
+  mask16() : k(0) {}
+  mask16(__mmask16 x) : k(x) {}
+};
+
+inline mask16 operator&(const mask16& lhs, const mask16& rhs) { return {_mm512_kand(lhs.k, rhs.k)}; }
+inline mask16 operator|(const mask16& lhs, const mask16& rhs) { return {_mm512_kor(lhs.k, rhs.k)}; }
+inline mask16 operator^(const mask16& lhs, const mask16& rhs) { return {_mm512_kxor(lhs.k, rhs.k)}; }
+inline mask16 operator~(const mask16& x) { return {_mm512_knot(x.k)}; }
+
+// bit i for lane i, as moveMask for vec8f and vec8i
+inline int moveMask(const mask16& x) { return static_cast<int>(x.k); }
+
+inline bool any(const mask16& x) { return x.k != 0; }
+inline bool all(const mask16& x) { return x.k == 0xFFFF; }
+inline bool none(const mask16& x) { return x.k == 0; }
+inline int count(const mask16& x) { return __builtin_popcount(x.k); }
+
+// mask with the first n lanes set, e.g. for the tail of an array; n >= 16 sets all lanes
+inline mask16 laneMask16(std::size_t n) {
+  return {static_cast<__mmask16>(n < 16u ? (1u << n) - 1u : 0xFFFFu)};
+}
+
+
+using vec16i = vec<std::int32_t, 16u>;
+
+template <>
+struct vec<std::int32_t, 16u> final {
+  using Value = std::int32_t;
+  using Mask = mask16;
+  static const constexpr std::size_t Size = 16u;
+
+  // thin abstraction; instead of explicit conversion operator and the need for static-casting, just use .zmm
+  __m512i zmm;
+
+  // zero rather than _mm512_undefined_epi32, see vec8f
+  vec() : zmm(_mm512_setzero_si512()) {}
+  vec(__m512i x) : zmm(x) {}
+  vec(Value scalar) { load(scalar); }
+  vec(const Value* first, const Value* last) { load(first, last); }
+
+  // load
+  void load(Value scalar) { zmm = _mm512_set1_epi32(scalar); }
+
+  void load(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    zmm = _mm512_loadu_si512(first);
+  }
+
+  void load_aligned(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    zmm = _mm512_load_si512(first);
+  }
+
+  // lanes in the mask are loaded, others are zero; masked-out memory is never touched, no fault either
+  void load_masked(const Value* first, const mask16& mask) { zmm = _mm512_maskz_loadu_epi32(mask.k, first); }
+
+  // [first, last) may be shorter than Size, remaining lanes are zero
+  void load_partial(const Value* first, const Value* last) {
+    assert(last - first >= 0 && static_cast<std::size_t>(last - first) <= Size);
+    load_masked(first, laneMask16(last - first));
+  }
+
+  // consecutive values from first into the lanes in the mask, in lane order; others are zero
+  void load_expanded(const Value* first, const mask16& mask) { zmm = _mm512_maskz_expandloadu_epi32(mask.k, first); }
+
+  // lane i = base[index[i]]
+  void gather(const Value* base, const vec16i& index) {
+    zmm = _mm512_mask_i32gather_epi32(_mm512_setzero_si512(), 0xFFFF, index.zmm, base, sizeof(Value));
+  }
+
+  // as above for lanes in the mask; others keep their value and their memory is never touched
+  void gather_masked(const Value* base, const vec16i& index, const mask16& mask) {
+    zmm = _mm512_mask_i32gather_epi32(zmm, mask.k, index.zmm, base, sizeof(Value));
+  }
+
+  // store
+  void store(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm512_storeu_si512(first, zmm);
+  }
+
+  void store_aligned(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm512_store_si512(first, zmm);
+  }
+
+  void store_aligned_stream(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm512_stream_si512(reinterpret_cast<__m512i*>(first), zmm);
+  }
+
+  // only lanes in the mask are written
+  void store_masked(Value* first, const mask16& mask) { _mm512_mask_storeu_epi32(first, mask.k, zmm); }
+
+  // [first, last) may be shorter than Size, writes the first last - first lanes only
+  void store_partial(Value* first, Value* last) {
+    assert(last - first >= 0 && static_cast<std::size_t>(last - first) <= Size);
+    store_masked(first, laneMask16(last - first));
+  }
+
+  // the lanes in the mask to consecutive values from first, in lane order; returns the number written
+  std::size_t store_compressed(Value* first, const mask16& mask) {
+    _mm512_mask_compressstoreu_epi32(first, mask.k, zmm);
+    return static_cast<std::size_t>(count(mask));
+  }
+
+  // base[index[i]] = lane i; on duplicate indices the highest lane wins
+  void scatter(Value* base, const vec16i& index) { _mm512_i32scatter_epi32(base, index.zmm, zmm, sizeof(Value)); }
+
+  // as above for lanes in the mask
+  void scatter_masked(Value* base, const vec16i& index, const mask16& mask) {
+    _mm512_mask_i32scatter_epi32(base, mask.k, index.zmm, zmm, sizeof(Value));
+  }
+
+  // misc
+  void zero() { zmm = _mm512_setzero_si512(); }
+
+  // compound ops, no implicit conversion needed for lhs
+  vec16i& operator+=(const vec16i& rhs) {
+    zmm = _mm512_add_epi32(zmm, rhs.zmm);
+    return *this;
+  }
+
+  vec16i& operator-=(const vec16i& rhs) {
+    zmm = _mm512_sub_epi32(zmm, rhs.zmm);
+    return *this;
+  }
+
+  // lane-wise, low 32 bits of the products
+  vec16i& operator*=(const vec16i& rhs) {
+    zmm = _mm512_mullo_epi32(zmm, rhs.zmm);
+    return *this;
+  }
+
+  vec16i& operator|=(const vec16i& rhs) {
+    zmm = _mm512_or_si512(zmm, rhs.zmm);
+    return *this;
+  }
+
+  vec16i& operator&=(const vec16i& rhs) {
+    zmm = _mm512_and_si512(zmm, rhs.zmm);
+    return *this;
+  }
+
+  vec16i& operator^=(const vec16i& rhs) {
+    zmm = _mm512_xor_si512(zmm, rhs.zmm);
+    return *this;
+  }
+
+  // subscript; through a may_alias lane type, GCC folds integer intrinsics to long long vectors, see VecBase.h
+  typedef Value __attribute__((__may_alias__)) Lane;
+
+  Lane& operator[](std::size_t index) {
+    assert(index < Size);
+    return *(reinterpret_cast<Lane*>(&zmm) + index);
+  }
+
+  const Lane& operator[](std::size_t index) const {
+    assert(index < Size);
+    return *(reinterpret_cast<const Lane*>(&zmm) + index);
+  }
+};
+
+
+// free standing functions, participate in implicit conversion for lhs and rhs
+inline vec16i operator+(const vec16i& lhs, const vec16i& rhs) { return {_mm512_add_epi32(lhs.zmm, rhs.zmm)}; }
+inline vec16i operator-(const vec16i& lhs, const vec16i& rhs) { return {_mm512_sub_epi32(lhs.zmm, rhs.zmm)}; }
+// lane-wise, low 32 bits of the products
+inline vec16i operator*(const vec16i& lhs, const vec16i& rhs) { return {_mm512_mullo_epi32(lhs.zmm, rhs.zmm)}; }
+
+inline vec16i operator|(const vec16i& lhs, const vec16i& rhs) { return {_mm512_or_si512(lhs.zmm, rhs.zmm)}; }
+inline vec16i operator&(const vec16i& lhs, const vec16i& rhs) { return {_mm512_and_si512(lhs.zmm, rhs.zmm)}; }
+inline vec16i operator^(const vec16i& lhs, const vec16i& rhs) { return {_mm512_xor_si512(lhs.zmm, rhs.zmm)}; }
+
+// unary
+inline vec16i operator~(const vec16i& x) { return {_mm512_xor_si512(x.zmm, _mm512_set1_epi32(-1))}; }
+inline vec16i operator-(const vec16i& x) { return {_mm512_sub_epi32(_mm512_setzero_si512(), x.zmm)}; }
+
+// zero extend; see explicit shifting functions below
+inline vec16i operator<<(const vec16i& lhs, const vec16i& rhs) { return {_mm512_maskz_sllv_epi32(0xFFFF, lhs.zmm, rhs.zmm)}; }
+inline vec16i operator>>(const vec16i& lhs, const vec16i& rhs) { return {_mm512_maskz_srlv_epi32(0xFFFF, lhs.zmm, rhs.zmm)}; }
+
+inline mask16 operator==(const vec16i& lhs, const vec16i& rhs) { return {_mm512_cmpeq_epi32_mask(lhs.zmm, rhs.zmm)}; }
+inline mask16 operator!=(const vec16i& lhs, const vec16i& rhs) { return {_mm512_cmpneq_epi32_mask(lhs.zmm, rhs.zmm)}; }
+inline mask16 operator<(const vec16i& lhs, const vec16i& rhs) { return {_mm512_cmplt_epi32_mask(lhs.zmm, rhs.zmm)}; }
+inline mask16 operator>(const vec16i& lhs, const vec16i& rhs) { return {_mm512_cmpgt_epi32_mask(lhs.zmm, rhs.zmm)}; }
+inline mask16 operator<=(const vec16i& lhs, const vec16i& rhs) { return {_mm512_cmple_epi32_mask(lhs.zmm, rhs.zmm)}; }
+inline mask16 operator>=(const vec16i& lhs, const vec16i& rhs) { return {_mm512_cmpge_epi32_mask(lhs.zmm, rhs.zmm)}; }
+
+
+// explicit shifting
+template <int ShiftMask8Bit>
+inline vec16i shiftRightZeroExtend(const vec16i& x) { return {_mm512_maskz_srli_epi32(0xFFFF, x.zmm, ShiftMask8Bit)}; }
+
+template <int ShiftMask8Bit>
+inline vec16i shiftLeftZeroExtend(const vec16i& x) { return {_mm512_maskz_slli_epi32(0xFFFF, x.zmm, ShiftMask8Bit)}; }
+
+template <int ShiftMask8Bit>
+inline vec16i shiftRightSignExtend(const vec16i& x) { return {_mm512_maskz_srai_epi32(0xFFFF, x.zmm, ShiftMask8Bit)}; }
+
+
+// masked operations: lanes in the mask are computed, the others are taken from src
+inline vec16i blend(const vec16i& lhs, const vec16i& rhs, const mask16& mask) { return {_mm512_mask_blend_epi32(mask.k, lhs.zmm, rhs.zmm)}; }
+inline vec16i zeroMasked(const vec16i& x, const mask16& mask) { return {_mm512_maskz_mov_epi32(mask.k, x.zmm)}; }
+
+inline vec16i addMasked(const vec16i& src, const mask16& mask, const vec16i& lhs, const vec16i& rhs) {
+  return {_mm512_mask_add_epi32(src.zmm, mask.k, lhs.zmm, rhs.zmm)};
+}
+
+inline vec16i subMasked(const vec16i& src, const mask16& mask, const vec16i& lhs, const vec16i& rhs) {
+  return {_mm512_mask_sub_epi32(src.zmm, mask.k, lhs.zmm, rhs.zmm)};
+}
+
+inline vec16i mulMasked(const vec16i& src, const mask16& mask, const vec16i& lhs, const vec16i& rhs) {
+  return {_mm512_mask_mullo_epi32(src.zmm, mask.k, lhs.zmm, rhs.zmm)};
+}
+
+// the lanes in the mask moved to the front in lane order, the rest zero; expand is the inverse
+inline vec16i compress(const vec16i& x, const mask16& mask) { return {_mm512_maskz_compress_epi32(mask.k, x.zmm)}; }
+inline vec16i expand(const vec16i& x, const mask16& mask) { return {_mm512_maskz_expand_epi32(mask.k, x.zmm)}; }
+
+
+// misc
+// lane i = x[index[i] % 16], across the whole register
+inline vec16i permute(const vec16i& x, const vec16i& index) { return {_mm512_maskz_permutexvar_epi32(0xFFFF, index.zmm, x.zmm)}; }
+
+inline vec16i unpackHigh(const vec16i& lhs, const vec16i& rhs) { return {_mm512_maskz_unpackhi_epi32(0xFFFF, lhs.zmm, rhs.zmm)}; }
+inline vec16i unpackLow(const vec16i& lhs, const vec16i& rhs) { return {_mm512_maskz_unpacklo_epi32(0xFFFF, lhs.zmm, rhs.zmm)}; }
+
+// lanes 0-7 resp. 8-15 as vec8i, and back
+inline vec8i low(const vec16i& x) { return {_mm512_maskz_extracti64x4_epi64(0xFF, x.zmm, 0)}; }
+inline vec8i high(const vec16i& x) { return {_mm512_maskz_extracti64x4_epi64(0xFF, x.zmm, 1)}; }
+inline vec16i combine(const vec8i& low, const vec8i& high) {
+  return {_mm512_maskz_inserti64x4(0xFF, _mm512_castsi256_si512(low.ymm), high.ymm, 1)};
+}
+
+
+// math
+inline vec16i min(const vec16i& lhs, const vec16i& rhs) { return {_mm512_maskz_min_epi32(0xFFFF, lhs.zmm, rhs.zmm)}; }
+inline vec16i max(const vec16i& lhs, const vec16i& rhs) { return {_mm512_maskz_max_epi32(0xFFFF, lhs.zmm, rhs.zmm)}; }
+
+inline vec16i abs(const vec16i& x) { return {_mm512_maskz_abs_epi32(0xFFFF, x.zmm)}; }
+
+// full reductions of all sixteen lanes to a scalar, halving to vec8i first
+inline vec16i::Value hSum(const vec16i& x) { return hSum(low(x) + high(x)); }
+inline vec16i::Value hMin(const vec16i& x) { return hMin(min(low(x), high(x))); }
+inline vec16i::Value hMax(const vec16i& x) { return hMax(max(low(x), high(x))); }
+}
+}
@@ -0,0 +1,215 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include "VecBase.h"
+#include "Vec8Int.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// 16 bit samples, e.g. audio or sensor data: twice the lanes of vec8i per instruction. Lanes are signed, the
+// ...Unsigned functions treat them as unsigned 16 bit integers instead.
+using vec16s = vec<std::int16_t, 16u>;
+
+template <>
+struct vec<std::int16_t, 16u> final {
+  using Value = std::int16_t;
+  static const constexpr std::size_t Size = 16u;
+
+  // thin abstraction; instead of explicit conversion operator and the need for static-casting, just use .ymm
+  __m256i ymm;
+
+  // zero rather than _mm256_undefined_si256, see vec8f
+  vec() : ymm(_mm256_setzero_si256()) {}
+  vec(__m256i x) : ymm(x) {}
+  vec(Value scalar) { load(scalar); }
+  vec(const Value* first, const Value* last) { load(first, last); }
+
+  // load
+  void load(Value scalar) { ymm = _mm256_set1_epi16(scalar); }
+
+  void load(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    ymm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+  }
+
+  void load_aligned(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    ymm = _mm256_load_si256(reinterpret_cast<const __m256i*>(first));
+  }
+
+  // store; there are no masked loads and stores for 16 bit lanes before AVX-512
+  void store(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(first), ymm);
+  }
+
+  void store_aligned(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(first), ymm);
+  }
+
+  void store_aligned_stream(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(first), ymm);
+  }
+
+  // misc
+  void zero() { ymm = _mm256_setzero_si256(); }
+
+  // compound ops, no implicit conversion needed for lhs
+  vec16s& operator+=(const vec16s& rhs) {
+    ymm = _mm256_add_epi16(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec16s& operator-=(const vec16s& rhs) {
+    ymm = _mm256_sub_epi16(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec16s& operator*=(const vec16s& rhs) {
+    ymm = _mm256_mullo_epi16(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec16s& operator|=(const vec16s& rhs) {
+    ymm = _mm256_or_si256(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec16s& operator&=(const vec16s& rhs) {
+    ymm = _mm256_and_si256(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec16s& operator^=(const vec16s& rhs) {
+    ymm = _mm256_xor_si256(ymm, rhs.ymm);
+    return *this;
+  }
+
+  // subscript; through a may_alias lane type, GCC folds integer intrinsics to long long vectors, see VecBase.h
+  typedef Value __attribute__((__may_alias__)) Lane;
+
+  Lane& operator[](std::size_t index) {
+    assert(index < Size);
+    return *(reinterpret_cast<Lane*>(&ymm) + index);
+  }
+
+  const Lane& operator[](std::size_t index) const {
+    assert(index < Size);
+    return *(reinterpret_cast<const Lane*>(&ymm) + index);
+  }
+};
+
+
+// free standing functions, participate in implicit conversion for lhs and rhs; + - * wrap around
+inline vec16s operator+(const vec16s& lhs, const vec16s& rhs) { return {_mm256_add_epi16(lhs.ymm, rhs.ymm)}; }
+inline vec16s operator-(const vec16s& lhs, const vec16s& rhs) { return {_mm256_sub_epi16(lhs.ymm, rhs.ymm)}; }
+inline vec16s operator*(const vec16s& lhs, const vec16s& rhs) { return {_mm256_mullo_epi16(lhs.ymm, rhs.ymm)}; }
+
+inline vec16s operator|(const vec16s& lhs, const vec16s& rhs) { return {_mm256_or_si256(lhs.ymm, rhs.ymm)}; }
+inline vec16s operator&(const vec16s& lhs, const vec16s& rhs) { return {_mm256_and_si256(lhs.ymm, rhs.ymm)}; }
+inline vec16s operator^(const vec16s& lhs, const vec16s& rhs) { return {_mm256_xor_si256(lhs.ymm, rhs.ymm)}; }
+
+// unary
+inline vec16s operator~(const vec16s& x) { return {_mm256_xor_si256(x.ymm, _mm256_set1_epi16(-1))}; }
+inline vec16s operator-(const vec16s& x) { return {_mm256_sub_epi16(_mm256_setzero_si256(), x.ymm)}; }
+
+inline vec16s operator==(const vec16s& lhs, const vec16s& rhs) { return {_mm256_cmpeq_epi16(lhs.ymm, rhs.ymm)}; }
+inline vec16s operator>(const vec16s& lhs, const vec16s& rhs) { return {_mm256_cmpgt_epi16(lhs.ymm, rhs.ymm)}; }
+
+inline vec16s operator!=(const vec16s& lhs, const vec16s& rhs) { return ~(lhs == rhs); }
+inline vec16s operator<(const vec16s& lhs, const vec16s& rhs) { return rhs > lhs; }
+inline vec16s operator>=(const vec16s& lhs, const vec16s& rhs) { return ~(lhs < rhs); }
+inline vec16s operator<=(const vec16s& lhs, const vec16s& rhs) { return ~(lhs > rhs); }
+
+
+// saturating arithmetic: clamps to [-32768, 32767] resp. [0, 65535] instead of wrapping around
+inline vec16s addSaturate(const vec16s& lhs, const vec16s& rhs) { return {_mm256_adds_epi16(lhs.ymm, rhs.ymm)}; }
+inline vec16s subSaturate(const vec16s& lhs, const vec16s& rhs) { return {_mm256_subs_epi16(lhs.ymm, rhs.ymm)}; }
+inline vec16s addSaturateUnsigned(const vec16s& lhs, const vec16s& rhs) { return {_mm256_adds_epu16(lhs.ymm, rhs.ymm)}; }
+inline vec16s subSaturateUnsigned(const vec16s& lhs, const vec16s& rhs) { return {_mm256_subs_epu16(lhs.ymm, rhs.ymm)}; }
+
+// high 16 bits of the 32 bit products
+inline vec16s mulHi(const vec16s& lhs, const vec16s& rhs) { return {_mm256_mulhi_epi16(lhs.ymm, rhs.ymm)}; }
+inline vec16s mulHiUnsigned(const vec16s& lhs, const vec16s& rhs) { return {_mm256_mulhi_epu16(lhs.ymm, rhs.ymm)}; }
+
+// Q15 fixed point multiply, (lhs * rhs + 2^14) >> 15: e.g. samples scaled by a gain in [-1, 1)
+inline vec16s mulFixedPoint(const vec16s& lhs, const vec16s& rhs) { return {_mm256_mulhrs_epi16(lhs.ymm, rhs.ymm)}; }
+
+// lane i of the vec8i = lhs[2i] * rhs[2i] + lhs[2i + 1] * rhs[2i + 1]; the building block for int16 dot products
+inline vec8i mulAddPairs(const vec16s& lhs, const vec16s& rhs) { return {_mm256_madd_epi16(lhs.ymm, rhs.ymm)}; }
+
+
+// explicit shifting
+template <int ShiftMask8Bit>
+inline vec16s shiftRightZeroExtend(const vec16s& x) { return {_mm256_srli_epi16(x.ymm, ShiftMask8Bit)}; }
+
+template <int ShiftMask8Bit>
+inline vec16s shiftLeftZeroExtend(const vec16s& x) { return {_mm256_slli_epi16(x.ymm, ShiftMask8Bit)}; }
+
+template <int ShiftMask8Bit>
+inline vec16s shiftRightSignExtend(const vec16s& x) { return {_mm256_srai_epi16(x.ymm, ShiftMask8Bit)}; }
+
+
+// misc
+// the same 8 bit mask for both 128 bit lanes
+template <int BlendMask8Bit>
+inline vec16s blend(const vec16s& lhs, const vec16s& rhs) { return {_mm256_blend_epi16(lhs.ymm, rhs.ymm, BlendMask8Bit)}; }
+// byte-wise; mask lanes have to be all ones or all zeros, as comparisons produce them
+inline vec16s blend(const vec16s& lhs, const vec16s& rhs, const vec16s& mask) { return {_mm256_blendv_epi8(lhs.ymm, rhs.ymm, mask.ymm)}; }
+
+inline vec16s unpackHigh(const vec16s& lhs, const vec16s& rhs) { return {_mm256_unpackhi_epi16(lhs.ymm, rhs.ymm)}; }
+inline vec16s unpackLow(const vec16s& lhs, const vec16s& rhs) { return {_mm256_unpacklo_epi16(lhs.ymm, rhs.ymm)}; }
+
+
+// math
+inline vec16s min(const vec16s& lhs, const vec16s& rhs) { return {_mm256_min_epi16(lhs.ymm, rhs.ymm)}; }
+inline vec16s max(const vec16s& lhs, const vec16s& rhs) { return {_mm256_max_epi16(lhs.ymm, rhs.ymm)}; }
+inline vec16s minUnsigned(const vec16s& lhs, const vec16s& rhs) { return {_mm256_min_epu16(lhs.ymm, rhs.ymm)}; }
+inline vec16s maxUnsigned(const vec16s& lhs, const vec16s& rhs) { return {_mm256_max_epu16(lhs.ymm, rhs.ymm)}; }
+
+inline vec16s abs(const vec16s& x) { return {_mm256_abs_epi16(x.ymm)}; }
+
+// (lhs + rhs + 1) >> 1 without overflow
+inline vec16s averageUnsigned(const vec16s& lhs, const vec16s& rhs) { return {_mm256_avg_epu16(lhs.ymm, rhs.ymm)}; }
+
+// horizontal operations; use if you have to
+inline vec16s hAdd(const vec16s& lhs, const vec16s& rhs) { return {_mm256_hadd_epi16(lhs.ymm, rhs.ymm)}; }
+inline vec16s hAddSaturate(const vec16s& lhs, const vec16s& rhs) { return {_mm256_hadds_epi16(lhs.ymm, rhs.ymm)}; }
+
+// full reduction of all sixteen lanes to a scalar, widened to 32 bit so that it does not overflow
+inline vec8i::Value hSum(const vec16s& x) { return hSum(mulAddPairs(x, vec16s{1})); }
+
+// masks; one bit per lane, from the lane's sign bit
+inline int moveMask(const vec16s& x) {
+  const auto bytes = _mm256_permute4x64_epi64(_mm256_packs_epi16(x.ymm, x.ymm), 0xD8);
+  return _mm256_movemask_epi8(bytes) & 0xFFFF;
+}
+
+// tests
+inline bool isZFlagSet(const vec16s& lhs, const vec16s& rhs) { return _mm256_testz_si256(lhs.ymm, rhs.ymm) != 0; }
+inline bool isCFlagSet(const vec16s& lhs, const vec16s& rhs) { return _mm256_testc_si256(lhs.ymm, rhs.ymm) != 0; }
+
+
+// widen resp. narrow between vec16s and vec8i; Low and High are lanes 0-7 resp. 8-15 of the vec16s.
+// vpacks* packs within 128 bit lanes, narrow permutes the result back into lane order.
+inline vec8i widenLow(const vec16s& x) { return {_mm256_cvtepi16_epi32(_mm256_castsi256_si128(x.ymm))}; }
+inline vec8i widenHigh(const vec16s& x) { return {_mm256_cvtepi16_epi32(_mm256_extracti128_si256(x.ymm, 1))}; }
+inline vec8i widenLowUnsigned(const vec16s& x) { return {_mm256_cvtepu16_epi32(_mm256_castsi256_si128(x.ymm))}; }
+inline vec8i widenHighUnsigned(const vec16s& x) { return {_mm256_cvtepu16_epi32(_mm256_extracti128_si256(x.ymm, 1))}; }
+
+// saturating to [-32768, 32767] resp. [0, 65535]
+inline vec16s narrow(const vec8i& low, const vec8i& high) {
+  return {_mm256_permute4x64_epi64(_mm256_packs_epi32(low.ymm, high.ymm), 0xD8)};
+}
+
+inline vec16s narrowUnsigned(const vec8i& low, const vec8i& high) {
+  return {_mm256_permute4x64_epi64(_mm256_packus_epi32(low.ymm, high.ymm), 0xD8)};
+}
+}
+}
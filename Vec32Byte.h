@@ -0,0 +1,195 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include "VecBase.h"
+#include "Vec16Short.h"
+#include "Vec4Long.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// bytes, e.g. pixels, text or packed flags: four times the lanes of vec8i per instruction. Lanes are signed, the
+// ...Unsigned functions treat them as uint8_t instead; loads and stores from uint8_t go through reinterpret_cast.
+using vec32b = vec<std::int8_t, 32u>;
+
+template <>
+struct vec<std::int8_t, 32u> final {
+  using Value = std::int8_t;
+  static const constexpr std::size_t Size = 32u;
+
+  // thin abstraction; instead of explicit conversion operator and the need for static-casting, just use .ymm
+  __m256i ymm;
+
+  // zero rather than _mm256_undefined_si256, see vec8f
+  vec() : ymm(_mm256_setzero_si256()) {}
+  vec(__m256i x) : ymm(x) {}
+  vec(Value scalar) { load(scalar); }
+  vec(const Value* first, const Value* last) { load(first, last); }
+
+  // load
+  void load(Value scalar) { ymm = _mm256_set1_epi8(scalar); }
+
+  void load(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    ymm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+  }
+
+  void load_aligned(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    ymm = _mm256_load_si256(reinterpret_cast<const __m256i*>(first));
+  }
+
+  // store; there are no masked loads and stores for 8 bit lanes before AVX-512
+  void store(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(first), ymm);
+  }
+
+  void store_aligned(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(first), ymm);
+  }
+
+  void store_aligned_stream(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(first), ymm);
+  }
+
+  // misc
+  void zero() { ymm = _mm256_setzero_si256(); }
+
+  // compound ops, no implicit conversion needed for lhs
+  vec32b& operator+=(const vec32b& rhs) {
+    ymm = _mm256_add_epi8(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec32b& operator-=(const vec32b& rhs) {
+    ymm = _mm256_sub_epi8(ymm, rhs.ymm);
+    return *this;
+  }
+
+  // there is no 8 bit multiply, widen to vec16s first
+
+  vec32b& operator|=(const vec32b& rhs) {
+    ymm = _mm256_or_si256(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec32b& operator&=(const vec32b& rhs) {
+    ymm = _mm256_and_si256(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec32b& operator^=(const vec32b& rhs) {
+    ymm = _mm256_xor_si256(ymm, rhs.ymm);
+    return *this;
+  }
+
+  // subscript; through a may_alias lane type, GCC folds integer intrinsics to long long vectors, see VecBase.h
+  typedef Value __attribute__((__may_alias__)) Lane;
+
+  Lane& operator[](std::size_t index) {
+    assert(index < Size);
+    return *(reinterpret_cast<Lane*>(&ymm) + index);
+  }
+
+  const Lane& operator[](std::size_t index) const {
+    assert(index < Size);
+    return *(reinterpret_cast<const Lane*>(&ymm) + index);
+  }
+};
+
+
+// free standing functions, participate in implicit conversion for lhs and rhs; + - wrap around
+inline vec32b operator+(const vec32b& lhs, const vec32b& rhs) { return {_mm256_add_epi8(lhs.ymm, rhs.ymm)}; }
+inline vec32b operator-(const vec32b& lhs, const vec32b& rhs) { return {_mm256_sub_epi8(lhs.ymm, rhs.ymm)}; }
+
+inline vec32b operator|(const vec32b& lhs, const vec32b& rhs) { return {_mm256_or_si256(lhs.ymm, rhs.ymm)}; }
+inline vec32b operator&(const vec32b& lhs, const vec32b& rhs) { return {_mm256_and_si256(lhs.ymm, rhs.ymm)}; }
+inline vec32b operator^(const vec32b& lhs, const vec32b& rhs) { return {_mm256_xor_si256(lhs.ymm, rhs.ymm)}; }
+
+// unary
+inline vec32b operator~(const vec32b& x) { return {_mm256_xor_si256(x.ymm, _mm256_set1_epi8(-1))}; }
+inline vec32b operator-(const vec32b& x) { return {_mm256_sub_epi8(_mm256_setzero_si256(), x.ymm)}; }
+
+inline vec32b operator==(const vec32b& lhs, const vec32b& rhs) { return {_mm256_cmpeq_epi8(lhs.ymm, rhs.ymm)}; }
+inline vec32b operator>(const vec32b& lhs, const vec32b& rhs) { return {_mm256_cmpgt_epi8(lhs.ymm, rhs.ymm)}; }
+
+inline vec32b operator!=(const vec32b& lhs, const vec32b& rhs) { return ~(lhs == rhs); }
+inline vec32b operator<(const vec32b& lhs, const vec32b& rhs) { return rhs > lhs; }
+inline vec32b operator>=(const vec32b& lhs, const vec32b& rhs) { return ~(lhs < rhs); }
+inline vec32b operator<=(const vec32b& lhs, const vec32b& rhs) { return ~(lhs > rhs); }
+
+// there is no unsigned compare, flipping the sign bits maps [0, 255] onto [-128, 127] in order
+inline vec32b greaterUnsigned(const vec32b& lhs, const vec32b& rhs) {
+  const auto flip = _mm256_set1_epi8(-128);
+  return {_mm256_cmpgt_epi8(_mm256_xor_si256(lhs.ymm, flip), _mm256_xor_si256(rhs.ymm, flip))};
+}
+
+
+// saturating arithmetic: clamps to [-128, 127] resp. [0, 255] instead of wrapping around
+inline vec32b addSaturate(const vec32b& lhs, const vec32b& rhs) { return {_mm256_adds_epi8(lhs.ymm, rhs.ymm)}; }
+inline vec32b subSaturate(const vec32b& lhs, const vec32b& rhs) { return {_mm256_subs_epi8(lhs.ymm, rhs.ymm)}; }
+inline vec32b addSaturateUnsigned(const vec32b& lhs, const vec32b& rhs) { return {_mm256_adds_epu8(lhs.ymm, rhs.ymm)}; }
+inline vec32b subSaturateUnsigned(const vec32b& lhs, const vec32b& rhs) { return {_mm256_subs_epu8(lhs.ymm, rhs.ymm)}; }
+
+
+// misc; there are no 8 bit shifts, shift a vec16s and mask
+// byte-wise; mask lanes have to be all ones or all zeros, as comparisons produce them
+inline vec32b blend(const vec32b& lhs, const vec32b& rhs, const vec32b& mask) { return {_mm256_blendv_epi8(lhs.ymm, rhs.ymm, mask.ymm)}; }
+
+// lane i = x[index[i] % 16] within each 128 bit lane, zero where index[i] has its sign bit set; a 16 entry table lookup
+inline vec32b shuffle(const vec32b& x, const vec32b& index) { return {_mm256_shuffle_epi8(x.ymm, index.ymm)}; }
+
+inline vec32b unpackHigh(const vec32b& lhs, const vec32b& rhs) { return {_mm256_unpackhi_epi8(lhs.ymm, rhs.ymm)}; }
+inline vec32b unpackLow(const vec32b& lhs, const vec32b& rhs) { return {_mm256_unpacklo_epi8(lhs.ymm, rhs.ymm)}; }
+
+
+// math
+inline vec32b min(const vec32b& lhs, const vec32b& rhs) { return {_mm256_min_epi8(lhs.ymm, rhs.ymm)}; }
+inline vec32b max(const vec32b& lhs, const vec32b& rhs) { return {_mm256_max_epi8(lhs.ymm, rhs.ymm)}; }
+inline vec32b minUnsigned(const vec32b& lhs, const vec32b& rhs) { return {_mm256_min_epu8(lhs.ymm, rhs.ymm)}; }
+inline vec32b maxUnsigned(const vec32b& lhs, const vec32b& rhs) { return {_mm256_max_epu8(lhs.ymm, rhs.ymm)}; }
+
+inline vec32b abs(const vec32b& x) { return {_mm256_abs_epi8(x.ymm)}; }
+
+// (lhs + rhs + 1) >> 1 without overflow
+inline vec32b averageUnsigned(const vec32b& lhs, const vec32b& rhs) { return {_mm256_avg_epu8(lhs.ymm, rhs.ymm)}; }
+
+// lane i of the vec4q = sum of |lhs[j] - rhs[j]| over bytes j = 8i .. 8i + 7, as unsigned
+inline vec4q sumAbsDiffUnsigned(const vec32b& lhs, const vec32b& rhs) { return {_mm256_sad_epu8(lhs.ymm, rhs.ymm)}; }
+
+// full reductions of all 32 lanes to a scalar, widened so that they do not overflow
+inline vec4q::Value hSumUnsigned(const vec32b& x) { return hSum(sumAbsDiffUnsigned(x, vec32b{})); }
+// flipping the sign bits adds 128 to each lane
+inline vec4q::Value hSum(const vec32b& x) { return hSumUnsigned(x ^ vec32b{-128}) - 128 * 32; }
+
+// masks; one bit per lane, from the lane's sign bit
+inline int moveMask(const vec32b& x) { return _mm256_movemask_epi8(x.ymm); }
+
+// tests
+inline bool isZFlagSet(const vec32b& lhs, const vec32b& rhs) { return _mm256_testz_si256(lhs.ymm, rhs.ymm) != 0; }
+inline bool isCFlagSet(const vec32b& lhs, const vec32b& rhs) { return _mm256_testc_si256(lhs.ymm, rhs.ymm) != 0; }
+
+
+// widen resp. narrow between vec32b and vec16s; Low and High are lanes 0-15 resp. 16-31 of the vec32b.
+// vpacks* packs within 128 bit lanes, narrow permutes the result back into lane order.
+inline vec16s widenLow(const vec32b& x) { return {_mm256_cvtepi8_epi16(_mm256_castsi256_si128(x.ymm))}; }
+inline vec16s widenHigh(const vec32b& x) { return {_mm256_cvtepi8_epi16(_mm256_extracti128_si256(x.ymm, 1))}; }
+inline vec16s widenLowUnsigned(const vec32b& x) { return {_mm256_cvtepu8_epi16(_mm256_castsi256_si128(x.ymm))}; }
+inline vec16s widenHighUnsigned(const vec32b& x) { return {_mm256_cvtepu8_epi16(_mm256_extracti128_si256(x.ymm, 1))}; }
+
+// saturating to [-128, 127] resp. [0, 255]
+inline vec32b narrow(const vec16s& low, const vec16s& high) {
+  return {_mm256_permute4x64_epi64(_mm256_packs_epi16(low.ymm, high.ymm), 0xD8)};
+}
+
+inline vec32b narrowUnsigned(const vec16s& low, const vec16s& high) {
+  return {_mm256_permute4x64_epi64(_mm256_packus_epi16(low.ymm, high.ymm), 0xD8)};
+}
+}
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <immintrin.h>
+#include "VecBase.h"
+#include "Vec8Int.h"
+#include "Vec8Float.h"
+#include "Vec4Long.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+using vec4d = vec<double, 4u>;
+
+template <>
+struct vec<double, 4u> final {
+  using Value = double;
+  static const constexpr std::size_t Size = 4u;
+
+  // thin abstraction; instead of explicit conversion operator and the need for static-casting, just use .ymm
+  __m256d ymm;
+
+  // zero rather than _mm256_undefined_pd, see vec8f
+  vec() : ymm(_mm256_setzero_pd()) {}
+  vec(__m256d x) : ymm(x) {}
+  vec(Value scalar) { load(scalar); }
+  vec(const Value* first, const Value* last) { load(first, last); }
+  vec(Value e3, Value e2, Value e1, Value e0) { load(e3, e2, e1, e0); }
+
+  // load
+  void load(Value scalar) { ymm = _mm256_set1_pd(scalar); }
+
+  void load(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    ymm = _mm256_loadu_pd(first);
+  }
+
+  void load_aligned(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    ymm = _mm256_load_pd(first);
+  }
+
+  void load(Value e3, Value e2, Value e1, Value e0) { ymm = _mm256_setr_pd(e3, e2, e1, e0); }
+
+  // lanes with the mask's sign bit set are loaded, others are zero; masked-out memory is never touched
+  void load_masked(const Value* first, const vec4q& mask) { ymm = _mm256_maskload_pd(first, mask.ymm); }
+
+  // AVX2, lane i = base[index[i]]; the indices are the low four lanes of a vec8i
+  void gather(const Value* base, const vec8i& index) {
+    ymm = _mm256_i32gather_pd(base, _mm256_castsi256_si128(index.ymm), sizeof(Value));
+  }
+
+  // store
+  void store(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_storeu_pd(first, ymm);
+  }
+
+  void store_aligned(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_store_pd(first, ymm);
+  }
+
+  void store_aligned_stream(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_stream_pd(first, ymm);
+  }
+
+  // only lanes with the mask's sign bit set are written
+  void store_masked(Value* first, const vec4q& mask) { _mm256_maskstore_pd(first, mask.ymm, ymm); }
+
+  // misc
+  void zero() { ymm = _mm256_setzero_pd(); }
+
+  // compound ops, no implicit conversion needed for lhs
+  vec4d& operator+=(const vec4d& rhs) {
+    ymm = _mm256_add_pd(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec4d& operator-=(const vec4d& rhs) {
+    ymm = _mm256_sub_pd(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec4d& operator*=(const vec4d& rhs) {
+    ymm = _mm256_mul_pd(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec4d& operator/=(const vec4d& rhs) {
+    ymm = _mm256_div_pd(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec4d& operator|=(const vec4d& rhs) {
+    ymm = _mm256_or_pd(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec4d& operator&=(const vec4d& rhs) {
+    ymm = _mm256_and_pd(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec4d& operator^=(const vec4d& rhs) {
+    ymm = _mm256_xor_pd(ymm, rhs.ymm);
+    return *this;
+  }
+
+  // subscript
+  Value& operator[](std::size_t index) {
+    assert(index < Size);
+    return ymm[index];
+  }
+
+  const Value& operator[](std::size_t index) const {
+    assert(index < Size);
+    return ymm[index];
+  }
+};
+
+
+// free standing functions, participate in implicit conversion for lhs and rhs
+inline vec4d operator+(const vec4d& lhs, const vec4d& rhs) { return {_mm256_add_pd(lhs.ymm, rhs.ymm)}; }
+inline vec4d operator-(const vec4d& lhs, const vec4d& rhs) { return {_mm256_sub_pd(lhs.ymm, rhs.ymm)}; }
+inline vec4d operator*(const vec4d& lhs, const vec4d& rhs) { return {_mm256_mul_pd(lhs.ymm, rhs.ymm)}; }
+inline vec4d operator/(const vec4d& lhs, const vec4d& rhs) { return {_mm256_div_pd(lhs.ymm, rhs.ymm)}; }
+
+inline vec4d operator|(const vec4d& lhs, const vec4d& rhs) { return {_mm256_or_pd(lhs.ymm, rhs.ymm)}; }
+inline vec4d operator&(const vec4d& lhs, const vec4d& rhs) { return {_mm256_and_pd(lhs.ymm, rhs.ymm)}; }
+inline vec4d operator^(const vec4d& lhs, const vec4d& rhs) { return {_mm256_xor_pd(lhs.ymm, rhs.ymm)}; }
+
+// unary
+inline vec4d operator~(const vec4d& x) { return {_mm256_xor_pd(x.ymm, _mm256_castsi256_pd(_mm256_set1_epi64x(-1)))}; }
+inline vec4d operator-(const vec4d& x) { return {_mm256_xor_pd(x.ymm, _mm256_set1_pd(-0.))}; }
+
+
+// predicates as for vec8f
+template <int ComparisonMask8Bit>
+inline vec4d compare(const vec4d& lhs, const vec4d& rhs) { return _mm256_cmp_pd(lhs.ymm, rhs.ymm, ComparisonMask8Bit); }
+
+inline vec4d operator==(const vec4d& lhs, const vec4d& rhs) { return compare<0>(lhs, rhs); }
+inline vec4d operator!=(const vec4d& lhs, const vec4d& rhs) { return compare<4>(lhs, rhs); }
+inline vec4d operator<(const vec4d& lhs, const vec4d& rhs) { return compare<1>(lhs, rhs); }
+inline vec4d operator>(const vec4d& lhs, const vec4d& rhs) { return compare<14>(lhs, rhs); }
+inline vec4d operator<=(const vec4d& lhs, const vec4d& rhs) { return compare<2>(lhs, rhs); }
+inline vec4d operator>=(const vec4d& lhs, const vec4d& rhs) { return compare<13>(lhs, rhs); }
+
+
+// misc
+template <int BlendMask4Bit>
+inline vec4d blend(const vec4d& lhs, const vec4d& rhs) { return {_mm256_blend_pd(lhs.ymm, rhs.ymm, BlendMask4Bit)}; }
+inline vec4d blend(const vec4d& lhs, const vec4d& rhs, const vec4d& mask) { return {_mm256_blendv_pd(lhs.ymm, rhs.ymm, mask.ymm)}; }
+inline vec4d blend(const vec4d& lhs, const vec4d& rhs, const vec4q& mask) {
+  return {_mm256_blendv_pd(lhs.ymm, rhs.ymm, _mm256_castsi256_pd(mask.ymm))};
+}
+
+// AVX2, lane i = x[(PermuteMask8Bit >> 2i) & 3], across 128 bit lanes
+template <int PermuteMask8Bit>
+inline vec4d permute(const vec4d& x) { return {_mm256_permute4x64_pd(x.ymm, PermuteMask8Bit)}; }
+
+template <int ShuffleMask4Bit>
+inline vec4d shuffle(const vec4d& lhs, const vec4d& rhs) { return {_mm256_shuffle_pd(lhs.ymm, rhs.ymm, ShuffleMask4Bit)}; }
+
+inline vec4d unpackHigh(const vec4d& lhs, const vec4d& rhs) { return {_mm256_unpackhi_pd(lhs.ymm, rhs.ymm)}; }
+inline vec4d unpackLow(const vec4d& lhs, const vec4d& rhs) { return {_mm256_unpacklo_pd(lhs.ymm, rhs.ymm)}; }
+
+
+// conversions; reinterpret keeps the bits as they are, there is no int64 <-> double conversion before AVX-512
+inline vec4q reinterpret(const vec4d& x) { return {_mm256_castpd_si256(x.ymm)}; }
+inline vec4d reinterpret(const vec4q& x) { return {_mm256_castsi256_pd(x.ymm)}; }
+
+// widen resp. narrow between vec8f and vec4d; Low and High are lanes 0-3 resp. 4-7 of the vec8f, widening is exact
+inline vec4d widenLow(const vec8f& x) { return {_mm256_cvtps_pd(_mm256_castps256_ps128(x.ymm))}; }
+inline vec4d widenHigh(const vec8f& x) { return {_mm256_cvtps_pd(_mm256_extractf128_ps(x.ymm, 1))}; }
+
+inline vec8f narrow(const vec4d& low, const vec4d& high) {
+  return {_mm256_insertf128_ps(_mm256_castps128_ps256(_mm256_cvtpd_ps(low.ymm)), _mm256_cvtpd_ps(high.ymm), 1)};
+}
+
+// vec8i lanes 0-3 resp. 4-7, exact; and back, rounding according to MXCSR resp. truncating
+inline vec4d convertLow(const vec8i& x) { return {_mm256_cvtepi32_pd(_mm256_castsi256_si128(x.ymm))}; }
+inline vec4d convertHigh(const vec8i& x) { return {_mm256_cvtepi32_pd(_mm256_extracti128_si256(x.ymm, 1))}; }
+
+inline vec8i convert(const vec4d& low, const vec4d& high) {
+  return {_mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvtpd_epi32(low.ymm)), _mm256_cvtpd_epi32(high.ymm), 1)};
+}
+
+inline vec8i convertTruncate(const vec4d& low, const vec4d& high) {
+  return {_mm256_inserti128_si256(_mm256_castsi128_si256(_mm256_cvttpd_epi32(low.ymm)), _mm256_cvttpd_epi32(high.ymm), 1)};
+}
+
+
+// math
+inline vec4d ceil(const vec4d& x) { return {_mm256_ceil_pd(x.ymm)}; }
+inline vec4d floor(const vec4d& x) { return {_mm256_floor_pd(x.ymm)}; }
+
+template <int RoundingMode = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC>
+inline vec4d round(const vec4d& x) { return {_mm256_round_pd(x.ymm, RoundingMode)}; }
+
+inline vec4d min(const vec4d& lhs, const vec4d& rhs) { return {_mm256_min_pd(lhs.ymm, rhs.ymm)}; }
+inline vec4d max(const vec4d& lhs, const vec4d& rhs) { return {_mm256_max_pd(lhs.ymm, rhs.ymm)}; }
+
+inline vec4d abs(const vec4d& x) { return {_mm256_andnot_pd(_mm256_set1_pd(-0.), x.ymm)}; }
+
+inline vec4d sqrt(const vec4d& x) { return {_mm256_sqrt_pd(x.ymm)}; }
+
+inline vec4d addSub(const vec4d& lhs, const vec4d& rhs) { return {_mm256_addsub_pd(lhs.ymm, rhs.ymm)}; }
+
+// horizontal operations; use if you have to
+inline vec4d hAdd(const vec4d& lhs, const vec4d& rhs) { return {_mm256_hadd_pd(lhs.ymm, rhs.ymm)}; }
+inline vec4d hSub(const vec4d& lhs, const vec4d& rhs) { return {_mm256_hsub_pd(lhs.ymm, rhs.ymm)}; }
+
+// full reductions of all four lanes to a scalar
+inline double hSum(const vec4d& x) {
+  const auto pair = _mm_add_pd(_mm256_castpd256_pd128(x.ymm), _mm256_extractf128_pd(x.ymm, 1));
+  return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+inline double hMin(const vec4d& x) {
+  const auto pair = _mm_min_pd(_mm256_castpd256_pd128(x.ymm), _mm256_extractf128_pd(x.ymm, 1));
+  return _mm_cvtsd_f64(_mm_min_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+inline double hMax(const vec4d& x) {
+  const auto pair = _mm_max_pd(_mm256_castpd256_pd128(x.ymm), _mm256_extractf128_pd(x.ymm, 1));
+  return _mm_cvtsd_f64(_mm_max_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+// masks
+inline int moveMask(const vec4d& x) { return _mm256_movemask_pd(x.ymm); }
+
+// tests
+inline bool isZFlagSet(const vec4d& lhs, const vec4d& rhs) { return _mm256_testz_pd(lhs.ymm, rhs.ymm) != 0; }
+inline bool isCFlagSet(const vec4d& lhs, const vec4d& rhs) { return _mm256_testc_pd(lhs.ymm, rhs.ymm) != 0; }
+
+
+// FMA, as for vec8f
+inline vec4d fusedMulAdd(const vec4d& a, const vec4d& b, const vec4d& c) { return {_mm256_fmadd_pd(a.ymm, b.ymm, c.ymm)}; }
+inline vec4d fusedMulSub(const vec4d& a, const vec4d& b, const vec4d& c) { return {_mm256_fmsub_pd(a.ymm, b.ymm, c.ymm)}; }
+inline vec4d fusedMulNegateAdd(const vec4d& a, const vec4d& b, const vec4d& c) { return {_mm256_fnmadd_pd(a.ymm, b.ymm, c.ymm)}; }
+inline vec4d fusedMulNegateSub(const vec4d& a, const vec4d& b, const vec4d& c) { return {_mm256_fnmsub_pd(a.ymm, b.ymm, c.ymm)}; }
+}
+}
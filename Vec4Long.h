@@ -0,0 +1,216 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <immintrin.h>
+#include "VecBase.h"
+#include "Vec8Int.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+using vec4q = vec<std::int64_t, 4u>;
+
+template <>
+struct vec<std::int64_t, 4u> final {
+  using Value = std::int64_t;
+  static const constexpr std::size_t Size = 4u;
+
+  // thin abstraction; instead of explicit conversion operator and the need for static-casting, just use .ymm
+  __m256i ymm;
+
+  // zero rather than _mm256_undefined_si256, see vec8f
+  vec() : ymm(_mm256_setzero_si256()) {}
+  vec(__m256i x) : ymm(x) {}
+  vec(Value scalar) { load(scalar); }
+  vec(const Value* first, const Value* last) { load(first, last); }
+  vec(Value e3, Value e2, Value e1, Value e0) { load(e3, e2, e1, e0); }
+
+  // load
+  void load(Value scalar) { ymm = _mm256_set1_epi64x(scalar); }
+
+  void load(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    ymm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(first));
+  }
+
+  void load_aligned(const Value* first, const Value* last) {
+    assert(last - first == Size);
+    ymm = _mm256_load_si256(reinterpret_cast<const __m256i*>(first));
+  }
+
+  void load(Value e3, Value e2, Value e1, Value e0) { ymm = _mm256_setr_epi64x(e3, e2, e1, e0); }
+
+  // AVX2, lanes with the mask's sign bit set are loaded, others are zero; masked-out memory is never touched
+  void load_masked(const Value* first, const vec4q& mask) {
+    ymm = _mm256_maskload_epi64(reinterpret_cast<const long long*>(first), mask.ymm);
+  }
+
+  // store
+  void store(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(first), ymm);
+  }
+
+  void store_aligned(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(first), ymm);
+  }
+
+  void store_aligned_stream(Value* first, Value* last) {
+    assert(last - first == Size);
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(first), ymm);
+  }
+
+  // AVX2, only lanes with the mask's sign bit set are written
+  void store_masked(Value* first, const vec4q& mask) {
+    _mm256_maskstore_epi64(reinterpret_cast<long long*>(first), mask.ymm, ymm);
+  }
+
+  // misc
+  void zero() { ymm = _mm256_setzero_si256(); }
+
+  // compound ops, no implicit conversion needed for lhs
+  vec4q& operator+=(const vec4q& rhs) {
+    ymm = _mm256_add_epi64(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec4q& operator-=(const vec4q& rhs) {
+    ymm = _mm256_sub_epi64(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec4q& operator|=(const vec4q& rhs) {
+    ymm = _mm256_or_si256(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec4q& operator&=(const vec4q& rhs) {
+    ymm = _mm256_and_si256(ymm, rhs.ymm);
+    return *this;
+  }
+
+  vec4q& operator^=(const vec4q& rhs) {
+    ymm = _mm256_xor_si256(ymm, rhs.ymm);
+    return *this;
+  }
+
+  // subscript; through a may_alias lane type, GCC folds integer intrinsics to long long vectors, see VecBase.h
+  typedef Value __attribute__((__may_alias__)) Lane;
+
+  Lane& operator[](std::size_t index) {
+    assert(index < Size);
+    return *(reinterpret_cast<Lane*>(&ymm) + index);
+  }
+
+  const Lane& operator[](std::size_t index) const {
+    assert(index < Size);
+    return *(reinterpret_cast<const Lane*>(&ymm) + index);
+  }
+};
+
+
+// free standing functions, participate in implicit conversion for lhs and rhs
+inline vec4q operator+(const vec4q& lhs, const vec4q& rhs) { return {_mm256_add_epi64(lhs.ymm, rhs.ymm)}; }
+inline vec4q operator-(const vec4q& lhs, const vec4q& rhs) { return {_mm256_sub_epi64(lhs.ymm, rhs.ymm)}; }
+
+// low 64 bits of the products; vpmullq is AVX-512, here from three 32x32 -> 64 bit multiplies
+inline vec4q operator*(const vec4q& lhs, const vec4q& rhs) {
+  const auto low = _mm256_mul_epu32(lhs.ymm, rhs.ymm);
+  const auto cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(lhs.ymm, 32), rhs.ymm),
+                                      _mm256_mul_epu32(lhs.ymm, _mm256_srli_epi64(rhs.ymm, 32)));
+  return {_mm256_add_epi64(low, _mm256_slli_epi64(cross, 32))};
+}
+
+inline vec4q operator|(const vec4q& lhs, const vec4q& rhs) { return {_mm256_or_si256(lhs.ymm, rhs.ymm)}; }
+inline vec4q operator&(const vec4q& lhs, const vec4q& rhs) { return {_mm256_and_si256(lhs.ymm, rhs.ymm)}; }
+inline vec4q operator^(const vec4q& lhs, const vec4q& rhs) { return {_mm256_xor_si256(lhs.ymm, rhs.ymm)}; }
+
+// unary
+inline vec4q operator~(const vec4q& x) { return {_mm256_xor_si256(x.ymm, _mm256_set1_epi64x(-1))}; }
+inline vec4q operator-(const vec4q& x) { return {_mm256_sub_epi64(_mm256_setzero_si256(), x.ymm)}; }
+
+// zero extend; see explicit shifting functions below
+inline vec4q operator<<(const vec4q& lhs, const vec4q& rhs) { return {_mm256_sllv_epi64(lhs.ymm, rhs.ymm)}; }
+inline vec4q operator>>(const vec4q& lhs, const vec4q& rhs) { return {_mm256_srlv_epi64(lhs.ymm, rhs.ymm)}; }
+
+inline vec4q operator==(const vec4q& lhs, const vec4q& rhs) { return {_mm256_cmpeq_epi64(lhs.ymm, rhs.ymm)}; }
+inline vec4q operator>(const vec4q& lhs, const vec4q& rhs) { return {_mm256_cmpgt_epi64(lhs.ymm, rhs.ymm)}; }
+
+inline vec4q operator!=(const vec4q& lhs, const vec4q& rhs) { return ~(lhs == rhs); }
+inline vec4q operator<(const vec4q& lhs, const vec4q& rhs) { return rhs > lhs; }
+inline vec4q operator>=(const vec4q& lhs, const vec4q& rhs) { return ~(lhs < rhs); }
+inline vec4q operator<=(const vec4q& lhs, const vec4q& rhs) { return ~(lhs > rhs); }
+
+
+// explicit shifting
+template <int ShiftMask8Bit>
+inline vec4q shiftRightZeroExtend(const vec4q& x) { return {_mm256_srli_epi64(x.ymm, ShiftMask8Bit)}; }
+
+template <int ShiftMask8Bit>
+inline vec4q shiftLeftZeroExtend(const vec4q& x) { return {_mm256_slli_epi64(x.ymm, ShiftMask8Bit)}; }
+
+// vpsraq is AVX-512: zero extending shift, the sign shifted in from an all ones resp. all zeros lane
+template <int ShiftMask8Bit>
+inline vec4q shiftRightSignExtend(const vec4q& x) {
+  const auto sign = _mm256_cmpgt_epi64(_mm256_setzero_si256(), x.ymm);
+  return {_mm256_or_si256(_mm256_srli_epi64(x.ymm, ShiftMask8Bit), _mm256_slli_epi64(sign, 64 - ShiftMask8Bit))};
+}
+
+
+// misc
+// 32 bit granularity, i.e. two mask bits per lane
+template <int BlendMask8Bit>
+inline vec4q blend(const vec4q& lhs, const vec4q& rhs) { return {_mm256_blend_epi32(lhs.ymm, rhs.ymm, BlendMask8Bit)}; }
+// byte-wise; mask lanes have to be all ones or all zeros, as comparisons produce them
+inline vec4q blend(const vec4q& lhs, const vec4q& rhs, const vec4q& mask) { return {_mm256_blendv_epi8(lhs.ymm, rhs.ymm, mask.ymm)}; }
+
+// lane i = x[(PermuteMask8Bit >> 2i) & 3], across 128 bit lanes
+template <int PermuteMask8Bit>
+inline vec4q permute(const vec4q& x) { return {_mm256_permute4x64_epi64(x.ymm, PermuteMask8Bit)}; }
+
+inline vec4q unpackHigh(const vec4q& lhs, const vec4q& rhs) { return {_mm256_unpackhi_epi64(lhs.ymm, rhs.ymm)}; }
+inline vec4q unpackLow(const vec4q& lhs, const vec4q& rhs) { return {_mm256_unpacklo_epi64(lhs.ymm, rhs.ymm)}; }
+
+
+// math; no vpminsq, vpmaxsq, vpabsq before AVX-512
+inline vec4q min(const vec4q& lhs, const vec4q& rhs) { return blend(lhs, rhs, lhs > rhs); }
+inline vec4q max(const vec4q& lhs, const vec4q& rhs) { return blend(lhs, rhs, rhs > lhs); }
+
+inline vec4q abs(const vec4q& x) {
+  const auto negated = _mm256_sub_epi64(_mm256_setzero_si256(), x.ymm);
+  return {_mm256_castpd_si256(
+      _mm256_blendv_pd(_mm256_castsi256_pd(x.ymm), _mm256_castsi256_pd(negated), _mm256_castsi256_pd(x.ymm)))};
+}
+
+// full reduction of all four lanes to a scalar
+inline vec4q::Value hSum(const vec4q& x) {
+  const auto pair = _mm_add_epi64(_mm256_castsi256_si128(x.ymm), _mm256_extracti128_si256(x.ymm, 1));
+  return _mm_cvtsi128_si64(_mm_add_epi64(pair, _mm_unpackhi_epi64(pair, pair)));
+}
+
+// masks; one bit per lane, from the lane's sign bit
+inline int moveMask(const vec4q& x) { return _mm256_movemask_pd(_mm256_castsi256_pd(x.ymm)); }
+
+// tests
+inline bool isZFlagSet(const vec4q& lhs, const vec4q& rhs) { return _mm256_testz_si256(lhs.ymm, rhs.ymm) != 0; }
+inline bool isCFlagSet(const vec4q& lhs, const vec4q& rhs) { return _mm256_testc_si256(lhs.ymm, rhs.ymm) != 0; }
+
+
+// widen resp. narrow between vec8i and vec4q; Low and High are lanes 0-3 resp. 4-7 of the vec8i
+inline vec4q widenLow(const vec8i& x) { return {_mm256_cvtepi32_epi64(_mm256_castsi256_si128(x.ymm))}; }
+inline vec4q widenHigh(const vec8i& x) { return {_mm256_cvtepi32_epi64(_mm256_extracti128_si256(x.ymm, 1))}; }
+inline vec4q widenLowUnsigned(const vec8i& x) { return {_mm256_cvtepu32_epi64(_mm256_castsi256_si128(x.ymm))}; }
+inline vec4q widenHighUnsigned(const vec8i& x) { return {_mm256_cvtepu32_epi64(_mm256_extracti128_si256(x.ymm, 1))}; }
+
+// low 32 bits of each lane, truncating; there is no saturating 64 -> 32 bit pack before AVX-512
+inline vec8i narrow(const vec4q& low, const vec4q& high) {
+  const auto even = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+  const auto lo = _mm256_permutevar8x32_epi32(low.ymm, even);
+  const auto hi = _mm256_permutevar8x32_epi32(high.ymm, even);
+  return {_mm256_permute2x128_si256(lo, hi, 0x20)};
+}
+}
+}
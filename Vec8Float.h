@@ -2,23 +2,29 @@
 
 #include <cassert>
 #include <cstddef>
+#include <algorithm>
 #include <type_traits>
 #include <immintrin.h>
 #include "VecBase.h"
+#include "Vec8Int.h"
+#include "Half.h"
 
 namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
 
 using vec8f = vec<float, 8u>;
 
 template <>
 struct vec<float, 8u> final {
   using Value = float;
+  using Mask = vec8i;
   static const constexpr std::size_t Size = 8u;
 
   // thin abstraction; instead of explicit conversion operator and the need for static-casting, just use .ymm
   __m256 ymm;
 
-  vec() : ymm(_mm256_undefined_ps()) {}
+  // zero rather than _mm256_undefined_ps: GCC warns about the latter once inlined, the xor is dropped if overwritten
+  vec() : ymm(_mm256_setzero_ps()) {}
   vec(__m256 x) : ymm(x) {}
   vec(Value scalar) { load(scalar); }
   vec(const Value* first, const Value* last) { load(first, last); }
@@ -43,6 +49,43 @@ struct vec<float, 8u> final {
     ymm = _mm256_setr_ps(e7, e6, e5, e4, e3, e2, e1, e0);
   }
 
+  // lanes with the mask's sign bit set are loaded, others are zero; masked-out memory is never touched
+  void load_masked(const Value* first, const vec8i& mask) { ymm = _mm256_maskload_ps(first, mask.ymm); }
+
+  // [first, last) may be shorter than Size, remaining lanes are zero
+  void load_partial(const Value* first, const Value* last) {
+    assert(last - first >= 0 && static_cast<std::size_t>(last - first) <= Size);
+    load_masked(first, laneMask(last - first));
+  }
+
+  // 16 bit storage converted to float in registers, see Half.h
+  void load(const Half* first, const Half* last) {
+    assert(last - first == Size);
+    ymm = _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)));
+  }
+
+  void load(const BFloat16* first, const BFloat16* last) {
+    assert(last - first == Size);
+    ymm = detail::widenBFloat16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(first)));
+  }
+
+  // there are no masked 16 bit loads: through a zeroed copy
+  template <typename Storage>
+  void load_partial(const Storage* first, const Storage* last) {
+    assert(last - first >= 0 && static_cast<std::size_t>(last - first) <= Size);
+    Storage lanes[Size] = {};
+    std::copy(first, last, lanes);
+    load(lanes, lanes + Size);
+  }
+
+  // AVX2, lane i = base[index[i]]
+  void gather(const Value* base, const vec8i& index) { ymm = _mm256_i32gather_ps(base, index.ymm, sizeof(Value)); }
+
+  // AVX2, as above for lanes with the mask's sign bit set; others keep their value and their memory is never touched
+  void gather_masked(const Value* base, const vec8i& index, const vec8i& mask) {
+    ymm = _mm256_mask_i32gather_ps(ymm, base, index.ymm, _mm256_castsi256_ps(mask.ymm), sizeof(Value));
+  }
+
   // store
   void store(Value* first, Value* last) {
     assert(last - first == Size);
@@ -59,6 +102,58 @@ struct vec<float, 8u> final {
     _mm256_stream_ps(first, ymm);
   }
 
+  // only lanes with the mask's sign bit set are written
+  void store_masked(Value* first, const vec8i& mask) { _mm256_maskstore_ps(first, mask.ymm, ymm); }
+
+  // [first, last) may be shorter than Size, writes the first last - first lanes only
+  void store_partial(Value* first, Value* last) {
+    assert(last - first >= 0 && static_cast<std::size_t>(last - first) <= Size);
+    store_masked(first, laneMask(last - first));
+  }
+
+  // 16 bit storage, rounded to nearest even
+  void store(Half* first, Half* last) {
+    assert(last - first == Size);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(first), _mm256_cvtps_ph(ymm, _MM_FROUND_TO_NEAREST_INT));
+  }
+
+  void store(BFloat16* first, BFloat16* last) {
+    assert(last - first == Size);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(first), detail::narrowBFloat16(ymm));
+  }
+
+  template <typename Storage>
+  void store_partial(Storage* first, Storage* last) {
+    assert(last - first >= 0 && static_cast<std::size_t>(last - first) <= Size);
+    Storage lanes[Size];
+    store(lanes, lanes + Size);
+    std::copy(lanes, lanes + (last - first), first);
+  }
+
+  // base[index[i]] = lane i; there is no scatter mnemonic in AVX2, lane by lane -- on duplicate indices the last lane wins
+  void scatter(Value* base, const vec8i& index) {
+    alignas(32) Value lanes[Size];
+    alignas(32) vec8i::Value offsets[Size];
+    store_aligned(lanes, lanes + Size);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(offsets), index.ymm);
+
+    for (std::size_t i{0}; i < Size; ++i)
+      base[offsets[i]] = lanes[i];
+  }
+
+  // as above for lanes with the mask's sign bit set
+  void scatter_masked(Value* base, const vec8i& index, const vec8i& mask) {
+    alignas(32) Value lanes[Size];
+    alignas(32) vec8i::Value offsets[Size];
+    store_aligned(lanes, lanes + Size);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(offsets), index.ymm);
+
+    for (int bits = moveMask(mask); bits != 0; bits &= bits - 1) {
+      const auto i = static_cast<std::size_t>(__builtin_ctz(bits));
+      base[offsets[i]] = lanes[i];
+    }
+  }
+
   // misc
   void zero() { ymm = _mm256_setzero_ps(); }
 
@@ -117,13 +212,15 @@ inline vec8f operator-(const vec8f& lhs, const vec8f& rhs) { return {_mm256_sub_
 inline vec8f operator*(const vec8f& lhs, const vec8f& rhs) { return {_mm256_mul_ps(lhs.ymm, rhs.ymm)}; }
 inline vec8f operator/(const vec8f& lhs, const vec8f& rhs) { return {_mm256_div_ps(lhs.ymm, rhs.ymm)}; }
 
-// TODO(daniel): andnot, op%, op~, op!, <<, >>, ++, --
+// TODO(daniel): op%, op!, <<, >>, ++, --
 inline vec8f operator|(const vec8f& lhs, const vec8f& rhs) { return {_mm256_or_ps(lhs.ymm, rhs.ymm)}; }
 inline vec8f operator&(const vec8f& lhs, const vec8f& rhs) { return {_mm256_and_ps(lhs.ymm, rhs.ymm)}; }
 inline vec8f operator^(const vec8f& lhs, const vec8f& rhs) { return {_mm256_xor_ps(lhs.ymm, rhs.ymm)}; }
+// lhs & ~rhs, see vec8i
+inline vec8f andNot(const vec8f& lhs, const vec8f& rhs) { return {_mm256_andnot_ps(rhs.ymm, lhs.ymm)}; }
 
 // unary
-inline vec8f operator~(const vec8f& x) { return {_mm256_xor_ps(x.ymm, _mm256_set1_ps(-1.f))}; }
+inline vec8f operator~(const vec8f& x) { return {_mm256_xor_ps(x.ymm, _mm256_castsi256_ps(_mm256_set1_epi32(-1)))}; }
 inline vec8f operator-(const vec8f& x) { return {_mm256_sub_ps(_mm256_set1_ps(0.f), x.ymm)}; }
 
 
@@ -149,10 +246,16 @@ inline vec8f operator>=(const vec8f& lhs, const vec8f& rhs) { return compare<13>
 template <int BlendMask8Bit>
 inline vec8f blend(const vec8f& lhs, const vec8f& rhs) { return {_mm256_blend_ps(lhs.ymm, rhs.ymm, BlendMask8Bit)}; }
 inline vec8f blend(const vec8f& lhs, const vec8f& rhs, const vec8f& mask) { return {_mm256_blendv_ps(lhs.ymm, rhs.ymm, mask.ymm)}; }
+inline vec8f blend(const vec8f& lhs, const vec8f& rhs, const vec8i& mask) {
+  return {_mm256_blendv_ps(lhs.ymm, rhs.ymm, _mm256_castsi256_ps(mask.ymm))};
+}
 
 template <int PermuteMask8Bit>
 inline vec8f permute(const vec8f& x) { return {_mm256_permute_ps(x.ymm, PermuteMask8Bit)}; }
 
+// AVX2, lane i = x[index[i] % 8], across 128 bit lanes
+inline vec8f permute(const vec8f& x, const vec8i& index) { return {_mm256_permutevar8x32_ps(x.ymm, index.ymm)}; }
+
 template <int PermuteMask8Bit>
 inline vec8f permute(const vec8f& lhs, const vec8f& rhs) { return {_mm256_permute2f128_ps(lhs.ymm, rhs.ymm, PermuteMask8Bit)}; }
 
@@ -163,6 +266,15 @@ inline vec8f unpackHigh(const vec8f& lhs, const vec8f& rhs) { return {_mm256_unp
 inline vec8f unpackLow(const vec8f& lhs, const vec8f& rhs) { return {_mm256_unpacklo_ps(lhs.ymm, rhs.ymm)}; }
 
 
+// conversions; convert rounds according to MXCSR (to nearest by default), reinterpret keeps the bits as they are
+inline vec8i convert(const vec8f& x) { return {_mm256_cvtps_epi32(x.ymm)}; }
+inline vec8i convertTruncate(const vec8f& x) { return {_mm256_cvttps_epi32(x.ymm)}; }
+inline vec8f convert(const vec8i& x) { return {_mm256_cvtepi32_ps(x.ymm)}; }
+
+inline vec8i reinterpret(const vec8f& x) { return {_mm256_castps_si256(x.ymm)}; }
+inline vec8f reinterpret(const vec8i& x) { return {_mm256_castsi256_ps(x.ymm)}; }
+
+
 // math
 inline vec8f ceil(const vec8f& x) { return {_mm256_ceil_ps(x.ymm)}; }
 inline vec8f floor(const vec8f& x) { return {_mm256_floor_ps(x.ymm)}; }
@@ -170,24 +282,48 @@ inline vec8f floor(const vec8f& x) { return {_mm256_floor_ps(x.ymm)}; }
 template <int RoundingMode = _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC>
 inline vec8f round(const vec8f& x) { return {_mm256_round_ps(x.ymm, RoundingMode)}; }
 
-inline vec8f min(const vec8f& lhs, vec8f& rhs) { return {_mm256_min_ps(lhs.ymm, rhs.ymm)}; }
-inline vec8f max(const vec8f& lhs, vec8f& rhs) { return {_mm256_max_ps(lhs.ymm, rhs.ymm)}; }
+inline vec8f min(const vec8f& lhs, const vec8f& rhs) { return {_mm256_min_ps(lhs.ymm, rhs.ymm)}; }
+inline vec8f max(const vec8f& lhs, const vec8f& rhs) { return {_mm256_max_ps(lhs.ymm, rhs.ymm)}; }
+
+inline vec8f abs(const vec8f& x) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.f), x.ymm)}; }
 
 inline vec8f sqrt(const vec8f& x) { return {_mm256_sqrt_ps(x.ymm)}; }
 // maximum relative error for this approximation is less than 1.5*2^-12
-inline vec8f reciprocalSqrt(const vec8f& x) { return {_mm256_sqrt_ps(x.ymm)}; }
+inline vec8f reciprocalSqrt(const vec8f& x) { return {_mm256_rsqrt_ps(x.ymm)}; }
 
 inline vec8f addSub(const vec8f& lhs, const vec8f& rhs) { return {_mm256_addsub_ps(lhs.ymm, rhs.ymm)}; }
 
 // maximum relative error for this approximation is less than 1.5*2^-12
 inline vec8f reciprocal(const vec8f& x) { return {_mm256_rcp_ps(x.ymm)}; }
 
+// exp, log, sin, cos, tanh, pow and their fast variants: see Vec8FloatMath.h
+
 // horizontal operations; use if you have to
 inline vec8f hAdd(const vec8f& lhs, const vec8f& rhs) { return {_mm256_hadd_ps(lhs.ymm, rhs.ymm)}; }
 inline vec8f hSub(const vec8f& lhs, const vec8f& rhs) { return {_mm256_hsub_ps(lhs.ymm, rhs.ymm)}; }
 inline vec8f hEvenDup(const vec8f& x) { return {_mm256_moveldup_ps(x.ymm)}; }
 inline vec8f hOddDup(const vec8f& x) { return {_mm256_movehdup_ps(x.ymm)}; }
 
+// full reductions of all eight lanes to a scalar; once per array, not per block
+inline float hSum(const vec8f& x) {
+  const auto quad = _mm_add_ps(_mm256_castps256_ps128(x.ymm), _mm256_extractf128_ps(x.ymm, 1));
+  const auto pair = _mm_add_ps(quad, _mm_movehl_ps(quad, quad));
+  return _mm_cvtss_f32(_mm_add_ss(pair, _mm_movehdup_ps(pair)));
+}
+
+inline float hMin(const vec8f& x) {
+  const auto quad = _mm_min_ps(_mm256_castps256_ps128(x.ymm), _mm256_extractf128_ps(x.ymm, 1));
+  const auto pair = _mm_min_ps(quad, _mm_movehl_ps(quad, quad));
+  return _mm_cvtss_f32(_mm_min_ss(pair, _mm_movehdup_ps(pair)));
+}
+
+inline float hMax(const vec8f& x) {
+  const auto quad = _mm_max_ps(_mm256_castps256_ps128(x.ymm), _mm256_extractf128_ps(x.ymm, 1));
+  const auto pair = _mm_max_ps(quad, _mm_movehl_ps(quad, quad));
+  return _mm_cvtss_f32(_mm_max_ss(pair, _mm_movehdup_ps(pair)));
+}
+
+// two dot products, one per 128 bit lane; hSum(lhs * rhs) for all eight lanes
 template <int MultiplyMask8Bit = 0xF0, int StoreMask8Bit = 0x0F>
 inline vec8f dot(const vec8f& lhs, const vec8f& rhs) { return {_mm256_dp_ps(lhs.ymm, rhs.ymm, MultiplyMask8Bit | StoreMask8Bit)}; }
 
@@ -220,3 +356,4 @@ inline vec8f fusedMulAddSub(const vec8f& a, const vec8f& b, const vec8f& c) { re
 inline vec8f fusedMulSubAdd(const vec8f& a, const vec8f& b, const vec8f& c) { return {_mm256_fmsubadd_ps(a.ymm, b.ymm, c.ymm)}; }
 
 }
+}
@@ -0,0 +1,240 @@
+#pragma once
+
+#include <limits>
+#include "Vec8Float.h"
+#include "Vec8Int.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// FMA polynomial approximations, range reductions after Cephes and Pommier's sse_mathfun
+//
+// errors are the maximum over the stated domain against the double precision libm result, see mathTest():
+//   exp, log, sin, cos, tanh, pow: a few ulp, special values (nan, +-inf, +-0, denormals) as in C99 unless noted
+//   *Fast variants: stated absolute or relative errors, no special value handling -- like reciprocal vs. /
+
+namespace detail {
+
+  inline vec8f quietNaN() { return {std::numeric_limits<float>::quiet_NaN()}; }
+  inline vec8f infinity() { return {std::numeric_limits<float>::infinity()}; }
+
+  // 2^n for n in [-126, 127] by constructing the exponent; 128 results in inf
+  inline vec8f exp2i(const vec8i& n) { return reinterpret(shiftLeftZeroExtend<23>(n + vec8i{127})); }
+
+  // x * 2^n for n in [-252, 254]; two exact scalings so that denormal and overflowing results are rounded once
+  inline vec8f scale(const vec8f& x, const vec8i& n) {
+    const auto half = shiftRightSignExtend<1>(n);
+    return x * exp2i(half) * exp2i(n - half);
+  }
+
+  // e^r for r in [-ln2/2, ln2/2]
+  inline vec8f expPolynomial(const vec8f& r) {
+    auto p = fusedMulAdd(vec8f{1.9875691500e-4f}, r, vec8f{1.3981999507e-3f});
+    p = fusedMulAdd(p, r, vec8f{8.3334519073e-3f});
+    p = fusedMulAdd(p, r, vec8f{4.1665795894e-2f});
+    p = fusedMulAdd(p, r, vec8f{1.6666665459e-1f});
+    p = fusedMulAdd(p, r, vec8f{5.0000001201e-1f});
+    return fusedMulAdd(p, r * r, r) + vec8f{1.f};
+  }
+
+  // splits x into exponent and mantissa m - 1 with m in [sqrt(0.5), sqrt(2)); x has to be positive and normal
+  inline vec8f logReduce(const vec8f& x, vec8f& exponent) {
+    const auto bits = reinterpret(x);
+    auto e = shiftRightZeroExtend<23>(bits) - vec8i{126};
+    auto m = reinterpret((bits & vec8i{0x007FFFFF}) | vec8i{0x3F000000}); // [0.5, 1)
+
+    const auto small = m < vec8f{0.707106781186547524f};
+    e = e + reinterpret(small); // mask lanes are -1
+    m = m + (m & small) - vec8f{1.f};
+
+    exponent = convert(e);
+    return m;
+  }
+
+  // sin and cos share the reduction to [-pi/4, pi/4] by multiples of pi/4, the octant selects polynomial and sign
+  template <bool Cosine>
+  inline vec8f sinCos(const vec8f& x) {
+    auto ax = abs(x);
+
+    auto j = convertTruncate(ax * vec8f{1.27323954473516f}); // 4 / pi
+    j = (j + vec8i{1}) & vec8i{~1};
+    const auto y = convert(j);
+
+    if (Cosine)
+      j = j - vec8i{2};
+
+    const auto sign = Cosine ? shiftLeftZeroExtend<29>(~j & vec8i{4})
+                             : shiftLeftZeroExtend<29>(j & vec8i{4}) ^ (reinterpret(x) & vec8i{std::numeric_limits<std::int32_t>::min()});
+    const auto useSin = (j & vec8i{2}) == vec8i{0};
+
+    // extended precision modular arithmetic, Cody-Waite
+    ax = fusedMulNegateAdd(y, vec8f{0.78515625f}, ax);
+    ax = fusedMulNegateAdd(y, vec8f{2.4187564849853515625e-4f}, ax);
+    ax = fusedMulNegateAdd(y, vec8f{3.77489497744594108e-8f}, ax);
+
+    const auto z = ax * ax;
+
+    auto c = fusedMulAdd(vec8f{2.443315711809948e-5f}, z, vec8f{-1.388731625493765e-3f});
+    c = fusedMulAdd(c, z, vec8f{4.166664568298827e-2f});
+    c = fusedMulAdd(c * z, z, fusedMulAdd(z, vec8f{-0.5f}, vec8f{1.f}));
+
+    auto s = fusedMulAdd(vec8f{-1.9515295891e-4f}, z, vec8f{8.3321608736e-3f});
+    s = fusedMulAdd(s, z, vec8f{-1.6666654611e-1f});
+    s = fusedMulAdd(s * z, ax, ax);
+
+    const auto rv = blend(c, s, useSin) ^ reinterpret(sign);
+
+    // inf and nan
+    return blend(rv, x - x, x - x != vec8f{0.f});
+  }
+}
+
+
+// exp: max 1.02 ulp, 1.0104 measured over all floats in [-103.97, 88.72] (0.75 for denormal results) -- the last
+// rounding of 1 + r + r^2 p adds to the polynomial's; overflows to inf above 88.72, denormal results down to -103.97,
+// 0 below
+inline vec8f exp(const vec8f& x) {
+  const auto clamped = min(max(x, vec8f{-104.f}), vec8f{89.f});
+
+  const auto n = round(clamped * vec8f{1.44269504088896341f}); // log2(e)
+  auto r = fusedMulNegateAdd(n, vec8f{0.693359375f}, clamped);
+  r = fusedMulNegateAdd(n, vec8f{-2.12194440e-4f}, r);
+
+  const auto rv = detail::scale(detail::expPolynomial(r), convert(n));
+  return blend(rv, x, x != x);
+}
+
+// expFast: relative error 3e-6; x clamped to [-87.3, 88.3] (no denormals, no inf), nan is not propagated
+inline vec8f expFast(const vec8f& x) {
+  const auto clamped = min(max(x, vec8f{-87.3f}), vec8f{88.3f});
+
+  const auto n = round(clamped * vec8f{1.44269504088896341f});
+  const auto r = fusedMulNegateAdd(n, vec8f{0.693147180559945f}, clamped);
+
+  auto p = fusedMulAdd(vec8f{4.141705600e-2f}, r, vec8f{1.679066064e-1f});
+  p = fusedMulAdd(p, r, vec8f{5.000485045e-1f});
+  p = fusedMulAdd(p, r, vec8f{9.999636255e-1f});
+  p = fusedMulAdd(p, r, vec8f{9.999991909e-1f});
+
+  return p * detail::exp2i(convert(n));
+}
+
+
+// log: max 1 ulp; log(0) = -inf, log(inf) = inf, log(x < 0) = nan, denormals are scaled up
+inline vec8f log(const vec8f& x) {
+  const auto denormal = x < vec8f{std::numeric_limits<float>::min()};
+  const auto scaled = blend(x, x * vec8f{8388608.f}, denormal); // 2^23
+
+  vec8f e;
+  const auto m = detail::logReduce(scaled, e);
+  e = e - (denormal & vec8f{23.f});
+
+  const auto z = m * m;
+
+  auto p = fusedMulAdd(vec8f{7.0376836292e-2f}, m, vec8f{-1.1514610310e-1f});
+  p = fusedMulAdd(p, m, vec8f{1.1676998740e-1f});
+  p = fusedMulAdd(p, m, vec8f{-1.2420140846e-1f});
+  p = fusedMulAdd(p, m, vec8f{1.4249322787e-1f});
+  p = fusedMulAdd(p, m, vec8f{-1.6668057665e-1f});
+  p = fusedMulAdd(p, m, vec8f{2.0000714765e-1f});
+  p = fusedMulAdd(p, m, vec8f{-2.4999993993e-1f});
+  p = fusedMulAdd(p, m, vec8f{3.3333331174e-1f});
+
+  auto y = p * m * z;
+  y = fusedMulAdd(e, vec8f{-2.12194440e-4f}, y);
+  y = fusedMulAdd(z, vec8f{-0.5f}, y);
+  auto rv = fusedMulAdd(e, vec8f{0.693359375f}, m + y);
+
+  rv = blend(rv, detail::infinity(), x == detail::infinity());
+  rv = blend(rv, -detail::infinity(), x == vec8f{0.f});
+  return blend(rv, detail::quietNaN(), compare<_CMP_NGE_UQ>(x, vec8f{0.f})); // x < 0 or nan
+}
+
+// logFast: absolute error 2e-6; x has to be positive and normal
+inline vec8f logFast(const vec8f& x) {
+  vec8f e;
+  const auto m = detail::logReduce(x, e);
+
+  auto p = fusedMulAdd(vec8f{-1.423019338e-1f}, m, vec8f{2.232526532e-1f});
+  p = fusedMulAdd(p, m, vec8f{-2.548729788e-1f});
+  p = fusedMulAdd(p, m, vec8f{3.322423279e-1f});
+  p = fusedMulAdd(p, m, vec8f{-4.998440549e-1f});
+  p = fusedMulAdd(p, m, vec8f{1.000014372e+0f});
+
+  return fusedMulAdd(e, vec8f{0.693147180559945f}, p * m);
+}
+
+
+// sin, cos: max 2 ulp for |x| <= pi, 1e-7 absolute for |x| <= 8192, accuracy degrades beyond; inf and nan result in nan
+inline vec8f sin(const vec8f& x) { return detail::sinCos<false>(x); }
+inline vec8f cos(const vec8f& x) { return detail::sinCos<true>(x); }
+
+// sinFast, cosFast: absolute error 7e-6 resp. 2e-6 for |x| <= 8192, reduction to [-pi, pi] by multiples of 2 pi
+inline vec8f sinFast(const vec8f& x) {
+  const auto n = round(x * vec8f{0.159154943091895f}); // 1 / (2 pi)
+  auto r = fusedMulNegateAdd(n, vec8f{6.28125f}, x);
+  r = fusedMulNegateAdd(n, vec8f{1.9353071795864769e-3f}, r);
+
+  const auto z = r * r;
+  auto p = fusedMulAdd(vec8f{2.147054562e-6f}, z, vec8f{-1.926317972e-4f});
+  p = fusedMulAdd(p, z, vec8f{8.308850564e-3f});
+  p = fusedMulAdd(p, z, vec8f{-1.666240169e-1f});
+  p = fusedMulAdd(p, z, vec8f{9.999791158e-1f});
+  return p * r;
+}
+
+inline vec8f cosFast(const vec8f& x) {
+  const auto n = round(x * vec8f{0.159154943091895f});
+  auto r = fusedMulNegateAdd(n, vec8f{6.28125f}, x);
+  r = fusedMulNegateAdd(n, vec8f{1.9353071795864769e-3f}, r);
+
+  const auto z = r * r;
+  auto p = fusedMulAdd(vec8f{-2.197296439e-7f}, z, vec8f{2.420294151e-5f});
+  p = fusedMulAdd(p, z, vec8f{-1.385878993e-3f});
+  p = fusedMulAdd(p, z, vec8f{4.165977781e-2f});
+  p = fusedMulAdd(p, z, vec8f{-4.999942134e-1f});
+  return fusedMulAdd(p, z, vec8f{9.999992108e-1f});
+}
+
+
+// tanh: max 2 ulp; polynomial below |x| < 0.625, 1 - 2 / (e^2x + 1) above; +-inf result in +-1
+inline vec8f tanh(const vec8f& x) {
+  const auto ax = abs(x);
+  const auto z = x * x;
+
+  auto p = fusedMulAdd(vec8f{-5.70498872745e-3f}, z, vec8f{2.06390887954e-2f});
+  p = fusedMulAdd(p, z, vec8f{-5.37397155531e-2f});
+  p = fusedMulAdd(p, z, vec8f{1.33314422036e-1f});
+  p = fusedMulAdd(p, z, vec8f{-3.33332819422e-1f});
+  const auto small = fusedMulAdd(p * z, ax, ax);
+
+  const auto large = vec8f{1.f} - vec8f{2.f} / (exp(ax + ax) + vec8f{1.f});
+
+  return blend(large, small, ax < vec8f{0.625f}) | (x & vec8f{-0.f});
+}
+
+// tanhFast: absolute error 2e-6; nan is not propagated
+inline vec8f tanhFast(const vec8f& x) {
+  const auto e = expFast(x + x);
+  return (e - vec8f{1.f}) / (e + vec8f{1.f});
+}
+
+
+// pow: e^(y log x), the error grows with |y log x|: about |y log x| + 8 ulp
+// pow(x, 0) = pow(1, y) = 1; x < 0 only for integral y; pow(+-0, y) = +0 resp. inf for y > 0 resp. y < 0
+inline vec8f pow(const vec8f& x, const vec8f& y) {
+  auto rv = exp(y * log(abs(x)));
+
+  const auto negative = x < vec8f{0.f};
+  const auto half = y * vec8f{0.5f};
+  const auto odd = (round(y) == y) & (round(half) != half);
+
+  rv = blend(rv, -rv, negative & odd);
+  rv = blend(rv, detail::quietNaN(), negative & (round(y) != y));
+  return blend(rv, vec8f{1.f}, (y == vec8f{0.f}) | (x == vec8f{1.f}));
+}
+
+// powFast: expFast(y logFast(x)), relative error 1e-5 for |y log x| < 24; x has to be positive and normal
+inline vec8f powFast(const vec8f& x, const vec8f& y) { return expFast(y * logFast(x)); }
+}
+}
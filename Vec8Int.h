@@ -8,18 +8,21 @@
 #include "VecBase.h"
 
 namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
 
 using vec8i = vec<std::int32_t, 8u>;
 
 template <>
 struct vec<std::int32_t, 8u> final {
   using Value = std::int32_t;
+  using Mask = vec8i;
   static const constexpr std::size_t Size = 8u;
 
   // thin abstraction; instead of explicit conversion operator and the need for static-casting, just use .ymm
   __m256i ymm;
 
-  vec() : ymm(_mm256_undefined_si256()) {}
+  // zero rather than _mm256_undefined_si256, see vec8f
+  vec() : ymm(_mm256_setzero_si256()) {}
   vec(__m256i x) : ymm(x) {}
   vec(Value scalar) { load(scalar); }
   vec(const Value* first, const Value* last) { load(first, last); }
@@ -51,6 +54,24 @@ struct vec<std::int32_t, 8u> final {
     ymm = _mm256_setr_epi32(e7, e6, e5, e4, e3, e2, e1, e0);
   }
 
+  // AVX2, lanes with the mask's sign bit set are loaded, others are zero; masked-out memory is never touched
+  void load_masked(const Value* first, const vec8i& mask) {
+    ymm = _mm256_maskload_epi32(reinterpret_cast<const int*>(first), mask.ymm);
+  }
+
+  // [first, last) may be shorter than Size, remaining lanes are zero
+  void load_partial(const Value* first, const Value* last);
+
+  // AVX2, lane i = base[index[i]]
+  void gather(const Value* base, const vec8i& index) {
+    ymm = _mm256_i32gather_epi32(reinterpret_cast<const int*>(base), index.ymm, sizeof(Value));
+  }
+
+  // AVX2, as above for lanes with the mask's sign bit set; others keep their value and their memory is never touched
+  void gather_masked(const Value* base, const vec8i& index, const vec8i& mask) {
+    ymm = _mm256_mask_i32gather_epi32(ymm, reinterpret_cast<const int*>(base), index.ymm, mask.ymm, sizeof(Value));
+  }
+
   // store
   void store(Value* first, Value* last) {
     assert(last - first == Size);
@@ -67,6 +88,31 @@ struct vec<std::int32_t, 8u> final {
     _mm256_stream_si256(reinterpret_cast<__m256i*>(first), ymm);
   }
 
+  // same as stream_aligned, named as in vec8f for generic code
+  void store_aligned_stream(Value* first, Value* last) { stream_aligned(first, last); }
+
+  // AVX2, only lanes with the mask's sign bit set are written
+  void store_masked(Value* first, const vec8i& mask) {
+    _mm256_maskstore_epi32(reinterpret_cast<int*>(first), mask.ymm, ymm);
+  }
+
+  // [first, last) may be shorter than Size, writes the first last - first lanes only
+  void store_partial(Value* first, Value* last);
+
+  // base[index[i]] = lane i; there is no scatter mnemonic in AVX2, lane by lane -- on duplicate indices the last lane wins
+  void scatter(Value* base, const vec8i& index) {
+    alignas(32) Value lanes[Size];
+    alignas(32) vec8i::Value offsets[Size];
+    store_aligned(lanes, lanes + Size);
+    _mm256_store_si256(reinterpret_cast<__m256i*>(offsets), index.ymm);
+
+    for (std::size_t i{0}; i < Size; ++i)
+      base[offsets[i]] = lanes[i];
+  }
+
+  // as above for lanes with the mask's sign bit set
+  void scatter_masked(Value* base, const vec8i& index, const vec8i& mask);
+
   // misc
   void zero() { ymm = _mm256_setzero_si256(); }
 
@@ -81,12 +127,13 @@ struct vec<std::int32_t, 8u> final {
     return *this;
   }
 
+  // lane-wise, low 32 bits of the products
   vec8i& operator*=(const vec8i& rhs) {
-    ymm = _mm256_mul_epi32(ymm, rhs.ymm);
+    ymm = _mm256_mullo_epi32(ymm, rhs.ymm);
     return *this;
   }
 
-  // there is no div mmnemonic for integers
+  // there is no div mnemonic for integers, see VecDivide.h for invariant divisors
 
   vec8i& operator|=(const vec8i& rhs) {
     ymm = _mm256_or_si256(ymm, rhs.ymm);
@@ -113,29 +160,66 @@ struct vec<std::int32_t, 8u> final {
     return *this;
   }
 
-  // subscript
-  Value& operator[](std::size_t index) {
+  // subscript; through a may_alias lane type, GCC folds integer intrinsics to long long vectors, see VecBase.h
+  typedef Value __attribute__((__may_alias__)) Lane;
+
+  Lane& operator[](std::size_t index) {
     assert(index < Size);
-    return *(reinterpret_cast<Value*>(&ymm) + index);
+    return *(reinterpret_cast<Lane*>(&ymm) + index);
   }
 
-  const Value& operator[](std::size_t index) const {
+  const Lane& operator[](std::size_t index) const {
     assert(index < Size);
-    return *(reinterpret_cast<const Value*>(&ymm) + index);
+    return *(reinterpret_cast<const Lane*>(&ymm) + index);
   }
 };
 
 
+// mask with the first n lanes set, e.g. for the tail of an array; n >= Size sets all lanes
+inline vec8i laneMask(std::size_t n) {
+  const auto count = static_cast<vec8i::Value>(n < vec8i::Size ? n : vec8i::Size);
+  return {_mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7))};
+}
+
+inline void vec8i::load_partial(const Value* first, const Value* last) {
+  assert(last - first >= 0 && static_cast<std::size_t>(last - first) <= Size);
+  load_masked(first, laneMask(last - first));
+}
+
+inline void vec8i::store_partial(Value* first, Value* last) {
+  assert(last - first >= 0 && static_cast<std::size_t>(last - first) <= Size);
+  store_masked(first, laneMask(last - first));
+}
+
+// masks; one bit per lane, from the lane's sign bit
+inline int moveMask(const vec8i& x) { return _mm256_movemask_ps(_mm256_castsi256_ps(x.ymm)); }
+
+inline void vec8i::scatter_masked(Value* base, const vec8i& index, const vec8i& mask) {
+  alignas(32) Value lanes[Size];
+  alignas(32) Value offsets[Size];
+  store_aligned(lanes, lanes + Size);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(offsets), index.ymm);
+
+  for (int bits = moveMask(mask); bits != 0; bits &= bits - 1) {
+    const auto i = static_cast<std::size_t>(__builtin_ctz(bits));
+    base[offsets[i]] = lanes[i];
+  }
+}
+
+
 // free standing functions, participate in implicit conversion for lhs and rhs
 inline vec8i operator+(const vec8i& lhs, const vec8i& rhs) { return {_mm256_add_epi32(lhs.ymm, rhs.ymm)}; }
 inline vec8i operator-(const vec8i& lhs, const vec8i& rhs) { return {_mm256_sub_epi32(lhs.ymm, rhs.ymm)}; }
-inline vec8i operator*(const vec8i& lhs, const vec8i& rhs) { return {_mm256_mul_epi32(lhs.ymm, rhs.ymm)}; }
-// there is no div mnemonic for integers
+// lane-wise, low 32 bits of the products -- wraps around like unsigned arithmetic; mulHi for the high 32 bits
+inline vec8i operator*(const vec8i& lhs, const vec8i& rhs) { return {_mm256_mullo_epi32(lhs.ymm, rhs.ymm)}; }
+// there is no div mnemonic for integers, see VecDivide.h for invariant divisors
 
-// TODO(daniel): andnot, op%, op!, ++, --
+// TODO(daniel): op%, op!, ++, --
 inline vec8i operator|(const vec8i& lhs, const vec8i& rhs) { return {_mm256_or_si256(lhs.ymm, rhs.ymm)}; }
 inline vec8i operator&(const vec8i& lhs, const vec8i& rhs) { return {_mm256_and_si256(lhs.ymm, rhs.ymm)}; }
 inline vec8i operator^(const vec8i& lhs, const vec8i& rhs) { return {_mm256_xor_si256(lhs.ymm, rhs.ymm)}; }
+// lhs & ~rhs in one instruction; note the mnemonic negates its first operand
+inline vec8i andNot(const vec8i& lhs, const vec8i& rhs) { return {_mm256_andnot_si256(rhs.ymm, lhs.ymm)}; }
 
 // unary
 inline vec8i operator~(const vec8i& x) { return {_mm256_xor_si256(x.ymm, _mm256_set1_epi32(-1))}; }
@@ -164,10 +248,19 @@ inline vec8i shiftLeftZeroExtend(const vec8i& x) { return {_mm256_slli_epi32(x.y
 template <int ShiftMask8Bit>
 inline vec8i shiftRightSignExtend(const vec8i& x) { return {_mm256_srai_epi32(x.ymm, ShiftMask8Bit)}; }
 
+// there is no rotate mnemonic before AVX-512 (vprold): two shifts and an or
+template <int Bits>
+inline vec8i rotateLeft(const vec8i& x) {
+  static_assert(Bits > 0 && Bits < 32, "rotate by 1 to 31 bits");
+  return shiftLeftZeroExtend<Bits>(x) | shiftRightZeroExtend<32 - Bits>(x);
+}
+
 
 // misc
 template <int BlendMask8Bit>
 inline vec8i blend(const vec8i& lhs, const vec8i& rhs) { return {_mm256_blend_epi32(lhs.ymm, rhs.ymm, BlendMask8Bit)}; }
+// byte-wise; mask lanes have to be all ones or all zeros, as comparisons and laneMask produce them
+inline vec8i blend(const vec8i& lhs, const vec8i& rhs, const vec8i& mask) { return {_mm256_blendv_epi8(lhs.ymm, rhs.ymm, mask.ymm)}; }
 
 inline vec8i permute(const vec8i& x, const vec8i& mask) { return {_mm256_permutevar8x32_epi32(x.ymm, mask.ymm)}; }
 
@@ -179,19 +272,51 @@ inline vec8i unpackLow(const vec8i& lhs, const vec8i& rhs) { return {_mm256_unpa
 
 
 // math
-inline vec8i min(const vec8i& lhs, vec8i& rhs) { return {_mm256_min_epi32(lhs.ymm, rhs.ymm)}; }
-inline vec8i max(const vec8i& lhs, vec8i& rhs) { return {_mm256_max_epi32(lhs.ymm, rhs.ymm)}; }
+inline vec8i min(const vec8i& lhs, const vec8i& rhs) { return {_mm256_min_epi32(lhs.ymm, rhs.ymm)}; }
+inline vec8i max(const vec8i& lhs, const vec8i& rhs) { return {_mm256_max_epi32(lhs.ymm, rhs.ymm)}; }
 
 inline vec8i abs(const vec8i& x) { return {_mm256_abs_epi32(x.ymm)}; }
 
+// high 32 bits of the 64 bit products, lanes as signed resp. unsigned integers; there is only a widening multiply for
+// the even lanes (mul_epi32), the odd lanes are shifted down into even position for a second one
+inline vec8i mulHi(const vec8i& lhs, const vec8i& rhs) {
+  const auto even = _mm256_srli_epi64(_mm256_mul_epi32(lhs.ymm, rhs.ymm), 32);
+  const auto odd = _mm256_mul_epi32(_mm256_srli_epi64(lhs.ymm, 32), _mm256_srli_epi64(rhs.ymm, 32));
+  return {_mm256_blend_epi32(even, odd, 0xAA)};
+}
+
+inline vec8i mulHiUnsigned(const vec8i& lhs, const vec8i& rhs) {
+  const auto even = _mm256_srli_epi64(_mm256_mul_epu32(lhs.ymm, rhs.ymm), 32);
+  const auto odd = _mm256_mul_epu32(_mm256_srli_epi64(lhs.ymm, 32), _mm256_srli_epi64(rhs.ymm, 32));
+  return {_mm256_blend_epi32(even, odd, 0xAA)};
+}
+
 // horizontal operations; use if you have to
 inline vec8i hAdd(const vec8i& lhs, const vec8i& rhs) { return {_mm256_hadd_epi32(lhs.ymm, rhs.ymm)}; }
 inline vec8i hSub(const vec8i& lhs, const vec8i& rhs) { return {_mm256_hsub_epi32(lhs.ymm, rhs.ymm)}; }
 
+// full reductions of all eight lanes to a scalar; once per array, not per block
+inline vec8i::Value hSum(const vec8i& x) {
+  const auto quad = _mm_add_epi32(_mm256_castsi256_si128(x.ymm), _mm256_extracti128_si256(x.ymm, 1));
+  const auto pair = _mm_add_epi32(quad, _mm_shuffle_epi32(quad, _MM_SHUFFLE(1, 0, 3, 2)));
+  return _mm_cvtsi128_si32(_mm_add_epi32(pair, _mm_shuffle_epi32(pair, _MM_SHUFFLE(2, 3, 0, 1))));
+}
+
+inline vec8i::Value hMin(const vec8i& x) {
+  const auto quad = _mm_min_epi32(_mm256_castsi256_si128(x.ymm), _mm256_extracti128_si256(x.ymm, 1));
+  const auto pair = _mm_min_epi32(quad, _mm_shuffle_epi32(quad, _MM_SHUFFLE(1, 0, 3, 2)));
+  return _mm_cvtsi128_si32(_mm_min_epi32(pair, _mm_shuffle_epi32(pair, _MM_SHUFFLE(2, 3, 0, 1))));
+}
+
+inline vec8i::Value hMax(const vec8i& x) {
+  const auto quad = _mm_max_epi32(_mm256_castsi256_si128(x.ymm), _mm256_extracti128_si256(x.ymm, 1));
+  const auto pair = _mm_max_epi32(quad, _mm_shuffle_epi32(quad, _MM_SHUFFLE(1, 0, 3, 2)));
+  return _mm_cvtsi128_si32(_mm_max_epi32(pair, _mm_shuffle_epi32(pair, _MM_SHUFFLE(2, 3, 0, 1))));
+}
+
 // tests
 inline bool isZFlagSet(const vec8i& lhs, const vec8i& rhs) { return _mm256_testz_si256(lhs.ymm, rhs.ymm) != 0; }
 inline bool isCFlagSet(const vec8i& lhs, const vec8i& rhs) { return _mm256_testc_si256(lhs.ymm, rhs.ymm) != 0; }
 inline bool isZAndCFlagClear(const vec8i& lhs, const vec8i& rhs) { return _mm256_testnzc_si256(lhs.ymm, rhs.ymm) != 0; }
-
-// TODO(daniel): gather, masks
+}
 }
@@ -1,20 +1,48 @@
 #pragma once
 
+#include <cassert>
 #include <cstddef>
+#include <cstring>
 #include <iterator>
 #include <algorithm>
+#include <type_traits>
+
+// the vec headers are built for avx2 and for avx512 (Kernels.%.o, Benchmarks512.cc) into the same binary: an inline
+// namespace per level keeps the linker from merging the levels' copies of inline functions, e.g. picking the avx512
+// vec8f operator+ for the avx2 kernels
+#if defined(__AVX512F__)
+#define AVX_ISA_NAMESPACE isa_avx512
+#else
+#define AVX_ISA_NAMESPACE isa_avx2
+#endif
 
 namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
 
 // specialized for valid combinations
 template <typename T, std::size_t N>
 struct vec final {};
 
+// widest registers for the build's level: kernels written against native<T> (and the loops in VecLoop.h) are 512 bit
+// wide when built with ISAFLAGS.avx512, 256 bit otherwise; vec16f and vec16i are the only 512 bit types for now
+#if defined(__AVX512F__)
+const constexpr std::size_t NativeBytes = 64u;
+#else
+const constexpr std::size_t NativeBytes = 32u;
+#endif
+
+template <typename T>
+using native = vec<T, NativeBytes / sizeof(T)>;
 
-// compiler-generated operator<< for _all_ vec<T, N> combinations
+
+// compiler-generated operator<< for _all_ vec<T, N> combinations; promoted, so that bytes print as numbers.
+// Copied out instead of read through begin(v): GCC folds integer intrinsics to long long vectors, and under strict
+// aliasing lane reads of another type do not see those stores.
 template <typename OutStream, typename T, std::size_t N>
 OutStream& operator<<(OutStream& o, const vec<T, N>& v) {
-  std::copy_n(begin(v), N, std::ostream_iterator<T>(o, " "));
+  T lanes[N];
+  std::memcpy(lanes, &v, sizeof(lanes));
+  std::copy_n(lanes, N, std::ostream_iterator<decltype(+T{})>(o, " "));
   return o;
 }
 
@@ -42,10 +70,127 @@ inline const T* end(const vec<T, N>& x) {
 
 
 // dependency breakers
-void zeroUpper() { _mm256_zeroupper(); }
-void zeroAll() { _mm256_zeroall(); }
+inline void zeroUpper() { _mm256_zeroupper(); }
+inline void zeroAll() { _mm256_zeroall(); }
+
+
+// iterators over arrays as sequences of vec<T, N>s, consecutive vecs stride elements apart: N for contiguous blocks,
+// e.g. a row length to walk down a column of blocks. Dereferencing yields a vec_reference: converting it loads,
+// assigning to it stores -- std::transform, std::accumulate, std::fill and friends work on vec ranges directly, generic
+// lambdas see the reference and get vec operators through the conversion. T may be const for read-only ranges.
+template <typename T, std::size_t N>
+class vec_reference final {
+public:
+  using Vec = vec<std::remove_const_t<T>, N>;
+
+  explicit vec_reference(T* first) : ptr(first) {}
+
+  operator Vec() const { return {ptr, ptr + N}; }
+
+  const vec_reference& operator=(Vec x) const {
+    x.store(ptr, ptr + N);
+    return *this;
+  }
+
+  const vec_reference& operator=(const vec_reference& other) const { return *this = static_cast<Vec>(other); }
+
+private:
+  T* ptr;
+};
+
+template <typename T, std::size_t N>
+class vec_iterator final {
+public:
+  using value_type = vec<std::remove_const_t<T>, N>;
+  using difference_type = std::ptrdiff_t;
+  using reference = vec_reference<T, N>;
+  using pointer = void;
+  // as std::vector<bool>'s proxy iterators, random access in all but the reference type
+  using iterator_category = std::random_access_iterator_tag;
+
+  vec_iterator() : ptr(nullptr), step(N) {}
+  explicit vec_iterator(T* first, difference_type stride = N) : ptr(first), step(stride) {}
+
+  // mutable to const
+  template <typename U, typename = std::enable_if_t<std::is_same<const U, T>::value>>
+  vec_iterator(const vec_iterator<U, N>& other) : ptr(other.base()), step(other.stride()) {}
+
+  T* base() const { return ptr; }
+  difference_type stride() const { return step; }
 
+  reference operator*() const { return reference{ptr}; }
+  reference operator[](difference_type k) const { return reference{ptr + k * step}; }
 
-// TODO(daniel): strided iterators: vec_iterator<T,N>, make_vec_iterator<T,N>() -- iterator adaptors awful to implement
-// :(
+  vec_iterator& operator++() {
+    ptr += step;
+    return *this;
+  }
+
+  vec_iterator& operator--() {
+    ptr -= step;
+    return *this;
+  }
+
+  vec_iterator operator++(int) {
+    auto rv = *this;
+    ++*this;
+    return rv;
+  }
+
+  vec_iterator operator--(int) {
+    auto rv = *this;
+    --*this;
+    return rv;
+  }
+
+  vec_iterator& operator+=(difference_type k) {
+    ptr += k * step;
+    return *this;
+  }
+
+  vec_iterator& operator-=(difference_type k) {
+    ptr -= k * step;
+    return *this;
+  }
+
+  friend vec_iterator operator+(vec_iterator it, difference_type k) { return it += k; }
+  friend vec_iterator operator+(difference_type k, vec_iterator it) { return it += k; }
+  friend vec_iterator operator-(vec_iterator it, difference_type k) { return it -= k; }
+  friend difference_type operator-(const vec_iterator& lhs, const vec_iterator& rhs) {
+    return (lhs.ptr - rhs.ptr) / lhs.step;
+  }
+
+  friend bool operator==(const vec_iterator& lhs, const vec_iterator& rhs) { return lhs.ptr == rhs.ptr; }
+  friend bool operator!=(const vec_iterator& lhs, const vec_iterator& rhs) { return lhs.ptr != rhs.ptr; }
+  friend bool operator<(const vec_iterator& lhs, const vec_iterator& rhs) { return lhs.ptr < rhs.ptr; }
+  friend bool operator>(const vec_iterator& lhs, const vec_iterator& rhs) { return lhs.ptr > rhs.ptr; }
+  friend bool operator<=(const vec_iterator& lhs, const vec_iterator& rhs) { return lhs.ptr <= rhs.ptr; }
+  friend bool operator>=(const vec_iterator& lhs, const vec_iterator& rhs) { return lhs.ptr >= rhs.ptr; }
+
+private:
+  T* ptr;
+  difference_type step;
+};
+
+template <std::size_t N, typename T>
+inline vec_iterator<T, N> make_vec_iterator(T* first, std::ptrdiff_t stride = N) {
+  return vec_iterator<T, N>{first, stride};
+}
+
+// [first, last) as contiguous vec<T, N>s for range-based for loops; the length has to be a multiple of N, see VecLoop.h
+// for arrays of any length
+template <typename T, std::size_t N>
+struct vec_range final {
+  vec_iterator<T, N> first, last;
+
+  vec_iterator<T, N> begin() const { return first; }
+  vec_iterator<T, N> end() const { return last; }
+};
+
+template <std::size_t N, typename T>
+inline vec_range<T, N> make_vec_range(T* first, T* last) {
+  assert((last - first) % static_cast<std::ptrdiff_t>(N) == 0);
+  return {make_vec_iterator<N>(first), make_vec_iterator<N>(last)};
+}
+}
 }
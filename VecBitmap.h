@@ -0,0 +1,288 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <immintrin.h>
+#include "Vec8Int.h"
+#include "Vec4Long.h"
+#include "Vec32Byte.h"
+#include "VecCopy.h"
+#include "VecMemory.h"
+#include "VecSort.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// bitmaps for query filters: bit i set for row i, 256 bits (a vec8i) per block. Combining two or more bitmaps --
+// intersect, unite, subtract (and not), symmetricDifference -- counts the result's bits in the same pass, the *Count
+// versions count without writing it out:
+//   popcount: per byte by two nibble lookups (vpshufb) into a table of 16 counts, summed into 64 bit lanes by vpsadbw
+//   Harley-Seal: sixteen blocks go through a tree of carry-save adders -- full adders on whole registers, ones, twos,
+//   fours, eights -- and only the sixteens are popcounted, about a sixth of the lookups per block
+// Indices convert to bitmaps by setting bits one at a time and back eight bits at a time: a byte's set bits select a
+// left-pack permute of its eight indices, see VecSort.h.
+
+class Bitmap final {
+public:
+  using Word = std::uint64_t;
+  static const constexpr std::size_t BlockBits = 256u;
+  static const constexpr std::size_t BlockWords = BlockBits / 64u;
+
+  // bits clear
+  explicit Bitmap(std::size_t bits = 0) : length(bits), storage((bits + BlockBits - 1u) / BlockBits * BlockWords) {
+    assert(bits <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()) + 1u);
+  }
+
+  // bits, set for the indices in [first, last), each in [0, bits)
+  Bitmap(std::size_t bits, const std::int32_t* first, const std::int32_t* last) : Bitmap(bits) {
+    for (; first != last; ++first)
+      set(static_cast<std::size_t>(*first));
+  }
+
+  std::size_t size() const { return length; }
+  std::size_t blocks() const { return storage.size() / BlockWords; }
+
+  bool test(std::size_t i) const { return (storage[i / 64u] >> i % 64u & 1u) != 0; }
+  void reset(std::size_t i) { storage[i / 64u] &= ~(Word{1} << i % 64u); }
+
+  void set(std::size_t i) {
+    assert(i < length);
+    storage[i / 64u] |= Word{1} << i % 64u;
+  }
+
+  // whole blocks, 32 byte aligned; bits past size() are clear and have to stay clear
+  const Word* words() const { return storage.data(); }
+  Word* words() { return storage.data(); }
+
+  vec8i block(std::size_t i) const {
+    return {_mm256_load_si256(reinterpret_cast<const __m256i*>(words() + i * BlockWords))};
+  }
+
+  void block(std::size_t i, const vec8i& x) {
+    _mm256_store_si256(reinterpret_cast<__m256i*>(words() + i * BlockWords), x.ymm);
+  }
+
+  // non-temporal, see VecCopy.h
+  void block_stream(std::size_t i, const vec8i& x) {
+    _mm256_stream_si256(reinterpret_cast<__m256i*>(words() + i * BlockWords), x.ymm);
+  }
+
+  // set bits
+  std::size_t count() const;
+
+  // the indices of the set bits in ascending order to [first, last), which needs room for all of them; returns their
+  // count. One pass: full eight lane stores while they fit the range, masked ones after that.
+  std::size_t indices(std::int32_t* first, std::int32_t* last) const;
+
+private:
+  std::size_t length;
+  AlignedVector<Word, 32u> storage;
+};
+
+
+// per byte set bits
+inline vec32b popcount(const vec32b& x) {
+  const vec32b counts{_mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                       0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4)};
+  const vec32b low{0x0F};
+
+  const auto lower = shuffle(counts, x & low);
+  const auto upper = shuffle(counts, vec32b{_mm256_srli_epi16(x.ymm, 4)} & low);
+  return lower + upper;
+}
+
+namespace detail {
+
+  // set bits per 64 bit lane
+  inline vec4q popcount64(const vec8i& x) { return sumAbsDiffUnsigned(popcount(vec32b{x.ymm}), vec32b{0}); }
+
+  // carry-save adder: high, low = a + b + c bitwise; low may alias a
+  inline void csa(vec8i& high, vec8i& low, const vec8i& a, const vec8i& b, const vec8i& c) {
+    const auto u = a ^ b;
+    high = (a & b) | (u & c);
+    low = u ^ c;
+  }
+
+  // set bits in block(0) .. block(n - 1), Harley-Seal over sixteen blocks at a time
+  template <typename Block>
+  inline std::size_t harleySeal(std::size_t n, Block block) {
+    vec4q total{0};
+    vec8i ones, twos, fours, eights, sixteens;
+    vec8i twosA, twosB, foursA, foursB, eightsA, eightsB;
+
+    std::size_t i{0};
+
+    for (; i + 16u <= n; i += 16u) {
+      csa(twosA, ones, ones, block(i), block(i + 1u));
+      csa(twosB, ones, ones, block(i + 2u), block(i + 3u));
+      csa(foursA, twos, twos, twosA, twosB);
+      csa(twosA, ones, ones, block(i + 4u), block(i + 5u));
+      csa(twosB, ones, ones, block(i + 6u), block(i + 7u));
+      csa(foursB, twos, twos, twosA, twosB);
+      csa(eightsA, fours, fours, foursA, foursB);
+      csa(twosA, ones, ones, block(i + 8u), block(i + 9u));
+      csa(twosB, ones, ones, block(i + 10u), block(i + 11u));
+      csa(foursA, twos, twos, twosA, twosB);
+      csa(twosA, ones, ones, block(i + 12u), block(i + 13u));
+      csa(twosB, ones, ones, block(i + 14u), block(i + 15u));
+      csa(foursB, twos, twos, twosA, twosB);
+      csa(eightsB, fours, fours, foursA, foursB);
+      csa(sixteens, eights, eights, eightsA, eightsB);
+
+      total = total + popcount64(sixteens);
+    }
+
+    total = shiftLeftZeroExtend<4>(total);
+    total = total + shiftLeftZeroExtend<3>(popcount64(eights));
+    total = total + shiftLeftZeroExtend<2>(popcount64(fours));
+    total = total + shiftLeftZeroExtend<1>(popcount64(twos));
+    total = total + popcount64(ones);
+
+    for (; i < n; ++i)
+      total = total + popcount64(block(i));
+
+    return static_cast<std::size_t>(hSum(total));
+  }
+
+  // block i of the bitmaps combined by op, written to out unless null; all of the same size. Outputs of at least half
+  // the last level cache are streamed as in VecCopy.h: without the reads for ownership memory bound combines are some
+  // fifteen percent faster.
+  template <typename Op, typename... Rest>
+  inline std::size_t combine(Bitmap* out, Op op, const Bitmap& first, const Rest&... rest) {
+    using expand = int[];
+    (void)expand{0, (assert(rest.size() == first.size()), 0)...};
+    assert(out == nullptr || out->size() == first.size());
+
+    const auto blocks = first.blocks();
+
+    const auto combined = [&](std::size_t i) {
+      auto x = first.block(i);
+      (void)expand{0, (x = op(x, rest.block(i)), 0)...};
+      return x;
+    };
+
+    if (out == nullptr)
+      return harleySeal(blocks, combined);
+
+    if (blocks * Bitmap::BlockBits / 8u < streamingBytes())
+      return harleySeal(blocks, [&](std::size_t i) {
+        const auto x = combined(i);
+        out->block(i, x);
+        return x;
+      });
+
+    const auto rv = harleySeal(blocks, [&](std::size_t i) {
+      const auto x = combined(i);
+      out->block_stream(i, x);
+      return x;
+    });
+
+    _mm_sfence();
+    return rv;
+  }
+
+  struct And final {
+    vec8i operator()(const vec8i& lhs, const vec8i& rhs) const { return lhs & rhs; }
+  };
+
+  struct Or final {
+    vec8i operator()(const vec8i& lhs, const vec8i& rhs) const { return lhs | rhs; }
+  };
+
+  struct AndNot final {
+    vec8i operator()(const vec8i& lhs, const vec8i& rhs) const { return andNot(lhs, rhs); }
+  };
+
+  struct Xor final {
+    vec8i operator()(const vec8i& lhs, const vec8i& rhs) const { return lhs ^ rhs; }
+  };
+}
+
+
+inline std::size_t Bitmap::count() const {
+  return detail::harleySeal(blocks(), [this](std::size_t i) { return block(i); });
+}
+
+inline std::size_t Bitmap::indices(std::int32_t* first, std::int32_t* last) const {
+  const auto& table = detail::leftPackTable();
+  const vec8i lanes{0, 1, 2, 3, 4, 5, 6, 7};
+
+  const auto room = static_cast<std::size_t>(last - first);
+  std::size_t written{0};
+
+  for (std::size_t i{0}; i < storage.size(); ++i) {
+    // zero words are skipped, a sparse bitmap costs a compare per 64 bits
+    for (auto word = storage[i], offset = Word{i * 64u}; word != 0; word >>= 8, offset += 8u) {
+      const auto mask = static_cast<int>(word & 0xFFu);
+      if (mask == 0)
+        continue;
+
+      // the table puts the lanes with clear bits first
+      const auto* index = table.index[~mask & 0xFF];
+      auto packed = permute(lanes, vec8i{index, index + 8}) + vec8i{static_cast<vec8i::Value>(offset)};
+      const auto count = static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(mask)));
+
+      assert(written + count <= room);
+
+      if (written + 8u <= room)
+        packed.store(first + written, first + written + 8u);
+      else
+        packed.store_partial(first + written, first + written + count);
+
+      written += count;
+    }
+  }
+
+  return written;
+}
+
+
+// out = a & b & .., all of the same size; out may be one of them. Returns the bits set in out.
+template <typename... Rest>
+inline std::size_t intersect(Bitmap& out, const Bitmap& first, const Rest&... rest) {
+  return detail::combine(&out, detail::And{}, first, rest...);
+}
+
+// |a & b & ..|
+template <typename... Rest>
+inline std::size_t intersectCount(const Bitmap& first, const Rest&... rest) {
+  return detail::combine(nullptr, detail::And{}, first, rest...);
+}
+
+// out = a | b | ..
+template <typename... Rest>
+inline std::size_t unite(Bitmap& out, const Bitmap& first, const Rest&... rest) {
+  return detail::combine(&out, detail::Or{}, first, rest...);
+}
+
+template <typename... Rest>
+inline std::size_t uniteCount(const Bitmap& first, const Rest&... rest) {
+  return detail::combine(nullptr, detail::Or{}, first, rest...);
+}
+
+// out = a & ~b & ~c ..
+template <typename... Rest>
+inline std::size_t subtract(Bitmap& out, const Bitmap& first, const Rest&... rest) {
+  return detail::combine(&out, detail::AndNot{}, first, rest...);
+}
+
+template <typename... Rest>
+inline std::size_t subtractCount(const Bitmap& first, const Rest&... rest) {
+  return detail::combine(nullptr, detail::AndNot{}, first, rest...);
+}
+
+// out = a ^ b ^ ..
+template <typename... Rest>
+inline std::size_t symmetricDifference(Bitmap& out, const Bitmap& first, const Rest&... rest) {
+  return detail::combine(&out, detail::Xor{}, first, rest...);
+}
+
+template <typename... Rest>
+inline std::size_t symmetricDifferenceCount(const Bitmap& first, const Rest&... rest) {
+  return detail::combine(nullptr, detail::Xor{}, first, rest...);
+}
+}
+}
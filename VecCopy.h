@@ -0,0 +1,134 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <immintrin.h>
+#include "Detect.h"
+#include "VecLoop.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// copy, fill and transform sized for memory bandwidth: with Stores::automatic, outputs of at least half the last level
+// cache (see cpu::lastLevelCacheBytes) go out with non-temporal stores. Regular stores first read every destination
+// line for ownership only to overwrite it -- three bytes of traffic per byte copied instead of two -- and evict the
+// caches' other contents on the way; streaming ones write whole lines straight to memory from the write combining
+// buffers, but make small outputs slower as they are no longer in cache afterwards.
+//   head: elements up to the first cache line boundary of out, masked
+//   body: whole cache lines, streamed; inputs prefetched PrefetchBytes ahead
+//   tail: the remainder, masked; then an sfence, after which the streamed stores are visible to other cores
+
+enum class Stores {
+  automatic, // streaming from half the last level cache on
+  regular,   // through the caches, e.g. for outputs read again right away
+  streaming, // around the caches, e.g. for outputs not read again soon
+};
+
+namespace detail {
+
+  static const constexpr std::size_t CacheLineBytes = 64u;
+
+  // software prefetch distance for the streamed body: the hardware prefetchers stop at 4 KiB pages, the prefetches
+  // cover the first lines of the next page. The pf variants of copy/DRAM in Benchmarks.cc sweep it from none to 4 KiB;
+  // on the machines measured so far they are all within the run-to-run noise, retune with them on new ones.
+  static const constexpr std::size_t PrefetchBytes = 1024u;
+
+  // output bytes from which Stores::automatic streams
+  inline std::size_t streamingBytes() {
+    static const std::size_t cached = cpu::lastLevelCacheBytes() / 2u;
+    return cached;
+  }
+
+  // out[i] = produce(i, count) for i in [0, n), native<T> blocks at a time: count is V::Size but for the head and tail,
+  // their lanes past count are not stored. Reads of in are prefetched Prefetch bytes ahead in the streamed body; in may
+  // be null.
+  template <std::size_t Prefetch = PrefetchBytes, typename T, typename Produce>
+  inline void write(T* out, std::size_t n, const T* in, Stores stores, Produce produce) {
+    using V = native<T>;
+    static const constexpr auto Size = V::Size;
+    static const constexpr auto LineSize = CacheLineBytes / sizeof(T);
+    static_assert(LineSize % Size == 0, "blocks have to tile cache lines");
+
+    const auto head = headSize<CacheLineBytes>(out, n);
+    const auto aligned = reinterpret_cast<std::uintptr_t>(out + head) % CacheLineBytes == 0;
+
+    const auto stream = aligned && (stores == Stores::streaming ||
+                                    (stores == Stores::automatic && n * sizeof(T) >= streamingBytes()));
+
+    const auto store = [&](std::size_t i, std::size_t count) {
+      if (count == Size)
+        produce(i, Size).store(out + i, out + i + Size);
+      else
+        produce(i, count).store_partial(out + i, out + i + count);
+    };
+
+    if (!stream) {
+      blocks<Size>(out, n, store);
+      return;
+    }
+
+    std::size_t i{0};
+
+    for (std::size_t count; i < head; i += count) {
+      count = std::min(Size, head - i);
+      store(i, count);
+    }
+
+    for (; i + LineSize <= n; i += LineSize) {
+      if (in != nullptr)
+        _mm_prefetch(reinterpret_cast<const char*>(in + i) + Prefetch, _MM_HINT_T0);
+
+      for (std::size_t j{0}; j < LineSize; j += Size)
+        produce(i + j, Size).store_aligned_stream(out + i + j, out + i + j + Size);
+    }
+
+    for (; i < n; i += Size)
+      store(i, std::min(Size, n - i));
+
+    _mm_sfence();
+  }
+}
+
+
+// [first, last) to out; out must not overlap the range, see std::copy and memcpy
+template <typename T>
+inline void copy(const T* first, const T* last, T* out, Stores stores = Stores::automatic) {
+  using V = native<T>;
+
+  detail::write(out, static_cast<std::size_t>(last - first), first, stores, [&](std::size_t i, std::size_t count) {
+    V x;
+    if (count == V::Size)
+      x.load(first + i, first + i + V::Size);
+    else
+      x.load_partial(first + i, first + i + count);
+    return x;
+  });
+}
+
+// value to all of [first, last), see std::fill and memset
+template <typename T>
+inline void fill(T* first, T* last, T value, Stores stores = Stores::automatic) {
+  using V = native<T>;
+  const V x{value};
+
+  detail::write(first, static_cast<std::size_t>(last - first), static_cast<const T*>(nullptr), stores,
+                [&](std::size_t, std::size_t) { return x; });
+}
+
+// out[i] = kernel(x[i]) for x in [first, last) as in VecLoop.h, the stores as asked for; out may alias first
+template <typename T, typename Kernel>
+inline void transform(const T* first, const T* last, T* out, Kernel kernel, Stores stores) {
+  using V = native<T>;
+
+  detail::write(out, static_cast<std::size_t>(last - first), first, stores, [&](std::size_t i, std::size_t count) {
+    V x;
+    if (count == V::Size)
+      x.load(first + i, first + i + V::Size);
+    else
+      x.load_partial(first + i, first + i + count);
+    return kernel(x);
+  });
+}
+}
+}
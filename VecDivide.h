@@ -0,0 +1,161 @@
+#pragma once
+
+#include <cstdint>
+#include <stdexcept>
+#include <immintrin.h>
+#include "Vec8Int.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// division by a divisor fixed at runtime, e.g. for bucketing or modular hashing: the divisor is turned into a magic
+// multiplier and shift once (Hacker's Delight, chapter 10; as in libdivide), after that x / d is a multiply-high, a
+// few adds and shifts -- a fraction of the cost of scalar idiv per lane.
+//
+// Divisor<std::int32_t> rounds towards zero like C++ division, Divisor<std::uint32_t> treats the lanes as unsigned.
+// Results match the scalar operators for all inputs; INT32_MIN / -1 wraps around to INT32_MIN.
+
+template <typename T>
+class Divisor;
+
+
+template <>
+class Divisor<std::int32_t> final {
+public:
+  using Value = std::int32_t;
+
+  explicit Divisor(Value d) : divisor(d), magic(0), shift(0), addend(Add::none), special(Special::none) {
+    if (d == 0)
+      throw std::invalid_argument{"division by zero"};
+
+    if (d == 1 || d == -1) {
+      special = d == 1 ? Special::one : Special::minusOne;
+      return;
+    }
+
+    // Hacker's Delight, figure 10-1; valid for 2 <= |d| <= 2^31
+    const std::uint32_t two31 = 0x80000000u;
+    const auto ad = d < 0 ? 0u - static_cast<std::uint32_t>(d) : static_cast<std::uint32_t>(d);
+    const auto t = two31 + (static_cast<std::uint32_t>(d) >> 31);
+    const auto anc = t - 1u - t % ad;
+
+    int p = 31;
+    auto q1 = two31 / anc, r1 = two31 - q1 * anc;
+    auto q2 = two31 / ad, r2 = two31 - q2 * ad;
+    std::uint32_t delta;
+
+    do {
+      ++p;
+      q1 *= 2u, r1 *= 2u;
+      if (r1 >= anc)
+        ++q1, r1 -= anc;
+      q2 *= 2u, r2 *= 2u;
+      if (r2 >= ad)
+        ++q2, r2 -= ad;
+      delta = ad - r2;
+    } while (q1 < delta || (q1 == delta && r1 == 0));
+
+    const auto m = static_cast<std::int32_t>(d < 0 ? 0u - (q2 + 1u) : q2 + 1u);
+    magic = vec8i{m};
+    shift = p - 32;
+
+    if (d > 0 && m < 0)
+      addend = Add::plus;
+    else if (d < 0 && m > 0)
+      addend = Add::minus;
+  }
+
+  Value value() const { return divisor; }
+
+  vec8i divide(const vec8i& x) const {
+    switch (special) {
+    case Special::one:
+      return x;
+    case Special::minusOne:
+      return -x;
+    case Special::none:
+      break;
+    }
+
+    auto q = mulHi(magic, x);
+
+    if (addend == Add::plus)
+      q += x;
+    else if (addend == Add::minus)
+      q -= x;
+
+    q = vec8i{_mm256_sra_epi32(q.ymm, _mm_cvtsi32_si128(shift))};
+    return q + shiftRightZeroExtend<31>(q);
+  }
+
+private:
+  enum class Add { none, plus, minus };
+  enum class Special { none, one, minusOne };
+
+  Value divisor;
+  vec8i magic;
+  int shift;
+  Add addend;
+  Special special;
+};
+
+
+template <>
+class Divisor<std::uint32_t> final {
+public:
+  using Value = std::uint32_t;
+
+  // round-up variant, one formula for all divisors: l = ceil(log2 d), m = 2^32 (2^l - d) / d + 1
+  explicit Divisor(Value d) : divisor(d), magic(0), shift1(0), shift2(0) {
+    if (d == 0)
+      throw std::invalid_argument{"division by zero"};
+
+    int l = 0;
+    while (l < 32 && (std::uint64_t{1} << l) < d)
+      ++l;
+
+    const auto m = ((std::uint64_t{1} << l) - d) * (std::uint64_t{1} << 32) / d + 1u;
+    magic = vec8i{static_cast<std::int32_t>(static_cast<std::uint32_t>(m))};
+    shift1 = l < 1 ? l : 1;
+    shift2 = l > 1 ? l - 1 : 0;
+  }
+
+  Value value() const { return divisor; }
+
+  // lanes as unsigned integers
+  vec8i divide(const vec8i& x) const {
+    const auto t = mulHiUnsigned(magic, x);
+    const auto halved = _mm256_srl_epi32((x - t).ymm, _mm_cvtsi32_si128(shift1));
+    return {_mm256_srl_epi32((t + vec8i{halved}).ymm, _mm_cvtsi32_si128(shift2))};
+  }
+
+private:
+  Value divisor;
+  vec8i magic;
+  int shift1;
+  int shift2;
+};
+
+
+template <typename T>
+inline vec8i operator/(const vec8i& lhs, const Divisor<T>& rhs) {
+  return rhs.divide(lhs);
+}
+
+// lhs - (lhs / rhs) * rhs: the sign follows lhs for signed divisors, like C++'s %
+template <typename T>
+inline vec8i operator%(const vec8i& lhs, const Divisor<T>& rhs) {
+  return lhs - rhs.divide(lhs) * vec8i{static_cast<vec8i::Value>(rhs.value())};
+}
+
+template <typename T>
+inline vec8i& operator/=(vec8i& lhs, const Divisor<T>& rhs) {
+  return lhs = lhs / rhs;
+}
+
+template <typename T>
+inline vec8i& operator%=(vec8i& lhs, const Divisor<T>& rhs) {
+  return lhs = lhs % rhs;
+}
+}
+}
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <limits>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Vec8Float.h"
+#include "Vec8Int.h"
+#include "VecLoop.h"
+#include "VecMemory.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// lazy whole-array expressions: operators on ArrayViews build expression trees, assigning one to an ArrayView evaluates
+// it in a single pass, one vec<T, 8> block at a time with all intermediates in registers -- no temporary arrays
+//
+//   z = a * b + ceil(c);
+//
+// a * b + c and c + a * b are contracted to fused multiply-adds (a * b - c and c - a * b likewise), rounding once
+// instead of twice. Operands may alias the assigned-to view at the same index only, not shifted views of it.
+
+template <typename Derived>
+struct Expr {
+  const Derived& self() const { return static_cast<const Derived&>(*this); }
+};
+
+
+namespace detail {
+
+  // size of unsized operands such as scalars
+  static const constexpr std::size_t Unsized = std::numeric_limits<std::size_t>::max();
+
+  inline std::size_t commonSize(std::size_t n) { return n; }
+
+  template <typename... Sizes>
+  inline std::size_t commonSize(std::size_t lhs, std::size_t rhs, Sizes... rest) {
+    assert(lhs == Unsized || rhs == Unsized || lhs == rhs);
+    return commonSize(std::min(lhs, rhs), rest...);
+  }
+
+  template <typename T>
+  inline vec<T, 8u> loadBlock(const T* first, std::size_t i, std::size_t count) {
+    using V = vec<T, 8u>;
+
+    if (count == V::Size)
+      return V(first + i, first + i + V::Size);
+
+    V x{T{0}};
+    x.load_partial(first + i, first + i + count);
+    return x;
+  }
+
+  template <typename T>
+  inline void storeBlock(const vec<T, 8u>& x, T* first, std::size_t i, std::size_t count) {
+    using V = vec<T, 8u>;
+    auto y = x;
+
+    if (count == V::Size)
+      y.store(first + i, first + i + V::Size);
+    else
+      y.store_partial(first + i, first + i + count);
+  }
+
+  // a broadcast scalar
+  template <typename T>
+  struct Scalar final : Expr<Scalar<T>> {
+    using Value = T;
+
+    explicit Scalar(Value x) : value(x) {}
+
+    vec<Value, 8u> operator()(std::size_t, std::size_t) const { return vec<Value, 8u>{value}; }
+    std::size_t size() const { return Unsized; }
+
+    Value value;
+  };
+
+  template <typename First, typename...>
+  struct FirstOf {
+    using type = First;
+  };
+
+  // Op applied to Args, which are held by value: leaves are views, so trees are a few pointers large
+  template <typename Op, typename... Args>
+  struct Node final : Expr<Node<Op, Args...>> {
+    using Value = typename FirstOf<Args...>::type::Value;
+
+    explicit Node(const Args&... xs) : args(xs...), n(commonSize(xs.size()...)) {}
+
+    vec<Value, 8u> operator()(std::size_t i, std::size_t count) const {
+      return apply(i, count, std::index_sequence_for<Args...>{});
+    }
+
+    std::size_t size() const { return n; }
+
+    std::tuple<Args...> args;
+    std::size_t n;
+
+  private:
+    template <std::size_t... K>
+    vec<Value, 8u> apply(std::size_t i, std::size_t count, std::index_sequence<K...>) const {
+      return evaluate(Op{}, i, count, std::get<K>(args)...);
+    }
+  };
+
+  template <typename Op, typename... Args>
+  inline Node<Op, Args...> node(const Args&... args) {
+    return Node<Op, Args...>{args...};
+  }
+
+  // a * b + c, fused where there is an instruction for it
+  inline vec8f mulAdd(const vec8f& a, const vec8f& b, const vec8f& c) { return fusedMulAdd(a, b, c); }
+  inline vec8f mulSub(const vec8f& a, const vec8f& b, const vec8f& c) { return fusedMulSub(a, b, c); }
+  inline vec8f negateMulAdd(const vec8f& a, const vec8f& b, const vec8f& c) { return fusedMulNegateAdd(a, b, c); }
+
+  template <typename V>
+  inline V mulAdd(const V& a, const V& b, const V& c) { return a * b + c; }
+  template <typename V>
+  inline V mulSub(const V& a, const V& b, const V& c) { return a * b - c; }
+  template <typename V>
+  inline V negateMulAdd(const V& a, const V& b, const V& c) { return c - a * b; }
+
+  struct Add final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return lhs + rhs; }
+  };
+
+  struct Sub final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return lhs - rhs; }
+  };
+
+  struct Mul final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return lhs * rhs; }
+  };
+
+  struct Div final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return lhs / rhs; }
+  };
+
+  struct Negate final {
+    template <typename V>
+    V operator()(const V& x) const { return -x; }
+  };
+
+  struct Equal final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return lhs == rhs; }
+  };
+
+  struct NotEqual final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return lhs != rhs; }
+  };
+
+  struct Less final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return lhs < rhs; }
+  };
+
+  struct Greater final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return lhs > rhs; }
+  };
+
+  struct LessEqual final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return lhs <= rhs; }
+  };
+
+  struct GreaterEqual final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return lhs >= rhs; }
+  };
+
+  struct Min final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return min(lhs, rhs); }
+  };
+
+  struct Max final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs) const { return max(lhs, rhs); }
+  };
+
+  struct Abs final {
+    template <typename V>
+    V operator()(const V& x) const { return abs(x); }
+  };
+
+  struct Ceil final {
+    template <typename V>
+    V operator()(const V& x) const { return ceil(x); }
+  };
+
+  struct Floor final {
+    template <typename V>
+    V operator()(const V& x) const { return floor(x); }
+  };
+
+  struct Sqrt final {
+    template <typename V>
+    V operator()(const V& x) const { return sqrt(x); }
+  };
+
+  struct Blend final {
+    template <typename V>
+    V operator()(const V& lhs, const V& rhs, const V& mask) const { return blend(lhs, rhs, mask); }
+  };
+
+  struct MulAdd final {
+    template <typename V>
+    V operator()(const V& a, const V& b, const V& c) const { return mulAdd(a, b, c); }
+  };
+
+  template <typename Op, typename... Args>
+  inline auto evaluate(Op op, std::size_t i, std::size_t count, const Args&... args) {
+    return op(args(i, count)...);
+  }
+
+  // fma contraction: overloads for sums and differences with a product on either side
+  template <typename A, typename B, typename C>
+  inline auto evaluate(Add, std::size_t i, std::size_t count, const Node<Mul, A, B>& product, const C& c) {
+    return mulAdd(std::get<0>(product.args)(i, count), std::get<1>(product.args)(i, count), c(i, count));
+  }
+
+  template <typename A, typename B, typename C>
+  inline auto evaluate(Add, std::size_t i, std::size_t count, const C& c, const Node<Mul, A, B>& product) {
+    return mulAdd(std::get<0>(product.args)(i, count), std::get<1>(product.args)(i, count), c(i, count));
+  }
+
+  template <typename A, typename B, typename C, typename D>
+  inline auto evaluate(Add, std::size_t i, std::size_t count, const Node<Mul, A, B>& product,
+                       const Node<Mul, C, D>& other) {
+    return mulAdd(std::get<0>(product.args)(i, count), std::get<1>(product.args)(i, count), other(i, count));
+  }
+
+  template <typename A, typename B, typename C>
+  inline auto evaluate(Sub, std::size_t i, std::size_t count, const Node<Mul, A, B>& product, const C& c) {
+    return mulSub(std::get<0>(product.args)(i, count), std::get<1>(product.args)(i, count), c(i, count));
+  }
+
+  template <typename A, typename B, typename C>
+  inline auto evaluate(Sub, std::size_t i, std::size_t count, const C& c, const Node<Mul, A, B>& product) {
+    return negateMulAdd(std::get<0>(product.args)(i, count), std::get<1>(product.args)(i, count), c(i, count));
+  }
+
+  template <typename A, typename B, typename C, typename D>
+  inline auto evaluate(Sub, std::size_t i, std::size_t count, const Node<Mul, A, B>& product,
+                       const Node<Mul, C, D>& other) {
+    return mulSub(std::get<0>(product.args)(i, count), std::get<1>(product.args)(i, count), other(i, count));
+  }
+
+  template <typename E>
+  inline Scalar<typename E::Value> scalar(const Expr<E>&, typename E::Value x) {
+    return Scalar<typename E::Value>{x};
+  }
+
+  // dst[i] = e[i] for all i, blockwise along dst's alignment
+  template <typename T, typename E>
+  inline void assign(T* dst, std::size_t n, const E& e) {
+    static_assert(std::is_same<T, typename E::Value>::value, "expression and destination have to hold the same type");
+    assert(e.size() == Unsized || e.size() == n);
+
+    blocks<vec<T, 8u>::Size>(dst, n, [&](std::size_t i, std::size_t count) { storeBlock(e(i, count), dst, i, count); });
+  }
+}
+
+
+// [first, first + n) as an expression leaf; views of mutable elements can be assigned expressions, views copy elements
+template <typename T>
+struct ArrayView final : Expr<ArrayView<T>> {
+  using Value = std::remove_const_t<T>;
+
+  ArrayView(T* data, std::size_t size) : first(data), n(size) {}
+  ArrayView(const ArrayView&) = default;
+
+  // const views from mutable ones
+  template <typename U, typename = std::enable_if_t<std::is_same<const U, T>::value>>
+  ArrayView(const ArrayView<U>& other) : first(other.data()), n(other.size()) {}
+
+  vec<Value, 8u> operator()(std::size_t i, std::size_t count) const { return detail::loadBlock(first, i, count); }
+
+  T* data() const { return first; }
+  std::size_t size() const { return n; }
+
+  T& operator[](std::size_t index) const {
+    assert(index < n);
+    return first[index];
+  }
+
+  template <typename E>
+  ArrayView& operator=(const Expr<E>& e) {
+    detail::assign(first, n, e.self());
+    return *this;
+  }
+
+  ArrayView& operator=(const ArrayView& other) {
+    detail::assign(first, n, other);
+    return *this;
+  }
+
+  ArrayView& operator=(Value x) {
+    detail::assign(first, n, detail::Scalar<Value>{x});
+    return *this;
+  }
+
+  template <typename E>
+  ArrayView& operator+=(const Expr<E>& e) { return *this = detail::node<detail::Add>(*this, e.self()); }
+  template <typename E>
+  ArrayView& operator-=(const Expr<E>& e) { return *this = detail::node<detail::Sub>(*this, e.self()); }
+  template <typename E>
+  ArrayView& operator*=(const Expr<E>& e) { return *this = detail::node<detail::Mul>(*this, e.self()); }
+  template <typename E>
+  ArrayView& operator/=(const Expr<E>& e) { return *this = detail::node<detail::Div>(*this, e.self()); }
+
+private:
+  T* first;
+  std::size_t n;
+};
+
+template <typename T>
+inline ArrayView<T> view(T* first, T* last) {
+  return {first, static_cast<std::size_t>(last - first)};
+}
+
+template <typename T, typename Allocator>
+inline ArrayView<T> view(std::vector<T, Allocator>& v) {
+  return {v.data(), v.size()};
+}
+
+template <typename T, typename Allocator>
+inline ArrayView<const T> view(const std::vector<T, Allocator>& v) {
+  return {v.data(), v.size()};
+}
+
+template <typename T, std::size_t Alignment>
+inline ArrayView<T> view(AlignedSpan<T, Alignment> span) {
+  return {span.data(), span.size()};
+}
+
+
+// element-wise operators: expression with expression, expression with scalar and scalar with expression
+#define AVX_EXPR_BINARY(FN, OP)                                                                                        \
+  template <typename L, typename R>                                                                                    \
+  inline auto FN(const Expr<L>& lhs, const Expr<R>& rhs) {                                                             \
+    return detail::node<detail::OP>(lhs.self(), rhs.self());                                                           \
+  }                                                                                                                    \
+  template <typename L>                                                                                                \
+  inline auto FN(const Expr<L>& lhs, typename L::Value rhs) {                                                          \
+    return detail::node<detail::OP>(lhs.self(), detail::scalar(lhs, rhs));                                             \
+  }                                                                                                                    \
+  template <typename R>                                                                                                \
+  inline auto FN(typename R::Value lhs, const Expr<R>& rhs) {                                                          \
+    return detail::node<detail::OP>(detail::scalar(rhs, lhs), rhs.self());                                             \
+  }
+
+AVX_EXPR_BINARY(operator+, Add)
+AVX_EXPR_BINARY(operator-, Sub)
+AVX_EXPR_BINARY(operator*, Mul)
+AVX_EXPR_BINARY(operator/, Div)
+AVX_EXPR_BINARY(operator==, Equal)
+AVX_EXPR_BINARY(operator!=, NotEqual)
+AVX_EXPR_BINARY(operator<, Less)
+AVX_EXPR_BINARY(operator>, Greater)
+AVX_EXPR_BINARY(operator<=, LessEqual)
+AVX_EXPR_BINARY(operator>=, GreaterEqual)
+AVX_EXPR_BINARY(min, Min)
+AVX_EXPR_BINARY(max, Max)
+
+#undef AVX_EXPR_BINARY
+
+template <typename E>
+inline auto operator-(const Expr<E>& x) { return detail::node<detail::Negate>(x.self()); }
+template <typename E>
+inline auto abs(const Expr<E>& x) { return detail::node<detail::Abs>(x.self()); }
+template <typename E>
+inline auto ceil(const Expr<E>& x) { return detail::node<detail::Ceil>(x.self()); }
+template <typename E>
+inline auto floor(const Expr<E>& x) { return detail::node<detail::Floor>(x.self()); }
+template <typename E>
+inline auto sqrt(const Expr<E>& x) { return detail::node<detail::Sqrt>(x.self()); }
+
+// lanes of rhs where mask, e.g. a comparison, is set and of lhs otherwise
+template <typename L, typename R, typename M>
+inline auto blend(const Expr<L>& lhs, const Expr<R>& rhs, const Expr<M>& mask) {
+  return detail::node<detail::Blend>(lhs.self(), rhs.self(), mask.self());
+}
+
+template <typename A, typename B, typename C>
+inline auto fusedMulAdd(const Expr<A>& a, const Expr<B>& b, const Expr<C>& c) {
+  return detail::node<detail::MulAdd>(a.self(), b.self(), c.self());
+}
+}
+}
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cassert>
+#include <cerrno>
+#include <cstddef>
+#include <algorithm>
+#include <string>
+#include <system_error>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "VecCopy.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// out-of-core arrays: column files -- flat float or int32 arrays in native byte order, no header -- memory-mapped and
+// fed to native<T> kernels in chunks of a few MiB. No I/O threads: while a chunk is computed the kernel reads the next
+// one ahead (madvise WILLNEED) and writes back the ones computed (sync_file_range); chunks done with are dropped from
+// the mapping (madvise DONTNEED) so that files larger than memory stream through a bounded resident set.
+
+// a file mapped whole, read-only or read-write; throws std::system_error when the file cannot be opened or mapped
+class MappedFile final {
+public:
+  // existing file, read-only
+  explicit MappedFile(const std::string& path)
+      : fd(::open(path.c_str(), O_RDONLY | O_CLOEXEC)), bytes(0), base(nullptr) {
+    if (fd < 0)
+      fail(path);
+
+    struct stat info;
+    if (::fstat(fd, &info) != 0)
+      fail(path);
+
+    bytes = static_cast<std::size_t>(info.st_size);
+    map(path, PROT_READ);
+  }
+
+  // file created or truncated to bytes, read-write; zero until written
+  MappedFile(const std::string& path, std::size_t size)
+      : fd(::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644)), bytes(size), base(nullptr) {
+    if (fd < 0)
+      fail(path);
+
+    if (::ftruncate(fd, static_cast<off_t>(bytes)) != 0)
+      fail(path);
+
+    map(path, PROT_READ | PROT_WRITE);
+  }
+
+  ~MappedFile() {
+    if (base != nullptr)
+      ::munmap(base, bytes);
+    ::close(fd);
+  }
+
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  std::size_t size() const { return bytes; }
+
+  // the mapping is page aligned; null for empty files
+  template <typename T>
+  const T* data() const {
+    return static_cast<const T*>(base);
+  }
+
+  template <typename T>
+  T* data() {
+    return static_cast<T*>(base);
+  }
+
+  // hints on the bytes [offset, offset + count), clamped to the file; offset has to be a multiple of the page size
+  void willNeed(std::size_t offset, std::size_t count) const { advise(offset, count, MADV_WILLNEED); }
+  void dontNeed(std::size_t offset, std::size_t count) const { advise(offset, count, MADV_DONTNEED); }
+  void sequential() const { advise(0, bytes, MADV_SEQUENTIAL); }
+
+  // starts writing dirty pages in [offset, offset + count) to disk without waiting for them
+  void writeBack(std::size_t offset, std::size_t count) const {
+#ifdef SYNC_FILE_RANGE_WRITE
+    ::sync_file_range(fd, static_cast<off_t>(offset), static_cast<off_t>(count), SYNC_FILE_RANGE_WRITE);
+#else
+    (void)offset, (void)count;
+#endif
+  }
+
+private:
+  [[noreturn]] void fail(const std::string& path) {
+    const auto error = errno;
+    if (fd >= 0)
+      ::close(fd);
+    throw std::system_error{error, std::generic_category(), path};
+  }
+
+  void map(const std::string& path, int protection) {
+    if (bytes == 0)
+      return;
+
+    auto* p = ::mmap(nullptr, bytes, protection, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED)
+      fail(path);
+
+    base = p;
+  }
+
+  // hints are only hints, failures are ignored
+  void advise(std::size_t offset, std::size_t count, int advice) const {
+    if (offset >= bytes)
+      return;
+    ::madvise(static_cast<char*>(base) + offset, std::min(count, bytes - offset), advice);
+  }
+
+  int fd;
+  std::size_t bytes;
+  void* base;
+};
+
+
+namespace detail {
+
+  static const constexpr std::size_t PageBytes = 4096u;
+
+  // large enough to amortize the hints' system calls and keep the disk busy, small enough to stay cache friendly
+  static const constexpr std::size_t ChunkBytes = 16u << 20;
+
+  // elements per chunk: whole pages, at least one
+  template <typename T>
+  inline std::size_t chunkSize(std::size_t chunkBytes) {
+    static_assert(PageBytes % sizeof(T) == 0, "elements have to tile pages");
+    return std::max(chunkBytes / PageBytes, std::size_t{1}) * PageBytes / sizeof(T);
+  }
+}
+
+
+// fn(first, last) for consecutive chunks of the elements in the file, the next chunk read ahead while fn runs; a
+// trailing partial element is ignored
+template <typename T, typename Fn>
+inline void forEachChunk(const MappedFile& in, Fn fn, std::size_t chunkBytes = detail::ChunkBytes) {
+  const auto n = in.size() / sizeof(T);
+  const auto chunk = detail::chunkSize<T>(chunkBytes);
+  const auto* first = in.data<T>();
+
+  in.sequential();
+  in.willNeed(0, chunk * sizeof(T));
+
+  for (std::size_t i{0}; i < n; i += chunk) {
+    const auto count = std::min(chunk, n - i);
+
+    in.willNeed((i + chunk) * sizeof(T), chunk * sizeof(T));
+    fn(first + i, first + i + count);
+    in.dontNeed(i * sizeof(T), count * sizeof(T));
+  }
+}
+
+// out[i] = kernel(x[i]) for the elements x of in, see VecCopy.h; out has to be at least as large as in. Results go out
+// with streaming stores -- they are not read again -- and each chunk's write back is started once it is complete.
+template <typename T, typename Kernel>
+inline void transform(const MappedFile& in, MappedFile& out, Kernel kernel,
+                      std::size_t chunkBytes = detail::ChunkBytes) {
+  assert(out.size() >= in.size() / sizeof(T) * sizeof(T));
+  const auto* first = in.data<T>();
+  auto* dst = out.data<T>();
+
+  forEachChunk<T>(in, [&](const T* chunkFirst, const T* chunkLast) {
+    const auto offset = static_cast<std::size_t>(chunkFirst - first);
+    const auto count = static_cast<std::size_t>(chunkLast - chunkFirst);
+
+    avx::transform(chunkFirst, chunkLast, dst + offset, kernel, Stores::streaming);
+    out.writeBack(offset * sizeof(T), count * sizeof(T));
+    out.dontNeed(offset * sizeof(T), count * sizeof(T));
+  }, chunkBytes);
+}
+}
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <algorithm>
+#include "Half.h"
+#include "Vec8Float.h"
+#include "VecMemory.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// 16 bit arrays straight into vec8f kernels, see Half.h: loads widen to float and stores narrow back in registers, so
+// a read-heavy scan over Half or BFloat16 moves half the bytes of the same scan over float while computing in float
+
+template <typename Storage>
+using HalfVector = AlignedVector<Storage, 32u>;
+
+namespace detail {
+
+  // out[i] = kernel(x[i]) eight at a time, converting on load and store as In and Out ask for
+  template <typename In, typename Out, typename Kernel>
+  inline void transform16(const In* first, const In* last, Out* out, Kernel kernel) {
+    const auto n = static_cast<std::size_t>(last - first);
+    std::size_t i{0};
+
+    for (; i + vec8f::Size <= n; i += vec8f::Size) {
+      vec8f x;
+      x.load(first + i, first + i + vec8f::Size);
+      kernel(x).store(out + i, out + i + vec8f::Size);
+    }
+
+    if (i != n) {
+      vec8f x;
+      x.load_partial(first + i, last);
+      kernel(x).store_partial(out + i, out + n);
+    }
+  }
+
+  template <std::size_t Accumulators, typename Storage>
+  inline float sum16(const Storage* first, const Storage* last) {
+    static_assert(Accumulators > 0u, "at least one accumulator");
+    const auto n = static_cast<std::size_t>(last - first);
+    const auto step = Accumulators * vec8f::Size;
+
+    vec8f acc[Accumulators];
+    std::size_t i{0};
+
+    for (; i + step <= n; i += step) {
+      for (std::size_t j{0}; j < Accumulators; ++j) {
+        vec8f x;
+        x.load(first + i + j * vec8f::Size, first + i + (j + 1) * vec8f::Size);
+        acc[j] += x;
+      }
+    }
+
+    for (; i < n; i += vec8f::Size) {
+      vec8f x;
+      x.load_partial(first + i, first + std::min(n, i + vec8f::Size));
+      acc[0] += x;
+    }
+
+    for (std::size_t j{1}; j < Accumulators; ++j)
+      acc[0] += acc[j];
+
+    return hSum(acc[0]);
+  }
+
+  struct Identity final {
+    vec8f operator()(const vec8f& x) const { return x; }
+  };
+}
+
+
+// out[i] = kernel(x[i]), kernel taking and returning vec8f; out may alias first
+template <typename Kernel>
+inline void transform(const Half* first, const Half* last, Half* out, Kernel kernel) {
+  detail::transform16(first, last, out, kernel);
+}
+
+template <typename Kernel>
+inline void transform(const BFloat16* first, const BFloat16* last, BFloat16* out, Kernel kernel) {
+  detail::transform16(first, last, out, kernel);
+}
+
+// as above, the results kept as float
+template <typename Kernel>
+inline void transform(const Half* first, const Half* last, float* out, Kernel kernel) {
+  detail::transform16(first, last, out, kernel);
+}
+
+template <typename Kernel>
+inline void transform(const BFloat16* first, const BFloat16* last, float* out, Kernel kernel) {
+  detail::transform16(first, last, out, kernel);
+}
+
+// bulk conversions, e.g. to compress a float array once for many scans
+inline void convert(const float* first, const float* last, Half* out) {
+  detail::transform16(first, last, out, detail::Identity{});
+}
+
+inline void convert(const float* first, const float* last, BFloat16* out) {
+  detail::transform16(first, last, out, detail::Identity{});
+}
+
+inline void convert(const Half* first, const Half* last, float* out) {
+  detail::transform16(first, last, out, detail::Identity{});
+}
+
+inline void convert(const BFloat16* first, const BFloat16* last, float* out) {
+  detail::transform16(first, last, out, detail::Identity{});
+}
+
+// sum in float, see avx::sum
+template <std::size_t Accumulators = 4>
+inline float sum(const Half* first, const Half* last) {
+  return detail::sum16<Accumulators>(first, last);
+}
+
+template <std::size_t Accumulators = 4>
+inline float sum(const BFloat16* first, const BFloat16* last) {
+  return detail::sum16<Accumulators>(first, last);
+}
+}
+}
@@ -0,0 +1,401 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <utility>
+#include <vector>
+#include <immintrin.h>
+#include "Vec8Int.h"
+#include "Vec32Byte.h"
+#include "VecMemory.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// int32 keys hashed eight at a time and looked up in Swiss tables, for joins and group-bys:
+//   murmur3Mix: murmur3's 32 bit finalizer, xxhash32: xxh32 of the key's four bytes; both lane-wise on vec8i with
+//   scalar versions computing the same, multiplies wrapping as in uint32
+//   HashSet, HashMap: open addressing with a control byte per slot -- empty, deleted, or seven bits of the key's hash.
+//   Probing a group of 32 slots is one vec32b compare against those seven bits and a moveMask, candidates are walked
+//   with tzcnt; the rest of the hash picks the first group, further groups follow triangularly.
+//   Batched lookups hash eight keys at once and prefetch their control bytes two batches and their candidate slots one
+//   batch ahead, keeping more cache misses in flight than out-of-order execution finds across plain lookups.
+
+namespace detail {
+
+  // uint32 constants broadcast to vec8i lanes
+  inline vec8i broadcast(std::uint32_t x) { return vec8i{static_cast<vec8i::Value>(x)}; }
+
+  namespace xxh32 {
+    static const constexpr std::uint32_t prime2 = 0x85EBCA77u;
+    static const constexpr std::uint32_t prime3 = 0xC2B2AE3Du;
+    static const constexpr std::uint32_t prime4 = 0x27D4EB2Fu;
+    static const constexpr std::uint32_t prime5 = 0x165667B1u;
+  }
+}
+
+inline std::uint32_t murmur3Mix(std::uint32_t h) {
+  h ^= h >> 16;
+  h *= 0x85EBCA6Bu;
+  h ^= h >> 13;
+  h *= 0xC2B2AE35u;
+  return h ^ h >> 16;
+}
+
+inline vec8i murmur3Mix(vec8i h) {
+  using detail::broadcast;
+
+  h = h ^ shiftRightZeroExtend<16>(h);
+  h = h * broadcast(0x85EBCA6Bu);
+  h = h ^ shiftRightZeroExtend<13>(h);
+  h = h * broadcast(0xC2B2AE35u);
+  return h ^ shiftRightZeroExtend<16>(h);
+}
+
+inline std::uint32_t xxhash32(std::uint32_t key, std::uint32_t seed = 0) {
+  using namespace detail::xxh32;
+
+  auto h = seed + prime5 + 4u + key * prime3;
+  h = (h << 17 | h >> 15) * prime4;
+
+  h ^= h >> 15;
+  h *= prime2;
+  h ^= h >> 13;
+  h *= prime3;
+  return h ^ h >> 16;
+}
+
+inline vec8i xxhash32(const vec8i& key, std::uint32_t seed = 0) {
+  using namespace detail::xxh32;
+  using detail::broadcast;
+
+  auto h = broadcast(seed + prime5 + 4u) + key * broadcast(prime3);
+  h = rotateLeft<17>(h) * broadcast(prime4);
+
+  h = h ^ shiftRightZeroExtend<15>(h);
+  h = h * broadcast(prime2);
+  h = h ^ shiftRightZeroExtend<13>(h);
+  h = h * broadcast(prime3);
+  return h ^ shiftRightZeroExtend<16>(h);
+}
+
+
+namespace detail {
+
+  namespace control {
+    static const constexpr std::int8_t empty = -128;
+    static const constexpr std::int8_t deleted = -2;
+  }
+
+  static const constexpr std::size_t GroupSize = 32u;
+
+  // the tables' hash; low seven bits to the control bytes, the rest picks the group
+  inline std::uint32_t hashKey(std::int32_t key) { return murmur3Mix(static_cast<std::uint32_t>(key)); }
+  inline vec8i hashKeys(const vec8i& keys) { return murmur3Mix(keys); }
+
+  inline std::int8_t fingerprint(std::uint32_t hash) { return static_cast<std::int8_t>(hash & 0x7Fu); }
+
+  // one bit per slot of the 32 control bytes at ctrl
+  struct Group final {
+    vec32b bytes;
+
+    explicit Group(const std::int8_t* ctrl) { bytes.load_aligned(ctrl, ctrl + GroupSize); }
+
+    std::uint32_t match(std::int8_t fp) const {
+      return static_cast<std::uint32_t>(moveMask(bytes == vec32b{fp}));
+    }
+
+    std::uint32_t matchEmpty() const { return static_cast<std::uint32_t>(moveMask(bytes == vec32b{control::empty})); }
+
+    // empty and deleted are the negative control bytes
+    std::uint32_t matchFree() const { return static_cast<std::uint32_t>(moveMask(bytes)); }
+  };
+
+  // slots are structs with an int32 key member; full slots hold constructed keys, the others are left as they are
+  template <typename Slot>
+  class SwissTable final {
+  public:
+    explicit SwissTable(std::size_t capacity) : count(0), tombstones(0) { reset(groupsFor(capacity)); }
+
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return slots.size(); }
+
+    // slot holding key, null if there is none
+    const Slot* find(std::int32_t key, std::uint32_t hash) const {
+      const auto fp = fingerprint(hash);
+
+      for (std::size_t g = groupOf(hash), step{1};; g = (g + step++) & (groups - 1)) {
+        const Group group{ctrl.data() + g * GroupSize};
+
+        for (auto bits = group.match(fp); bits != 0; bits &= bits - 1) {
+          const auto& slot = slots[g * GroupSize + static_cast<std::size_t>(__builtin_ctz(bits))];
+          if (slot.key == key)
+            return &slot;
+        }
+
+        // an empty slot ends every probe sequence the key could have been inserted along
+        if (group.matchEmpty() != 0)
+          return nullptr;
+      }
+    }
+
+    Slot* find(std::int32_t key, std::uint32_t hash) {
+      return const_cast<Slot*>(static_cast<const SwissTable&>(*this).find(key, hash));
+    }
+
+    // slot holding key and whether it was inserted just now
+    std::pair<Slot*, bool> insert(std::int32_t key, std::uint32_t hash) {
+      if (auto* slot = find(key, hash))
+        return {slot, false};
+
+      if (count + tombstones + 1 > slots.size() / 8u * 7u)
+        rehash(count + 1 > slots.size() / 2u ? groups * 2u : groups);
+
+      const auto i = freeSlot(hash);
+      tombstones -= ctrl[i] == control::deleted;
+      ctrl[i] = fingerprint(hash);
+      slots[i] = Slot{};
+      slots[i].key = key;
+      ++count;
+
+      return {&slots[i], true};
+    }
+
+    bool erase(std::int32_t key, std::uint32_t hash) {
+      auto* slot = find(key, hash);
+      if (slot == nullptr)
+        return false;
+
+      ctrl[static_cast<std::size_t>(slot - slots.data())] = control::deleted;
+      --count;
+      ++tombstones;
+      return true;
+    }
+
+    // ahead of a find: the control bytes of the first group in key's probe sequence, then once they are in cache the
+    // slot of the first candidate in there
+    void prefetchGroup(std::uint32_t hash) const {
+      _mm_prefetch(reinterpret_cast<const char*>(ctrl.data() + groupOf(hash) * GroupSize), _MM_HINT_T0);
+    }
+
+    void prefetchSlot(std::uint32_t hash) const {
+      const auto g = groupOf(hash);
+      const auto bits = Group{ctrl.data() + g * GroupSize}.match(fingerprint(hash));
+      if (bits != 0) {
+        const auto* slot = &slots[g * GroupSize + static_cast<std::size_t>(__builtin_ctz(bits))];
+        _mm_prefetch(reinterpret_cast<const char*>(slot), _MM_HINT_T0);
+      }
+    }
+
+    // fn(slot) for all full slots
+    template <typename Fn>
+    void forEach(Fn fn) {
+      for (std::size_t i{0}; i < slots.size(); ++i)
+        if (ctrl[i] >= 0)
+          fn(slots[i]);
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn) const {
+      for (std::size_t i{0}; i < slots.size(); ++i)
+        if (ctrl[i] >= 0)
+          fn(slots[i]);
+    }
+
+  private:
+    // groups for capacity keys at the maximum load factor of 7/8, a power of two
+    static std::size_t groupsFor(std::size_t capacity) {
+      std::size_t rv{1};
+      while (rv * GroupSize / 8u * 7u < capacity)
+        rv *= 2u;
+      return rv;
+    }
+
+    std::size_t groupOf(std::uint32_t hash) const { return (hash >> 7) & (groups - 1); }
+
+    std::size_t freeSlot(std::uint32_t hash) const {
+      for (std::size_t g = groupOf(hash), step{1};; g = (g + step++) & (groups - 1)) {
+        const auto bits = Group{ctrl.data() + g * GroupSize}.matchFree();
+        if (bits != 0)
+          return g * GroupSize + static_cast<std::size_t>(__builtin_ctz(bits));
+      }
+    }
+
+    void reset(std::size_t groupCount) {
+      groups = groupCount;
+      ctrl.assign(groups * GroupSize, control::empty);
+      slots.assign(groups * GroupSize, Slot{});
+      count = 0;
+      tombstones = 0;
+    }
+
+    // into groupCount groups, dropping tombstones
+    void rehash(std::size_t groupCount) {
+      auto oldCtrl = std::move(ctrl);
+      auto oldSlots = std::move(slots);
+      reset(groupCount);
+
+      for (std::size_t i{0}; i < oldSlots.size(); ++i) {
+        if (oldCtrl[i] < 0)
+          continue;
+
+        const auto j = freeSlot(hashKey(oldSlots[i].key));
+        ctrl[j] = oldCtrl[i];
+        slots[j] = std::move(oldSlots[i]);
+        ++count;
+      }
+    }
+
+    AlignedVector<std::int8_t, 32u> ctrl;
+    std::vector<Slot> slots;
+    std::size_t groups;
+    std::size_t count;
+    std::size_t tombstones;
+  };
+
+  // fn(i, slot) for the keys [first, last), slot as from find; eight keys at a time in three stages so that the
+  // memory accesses of 16 keys overlap: hashing and prefetching control bytes two batches ahead, matching fingerprints
+  // and prefetching the candidate slots one batch ahead, then the finds
+  template <typename Table, typename Fn>
+  inline void findBatched(const Table& table, const std::int32_t* first, const std::int32_t* last, Fn fn) {
+    const auto n = static_cast<std::size_t>(last - first);
+    const auto batch = vec8i::Size;
+    alignas(32) vec8i::Value hashes[3][vec8i::Size];
+
+    const auto batchHashes = [&](std::size_t i) { return hashes[i / batch % 3u]; };
+    const auto count = [&](std::size_t i) { return std::min(batch, n - i); };
+
+    const auto hashAhead = [&](std::size_t i) {
+      auto* out = batchHashes(i);
+      vec8i keys;
+      keys.load_partial(first + i, first + i + count(i));
+      hashKeys(keys).store_aligned(out, out + vec8i::Size);
+
+      for (std::size_t j{0}; j < count(i); ++j)
+        table.prefetchGroup(static_cast<std::uint32_t>(out[j]));
+    };
+
+    const auto matchAhead = [&](std::size_t i) {
+      for (std::size_t j{0}; j < count(i); ++j)
+        table.prefetchSlot(static_cast<std::uint32_t>(batchHashes(i)[j]));
+    };
+
+    for (std::size_t i{0}; i < n && i < 2u * batch; i += batch)
+      hashAhead(i);
+
+    if (n != 0)
+      matchAhead(0);
+
+    for (std::size_t i{0}; i < n; i += batch) {
+      if (i + 2u * batch < n)
+        hashAhead(i + 2u * batch);
+      if (i + batch < n)
+        matchAhead(i + batch);
+
+      for (std::size_t j{0}; j < count(i); ++j)
+        fn(i + j, table.find(first[i + j], static_cast<std::uint32_t>(batchHashes(i)[j])));
+    }
+  }
+
+  struct SetSlot final {
+    std::int32_t key;
+  };
+
+  template <typename Value>
+  struct MapSlot final {
+    std::int32_t key;
+    Value value;
+  };
+}
+
+
+// int32 keys, see above
+class HashSet final {
+public:
+  explicit HashSet(std::size_t capacity = 0) : table(capacity) {}
+
+  std::size_t size() const { return table.size(); }
+  std::size_t capacity() const { return table.capacity(); }
+
+  // true if key was not in the set before
+  bool insert(std::int32_t key) { return table.insert(key, detail::hashKey(key)).second; }
+  bool erase(std::int32_t key) { return table.erase(key, detail::hashKey(key)); }
+  bool contains(std::int32_t key) const { return table.find(key, detail::hashKey(key)) != nullptr; }
+
+  // out[i] = whether [first, last)[i] is in the set, batched; returns how many are
+  std::size_t contains(const std::int32_t* first, const std::int32_t* last, bool* out) const {
+    std::size_t rv{0};
+    detail::findBatched(table, first, last, [&](std::size_t i, const detail::SetSlot* slot) {
+      out[i] = slot != nullptr;
+      rv += out[i];
+    });
+    return rv;
+  }
+
+  // fn(key) for all keys, in no particular order
+  template <typename Fn>
+  void forEach(Fn fn) const {
+    table.forEach([&](const detail::SetSlot& slot) { fn(slot.key); });
+  }
+
+private:
+  detail::SwissTable<detail::SetSlot> table;
+};
+
+// int32 keys to values, see above; values have to be default constructible
+template <typename Value>
+class HashMap final {
+public:
+  explicit HashMap(std::size_t capacity = 0) : table(capacity) {}
+
+  std::size_t size() const { return table.size(); }
+  std::size_t capacity() const { return table.capacity(); }
+
+  // value for key, default constructed and inserted if there is none; e.g. counts[key] += 1 for group-bys
+  Value& operator[](std::int32_t key) { return table.insert(key, detail::hashKey(key)).first->value; }
+
+  // true if key was not in the map before, otherwise the value stays as it is
+  bool insert(std::int32_t key, const Value& value) {
+    const auto rv = table.insert(key, detail::hashKey(key));
+    if (rv.second)
+      rv.first->value = value;
+    return rv.second;
+  }
+
+  bool erase(std::int32_t key) { return table.erase(key, detail::hashKey(key)); }
+
+  // value for key, null if there is none
+  const Value* find(std::int32_t key) const {
+    const auto* slot = table.find(key, detail::hashKey(key));
+    return slot != nullptr ? &slot->value : nullptr;
+  }
+
+  Value* find(std::int32_t key) {
+    auto* slot = table.find(key, detail::hashKey(key));
+    return slot != nullptr ? &slot->value : nullptr;
+  }
+
+  // out[i] = value for [first, last)[i], missing if there is none, batched; returns how many were found. A hash join's
+  // probe side, e.g.
+  std::size_t find(const std::int32_t* first, const std::int32_t* last, Value* out, const Value& missing) const {
+    std::size_t rv{0};
+    detail::findBatched(table, first, last, [&](std::size_t i, const detail::MapSlot<Value>* slot) {
+      out[i] = slot != nullptr ? slot->value : missing;
+      rv += slot != nullptr;
+    });
+    return rv;
+  }
+
+  // fn(key, value) for all entries, in no particular order
+  template <typename Fn>
+  void forEach(Fn fn) {
+    table.forEach([&](detail::MapSlot<Value>& slot) { fn(slot.key, slot.value); });
+  }
+
+private:
+  detail::SwissTable<detail::MapSlot<Value>> table;
+};
+}
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <immintrin.h>
+#include "Vec8Float.h"
+#include "Vec8Int.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// arrays of structs to structs of registers and back: eight interleaved pairs (x y), triples (x y z, e.g. points) or
+// quadruples (x y z w, e.g. RGBA) become one vec8f resp. vec8i per field with a handful of shuffles, and are written
+// back interleaved the same way -- no scalar pass transposing to separate arrays first. Lane i holds struct i.
+//   load2/store2: 16 values, even and odd lanes split by shuffles, the 64 bit quarters put back in order by vpermpd
+//   load3/store3: 24 values, loaded as three 128 bit pairs (structs 0-3 low, 4-7 high) so that in-lane shuffles suffice
+//   load4/store4: 32 values, loaded the same way as 4 x 4 transposes in both 128 bit lanes
+// vec8i goes through the same shuffles on the bits; the _partial versions take fewer than eight structs.
+
+namespace detail {
+
+  // [first, first + 4) low and [first + offset, first + offset + 4) high
+  inline __m256 loadPair(const float* first, std::size_t offset) {
+    return _mm256_insertf128_ps(_mm256_castps128_ps256(_mm_loadu_ps(first)), _mm_loadu_ps(first + offset), 1);
+  }
+
+  inline void storePair(__m256 x, float* first, std::size_t offset) {
+    _mm_storeu_ps(first, _mm256_castps256_ps128(x));
+    _mm_storeu_ps(first + offset, _mm256_extractf128_ps(x, 1));
+  }
+
+  inline void transpose4x4(__m256& a, __m256& b, __m256& c, __m256& d) {
+    const auto t0 = _mm256_unpacklo_ps(a, b), t1 = _mm256_unpacklo_ps(c, d);
+    const auto t2 = _mm256_unpackhi_ps(a, b), t3 = _mm256_unpackhi_ps(c, d);
+
+    a = _mm256_shuffle_ps(t0, t1, 0x44);
+    b = _mm256_shuffle_ps(t0, t1, 0xEE);
+    c = _mm256_shuffle_ps(t2, t3, 0x44);
+    d = _mm256_shuffle_ps(t2, t3, 0xEE);
+  }
+
+  inline const float* floats(const std::int32_t* first) { return reinterpret_cast<const float*>(first); }
+  inline float* floats(std::int32_t* first) { return reinterpret_cast<float*>(first); }
+}
+
+
+// [first, first + 16) as x0 y0 x1 y1 .. x7 y7
+inline void load2(const float* first, const float* last, vec8f& x, vec8f& y) {
+  assert(last - first == 16);
+
+  const auto a = _mm256_loadu_ps(first), b = _mm256_loadu_ps(first + 8);
+
+  // x0 x1 x4 x5 x2 x3 x6 x7 from the in-lane shuffle, then the 64 bit quarters reordered
+  const auto even = _mm256_shuffle_ps(a, b, 0x88), odd = _mm256_shuffle_ps(a, b, 0xDD);
+  x = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), 0xD8));
+  y = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odd), 0xD8));
+}
+
+inline void store2(const vec8f& x, const vec8f& y, float* first, float* last) {
+  assert(last - first == 16);
+
+  const auto low = _mm256_unpacklo_ps(x.ymm, y.ymm), high = _mm256_unpackhi_ps(x.ymm, y.ymm);
+  _mm256_storeu_ps(first, _mm256_permute2f128_ps(low, high, 0x20));
+  _mm256_storeu_ps(first + 8, _mm256_permute2f128_ps(low, high, 0x31));
+}
+
+// [first, first + 24) as x0 y0 z0 x1 y1 z1 .. x7 y7 z7
+inline void load3(const float* first, const float* last, vec8f& x, vec8f& y, vec8f& z) {
+  assert(last - first == 24);
+
+  // structs 0-3 in the low lanes, 4-7 in the high ones: m03 = x0 y0 z0 x1 | x4 y4 z4 x5 and so on
+  const auto m03 = detail::loadPair(first, 12), m14 = detail::loadPair(first + 4, 12);
+  const auto m25 = detail::loadPair(first + 8, 12);
+
+  const auto xy = _mm256_shuffle_ps(m14, m25, _MM_SHUFFLE(2, 1, 3, 2)); // x2 y2 x3 y3
+  const auto yz = _mm256_shuffle_ps(m03, m14, _MM_SHUFFLE(1, 0, 2, 1)); // y0 z0 y1 z1
+
+  x = _mm256_shuffle_ps(m03, xy, _MM_SHUFFLE(2, 0, 3, 0));
+  y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0));
+  z = _mm256_shuffle_ps(yz, m25, _MM_SHUFFLE(3, 0, 3, 1));
+}
+
+inline void store3(const vec8f& x, const vec8f& y, const vec8f& z, float* first, float* last) {
+  assert(last - first == 24);
+
+  const auto xy = _mm256_shuffle_ps(x.ymm, y.ymm, _MM_SHUFFLE(2, 0, 2, 0)); // x0 x2 y0 y2
+  const auto yz = _mm256_shuffle_ps(y.ymm, z.ymm, _MM_SHUFFLE(3, 1, 3, 1)); // y1 y3 z1 z3
+  const auto zx = _mm256_shuffle_ps(z.ymm, x.ymm, _MM_SHUFFLE(3, 1, 2, 0)); // z0 z2 x1 x3
+
+  detail::storePair(_mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2, 0, 2, 0)), first, 12);
+  detail::storePair(_mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3, 1, 2, 0)), first + 4, 12);
+  detail::storePair(_mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3, 1, 3, 1)), first + 8, 12);
+}
+
+// [first, first + 32) as x0 y0 z0 w0 .. x7 y7 z7 w7
+inline void load4(const float* first, const float* last, vec8f& x, vec8f& y, vec8f& z, vec8f& w) {
+  assert(last - first == 32);
+
+  auto a = detail::loadPair(first, 16), b = detail::loadPair(first + 4, 16);
+  auto c = detail::loadPair(first + 8, 16), d = detail::loadPair(first + 12, 16);
+  detail::transpose4x4(a, b, c, d);
+
+  x = a, y = b, z = c, w = d;
+}
+
+inline void store4(const vec8f& x, const vec8f& y, const vec8f& z, const vec8f& w, float* first, float* last) {
+  assert(last - first == 32);
+
+  auto a = x.ymm, b = y.ymm, c = z.ymm, d = w.ymm;
+  detail::transpose4x4(a, b, c, d);
+
+  detail::storePair(a, first, 16);
+  detail::storePair(b, first + 4, 16);
+  detail::storePair(c, first + 8, 16);
+  detail::storePair(d, first + 12, 16);
+}
+
+
+// int32 fields, the same shuffles on the bits
+inline void load2(const std::int32_t* first, const std::int32_t* last, vec8i& x, vec8i& y) {
+  vec8f fx, fy;
+  load2(detail::floats(first), detail::floats(last), fx, fy);
+  x = reinterpret(fx), y = reinterpret(fy);
+}
+
+inline void store2(const vec8i& x, const vec8i& y, std::int32_t* first, std::int32_t* last) {
+  store2(reinterpret(x), reinterpret(y), detail::floats(first), detail::floats(last));
+}
+
+inline void load3(const std::int32_t* first, const std::int32_t* last, vec8i& x, vec8i& y, vec8i& z) {
+  vec8f fx, fy, fz;
+  load3(detail::floats(first), detail::floats(last), fx, fy, fz);
+  x = reinterpret(fx), y = reinterpret(fy), z = reinterpret(fz);
+}
+
+inline void store3(const vec8i& x, const vec8i& y, const vec8i& z, std::int32_t* first, std::int32_t* last) {
+  store3(reinterpret(x), reinterpret(y), reinterpret(z), detail::floats(first), detail::floats(last));
+}
+
+inline void load4(const std::int32_t* first, const std::int32_t* last, vec8i& x, vec8i& y, vec8i& z, vec8i& w) {
+  vec8f fx, fy, fz, fw;
+  load4(detail::floats(first), detail::floats(last), fx, fy, fz, fw);
+  x = reinterpret(fx), y = reinterpret(fy), z = reinterpret(fz), w = reinterpret(fw);
+}
+
+inline void store4(const vec8i& x, const vec8i& y, const vec8i& z, const vec8i& w, std::int32_t* first,
+                   std::int32_t* last) {
+  store4(reinterpret(x), reinterpret(y), reinterpret(z), reinterpret(w), detail::floats(first), detail::floats(last));
+}
+
+
+// up to eight structs, [first, last) a whole number of them: through a zero padded copy as the 16 bit partial loads,
+// lanes past the last struct are zero resp. not stored
+template <typename T, typename V>
+inline void load2_partial(const T* first, const T* last, V& x, V& y) {
+  assert(last - first <= 16 && (last - first) % 2 == 0);
+
+  T values[16] = {};
+  std::copy(first, last, values);
+  load2(values, values + 16, x, y);
+}
+
+template <typename T, typename V>
+inline void store2_partial(const V& x, const V& y, T* first, T* last) {
+  assert(last - first <= 16 && (last - first) % 2 == 0);
+
+  T values[16];
+  store2(x, y, values, values + 16);
+  std::copy(values, values + (last - first), first);
+}
+
+template <typename T, typename V>
+inline void load3_partial(const T* first, const T* last, V& x, V& y, V& z) {
+  assert(last - first <= 24 && (last - first) % 3 == 0);
+
+  T values[24] = {};
+  std::copy(first, last, values);
+  load3(values, values + 24, x, y, z);
+}
+
+template <typename T, typename V>
+inline void store3_partial(const V& x, const V& y, const V& z, T* first, T* last) {
+  assert(last - first <= 24 && (last - first) % 3 == 0);
+
+  T values[24];
+  store3(x, y, z, values, values + 24);
+  std::copy(values, values + (last - first), first);
+}
+
+template <typename T, typename V>
+inline void load4_partial(const T* first, const T* last, V& x, V& y, V& z, V& w) {
+  assert(last - first <= 32 && (last - first) % 4 == 0);
+
+  T values[32] = {};
+  std::copy(first, last, values);
+  load4(values, values + 32, x, y, z, w);
+}
+
+template <typename T, typename V>
+inline void store4_partial(const V& x, const V& y, const V& z, const V& w, T* first, T* last) {
+  assert(last - first <= 32 && (last - first) % 4 == 0);
+
+  T values[32];
+  store4(x, y, z, w, values, values + 32);
+  std::copy(values, values + (last - first), first);
+}
+}
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <algorithm>
+#include <utility>
+#include "Vec8Float.h"
+#include "Vec8Int.h"
+#include "VecLoop.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// table lookups, eight indices at a time:
+//   tables of 8, 16 or 32 entries are held in registers and looked up with permutes and blends
+//   larger tables are gathered from memory
+
+namespace detail {
+
+  template <typename T>
+  using Rows = std::integral_constant<std::size_t, T::Size / 8u>;
+
+  // selects lanes by bit Bit of index; full lane masks, see blend
+  template <int Bit>
+  inline vec8i bitSet(const vec8i& index) {
+    const vec8i bit{1 << Bit};
+    return (index & bit) == bit;
+  }
+
+  template <typename Vec>
+  inline Vec permuteRows(const Vec* rows, const vec8i& index, std::integral_constant<std::size_t, 1u>) {
+    return permute(rows[0], index);
+  }
+
+  template <typename Vec>
+  inline Vec permuteRows(const Vec* rows, const vec8i& index, std::integral_constant<std::size_t, 2u>) {
+    return blend(permute(rows[0], index), permute(rows[1], index), bitSet<3>(index));
+  }
+
+  template <typename Vec>
+  inline Vec permuteRows(const Vec* rows, const vec8i& index, std::integral_constant<std::size_t, 4u>) {
+    const auto high = bitSet<3>(index);
+    const auto lower = blend(permute(rows[0], index), permute(rows[1], index), high);
+    const auto upper = blend(permute(rows[2], index), permute(rows[3], index), high);
+    return blend(lower, upper, bitSet<4>(index));
+  }
+
+  // out[i] = lookup(index[i]) blockwise; masked head and tail load index zero and do not store it
+  template <typename T, typename Lookup>
+  inline void lookupBlocks(const std::int32_t* first, const std::int32_t* last, T* out, Lookup lookup) {
+    using Vec = vec<T, 8u>;
+
+    blocks<Vec::Size>(out, static_cast<std::size_t>(last - first), [&](std::size_t i, std::size_t count) {
+      if (count == Vec::Size) {
+        lookup(vec8i(first + i, first + i + Vec::Size)).store(out + i, out + i + Vec::Size);
+      } else {
+        vec8i index;
+        index.load_partial(first + i, first + i + count);
+        lookup(index).store_partial(out + i, out + i + count);
+      }
+    });
+  }
+}
+
+
+// indices are taken modulo the table size
+template <typename T, std::size_t TableSize>
+struct RegisterTable final {
+  static_assert(TableSize == 8u || TableSize == 16u || TableSize == 32u, "register tables hold 8, 16 or 32 entries");
+
+  using Value = T;
+  using Vec = vec<T, 8u>;
+  static const constexpr std::size_t Size = TableSize;
+
+  Vec rows[Size / Vec::Size];
+
+  // [first, last) with at most Size entries, the remaining entries are zero
+  RegisterTable(const Value* first, const Value* last)
+      : RegisterTable(first, last, std::make_index_sequence<Size / Vec::Size>{}) {}
+
+  Vec operator()(const vec8i& index) const { return detail::permuteRows(rows, index, detail::Rows<RegisterTable>{}); }
+
+private:
+  // rows are initialized in place, there is no point in default constructing them first
+  template <std::size_t... Row>
+  RegisterTable(const Value* first, const Value* last, std::index_sequence<Row...>)
+      : rows{loadRow(first, last, Row)...} {}
+
+  static Vec loadRow(const Value* first, const Value* last, std::size_t row) {
+    assert(last - first >= 0 && static_cast<std::size_t>(last - first) <= Size);
+
+    const auto n = static_cast<std::size_t>(last - first);
+    const auto offset = row * Vec::Size;
+
+    Vec x{Value{0}};
+    if (offset < n)
+      x.load_partial(first + offset, first + std::min(n, offset + Vec::Size));
+    return x;
+  }
+};
+
+
+// out[i] = table[index[i]] for index in [first, last), using permutes only
+template <typename T, std::size_t TableSize>
+inline void lookup(const RegisterTable<T, TableSize>& table, const std::int32_t* first, const std::int32_t* last,
+                   T* out) {
+  detail::lookupBlocks(first, last, out, table);
+}
+
+// out[i] = table[index[i]] for index in [first, last), using gathers only; indices have to be valid
+template <typename T>
+inline void gather(const T* table, const std::int32_t* first, const std::int32_t* last, T* out) {
+  detail::lookupBlocks(first, last, out, [&](const vec8i& index) {
+    vec<T, 8u> x;
+    x.gather(table, index);
+    return x;
+  });
+}
+
+// out[i] = table[index[i]] for index in [first, last); indices have to be in [0, tableSize)
+// picks permutes for tables of up to 32 entries and gathers otherwise, see lookupPerf for the crossover
+template <typename T>
+inline void lookup(const T* table, std::size_t tableSize, const std::int32_t* first, const std::int32_t* last, T* out) {
+  if (tableSize <= 8u)
+    lookup(RegisterTable<T, 8u>(table, table + tableSize), first, last, out);
+  else if (tableSize <= 16u)
+    lookup(RegisterTable<T, 16u>(table, table + tableSize), first, last, out);
+  else if (tableSize <= 32u)
+    lookup(RegisterTable<T, 32u>(table, table + tableSize), first, last, out);
+  else
+    gather(table, first, last, out);
+}
+}
+}
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+#include "Vec8Float.h"
+#include "Vec8Int.h"
+#include "VecMemory.h"
+#if defined(__AVX512F__)
+#include "Vec16Int.h"
+#endif
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// apply a kernel to arrays of any length in native<T> blocks, without scalar head or tail -- vec<T, 8> for AVX2 builds,
+// vec<T, 16> for AVX-512 builds; kernels written as generic lambdas recompile to either without source changes:
+//   head: elements up to the first block size boundary, masked
+//   body: full blocks, their stores do not cross cache lines
+//   tail: the remainder, masked
+// masked-out lanes are loaded as zero and never stored; memory outside the given ranges is never touched
+
+namespace detail {
+
+  // elements before anchor reaches a Bytes boundary; zero if it never does
+  template <std::size_t Bytes, typename T>
+  inline std::size_t headSize(const T* anchor, std::size_t n) {
+    const auto misalignment = reinterpret_cast<std::uintptr_t>(anchor) % Bytes;
+    if (misalignment == 0 || misalignment % sizeof(T) != 0)
+      return 0;
+    return std::min(n, (Bytes - misalignment) / sizeof(T));
+  }
+
+  // block(i, count) for the head, all full blocks and the tail; count is Size for full blocks
+  template <std::size_t Size, typename T, typename Block>
+  inline void blocks(const T* anchor, std::size_t n, Block block) {
+    std::size_t i = headSize<Size * sizeof(T)>(anchor, n);
+
+    if (i != 0)
+      block(0, i);
+
+    for (; i + Size <= n; i += Size)
+      block(i, Size);
+
+    if (i != n)
+      block(i, n - i);
+  }
+
+  // mask of the first n lanes in the vec's mask type: vector masks for AVX2, mask registers for AVX-512
+  inline vec8i firstLanes(std::size_t n, const vec8i*) { return laneMask(n); }
+#if defined(__AVX512F__)
+  inline mask16 firstLanes(std::size_t n, const mask16*) { return laneMask16(n); }
+#endif
+
+  template <typename V>
+  inline typename V::Mask firstLanes(std::size_t n) {
+    return firstLanes(n, static_cast<const typename V::Mask*>(nullptr));
+  }
+}
+
+
+// out[i] = kernel(x[i]) for x in [first, last); out may alias first
+template <typename T, typename Kernel>
+inline void transform(const T* first, const T* last, T* out, Kernel kernel) {
+  using V = native<T>;
+
+  // once aligned, the unaligned load/store mnemonics are as fast as the aligned ones
+  detail::blocks<V::Size>(out, static_cast<std::size_t>(last - first), [&](std::size_t i, std::size_t count) {
+    if (count == V::Size) {
+      kernel(V(first + i, first + i + V::Size)).store(out + i, out + i + V::Size);
+    } else {
+      V x;
+      x.load_partial(first + i, first + i + count);
+      kernel(x).store_partial(out + i, out + i + count);
+    }
+  });
+}
+
+// out[i] = kernel(x[i], y[i]) for x in [first1, last1), y in [first2, first2 + (last1 - first1)); out may alias both
+template <typename T, typename Kernel>
+inline void transform(const T* first1, const T* last1, const T* first2, T* out, Kernel kernel) {
+  using V = native<T>;
+
+  detail::blocks<V::Size>(out, static_cast<std::size_t>(last1 - first1), [&](std::size_t i, std::size_t count) {
+    if (count == V::Size) {
+      const V x(first1 + i, first1 + i + V::Size);
+      const V y(first2 + i, first2 + i + V::Size);
+      kernel(x, y).store(out + i, out + i + V::Size);
+    } else {
+      V x, y;
+      x.load_partial(first1 + i, first1 + i + count);
+      y.load_partial(first2 + i, first2 + i + count);
+      kernel(x, y).store_partial(out + i, out + i + count);
+    }
+  });
+}
+
+// kernel(x, mask) for x in [first, last); mask selects the lanes that are part of the range, a V::Mask
+// e.g. for reductions where the zeroed lanes would be wrong, blend them with the reduction's identity
+template <typename T, typename Kernel>
+inline void forEach(const T* first, const T* last, Kernel kernel) {
+  using V = native<T>;
+
+  detail::blocks<V::Size>(first, static_cast<std::size_t>(last - first), [&](std::size_t i, std::size_t count) {
+    if (count == V::Size) {
+      kernel(V(first + i, first + i + V::Size), detail::firstLanes<V>(V::Size));
+    } else {
+      V x;
+      x.load_partial(first + i, first + i + count);
+      kernel(x, detail::firstLanes<V>(count));
+    }
+  });
+}
+
+
+// aligned spans, see VecMemory.h: no head, aligned loads and stores for all full blocks, masked tail
+// Stream writes out with non-temporal stores bypassing the caches -- for outputs larger than the last level cache that
+// are not read again soon; the stores are fenced before returning
+
+namespace detail {
+
+  template <bool Stream, typename V, typename T>
+  inline void storeAligned(V x, T* out) {
+    if (Stream)
+      x.store_aligned_stream(out, out + V::Size);
+    else
+      x.store_aligned(out, out + V::Size);
+  }
+
+  template <bool Stream>
+  inline void fence() {
+    if (Stream)
+      _mm_sfence();
+  }
+}
+
+// out[i] = kernel(x[i]) for x in in; in may be a const or mutable span and may alias out
+template <bool Stream = false, typename In, typename T, std::size_t Alignment, typename Kernel>
+inline void transform(AlignedSpan<In, Alignment> in, AlignedSpan<T, Alignment> out, Kernel kernel) {
+  static_assert(std::is_same<std::remove_const_t<In>, T>::value, "in and out have to hold the same type");
+  static_assert(Alignment >= 32u, "aligned vec loads and stores need 32 byte alignment");
+  assert(in.size() == out.size());
+
+  // as wide as both the alignment and the build allow
+  using V = vec<T, std::min(NativeBytes, Alignment) / sizeof(T)>;
+
+  const auto n = in.size();
+  const auto* first = in.data();
+  auto* dst = out.data();
+
+  std::size_t i{0};
+
+  for (; i + V::Size <= n; i += V::Size) {
+    V x;
+    x.load_aligned(first + i, first + i + V::Size);
+    detail::storeAligned<Stream>(kernel(x), dst + i);
+  }
+
+  if (i != n) {
+    V x;
+    x.load_partial(first + i, first + n);
+    kernel(x).store_partial(dst + i, dst + n);
+  }
+
+  detail::fence<Stream>();
+}
+
+// out[i] = kernel(x[i], y[i]) for x in in1, y in in2; both may alias out
+template <bool Stream = false, typename In1, typename In2, typename T, std::size_t Alignment, typename Kernel>
+inline void transform(AlignedSpan<In1, Alignment> in1, AlignedSpan<In2, Alignment> in2, AlignedSpan<T, Alignment> out,
+                      Kernel kernel) {
+  static_assert(std::is_same<std::remove_const_t<In1>, T>::value && std::is_same<std::remove_const_t<In2>, T>::value,
+                "ins and out have to hold the same type");
+  static_assert(Alignment >= 32u, "aligned vec loads and stores need 32 byte alignment");
+  assert(in1.size() == out.size() && in2.size() == out.size());
+
+  // as wide as both the alignment and the build allow
+  using V = vec<T, std::min(NativeBytes, Alignment) / sizeof(T)>;
+
+  const auto n = in1.size();
+  const auto* first1 = in1.data();
+  const auto* first2 = in2.data();
+  auto* dst = out.data();
+
+  std::size_t i{0};
+
+  for (; i + V::Size <= n; i += V::Size) {
+    V x, y;
+    x.load_aligned(first1 + i, first1 + i + V::Size);
+    y.load_aligned(first2 + i, first2 + i + V::Size);
+    detail::storeAligned<Stream>(kernel(x, y), dst + i);
+  }
+
+  if (i != n) {
+    V x, y;
+    x.load_partial(first1 + i, first1 + n);
+    y.load_partial(first2 + i, first2 + n);
+    kernel(x, y).store_partial(dst + i, dst + n);
+  }
+
+  detail::fence<Stream>();
+}
+}
+}
@@ -0,0 +1,225 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <immintrin.h>
+#include "Vec8Float.h"
+#include "Vec8Int.h"
+#include "VecMemory.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// lower bounds of many queries in sorted int32 or float arrays, e.g. for joins and bucketing. std::lower_bound waits
+// for a cache miss at every level, one query after the other:
+//   lowerBound: queries in lockstep, eight vecs of eight at a time. Steps are branchless -- compare the gathered
+//   middles, add half the size to the lanes below them -- and all lanes take the same log2(n) steps, so the gathers
+//   of the eight vecs are independent and their misses overlap.
+//   SearchTree: the sorted keys laid out as an implicit B-tree, the Eytzinger layout with 16 keys per node: a node is
+//   a cache line compared against the query with one native<T> compare on AVX-512, two on AVX2, the count below the
+//   query picks one of 17 children. log17(n) misses instead of log2(n); batched lookups prefetch each query's next
+//   node while the batch's other queries are compared.
+// Results are indices into the sorted array as from std::lower_bound; arrays have to be smaller than 2^31.
+
+namespace detail {
+
+  // vecs of queries in lockstep: two are latency bound already in L2, more than eight are no faster
+  static const constexpr std::size_t LowerBoundGroups = 8u;
+
+  // compare results as lane masks
+  inline vec8i laneBits(const vec8i& x) { return x; }
+  inline vec8i laneBits(const vec8f& x) { return reinterpret(x); }
+
+  // the lanes' lower bounds in [first, first + n) for Groups vecs of queries; n has to be positive
+  template <std::size_t Groups, typename T>
+  inline void lowerBounds(const T* first, std::size_t n, const vec<T, 8u> (&x)[Groups], vec8i (&base)[Groups]) {
+    for (auto& each : base)
+      each = vec8i{0};
+
+    for (auto size = n; size > 1; size -= size / 2) {
+      const vec8i half{static_cast<vec8i::Value>(size / 2)};
+
+      for (std::size_t g{0}; g < Groups; ++g) {
+        vec<T, 8u> middle;
+        middle.gather(first, base[g] + half);
+        base[g] = base[g] + (half & laneBits(middle < x[g]));
+      }
+    }
+
+    // mask lanes are -1
+    for (std::size_t g{0}; g < Groups; ++g) {
+      vec<T, 8u> last;
+      last.gather(first, base[g]);
+      base[g] = base[g] - laneBits(last < x[g]);
+    }
+  }
+}
+
+
+// out[i] = std::lower_bound(first, last, query[i]) - first for query in [queryFirst, queryLast)
+template <typename T>
+inline void lowerBound(const T* first, const T* last, const T* queryFirst, const T* queryLast, std::int32_t* out) {
+  using V = vec<T, 8u>;
+  static const constexpr auto Groups = detail::LowerBoundGroups;
+  static const constexpr auto Batch = Groups * V::Size;
+
+  const auto n = static_cast<std::size_t>(last - first);
+  const auto m = static_cast<std::size_t>(queryLast - queryFirst);
+  assert(n <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()));
+
+  if (n == 0) {
+    std::fill(out, out + m, 0);
+    return;
+  }
+
+  const auto batch = [&](const T* queries, std::int32_t* bounds) {
+    V x[Groups];
+    vec8i rv[Groups];
+
+    for (std::size_t g{0}; g < Groups; ++g)
+      x[g].load(queries + g * V::Size, queries + (g + 1u) * V::Size);
+
+    detail::lowerBounds(first, n, x, rv);
+
+    for (std::size_t g{0}; g < Groups; ++g)
+      rv[g].store(bounds + g * V::Size, bounds + (g + 1u) * V::Size);
+  };
+
+  std::size_t i{0};
+  for (; i + Batch <= m; i += Batch)
+    batch(queryFirst + i, out + i);
+
+  // the tail through a copy padded with its last query
+  if (i != m) {
+    T queries[Batch];
+    std::int32_t bounds[Batch];
+
+    std::fill(std::copy(queryFirst + i, queryLast, queries), queries + Batch, queryLast[-1]);
+    batch(queries, bounds);
+    std::copy(bounds, bounds + (m - i), out + i);
+  }
+}
+
+
+// the sorted keys as an implicit B-tree: node k holds 16 keys and has the children 17k + 1 .. 17k + 17, keys in the
+// tree's in-order are the sorted keys followed by padding up to a whole number of nodes
+template <typename T>
+class SearchTree final {
+public:
+  static const constexpr std::size_t NodeSize = 16u;
+  static const constexpr std::size_t Fanout = NodeSize + 1u;
+
+  // from the sorted [first, last)
+  SearchTree(const T* first, const T* last)
+      : n(static_cast<std::size_t>(last - first)), nodes((n + NodeSize - 1u) / NodeSize), keys(nodes * NodeSize),
+        ranks(nodes * NodeSize + 1u) {
+    assert(n <= static_cast<std::size_t>(std::numeric_limits<std::int32_t>::max()));
+
+    build(first, 0, 0);
+    ranks[nodes * NodeSize] = static_cast<std::int32_t>(n);
+  }
+
+  std::size_t size() const { return n; }
+
+  // std::lower_bound(first, last, x) - first for the sorted array the tree was built from
+  std::size_t lowerBound(T x) const {
+    auto slot = nodes * NodeSize; // the last key >= x seen, the deeper the smaller
+
+    for (std::size_t node{0}; node < nodes;) {
+      const auto below = countBelow(node, x);
+
+      if (below < NodeSize)
+        slot = node * NodeSize + below;
+
+      node = node * Fanout + 1u + below;
+    }
+
+    return static_cast<std::size_t>(ranks[slot]);
+  }
+
+  // out[i] = lowerBound(query[i]) for query in [first, last), a batch of queries level by level
+  void lowerBound(const T* first, const T* last, std::int32_t* out) const {
+    static const constexpr std::size_t Batch = 16u;
+    const auto m = static_cast<std::size_t>(last - first);
+
+    for (std::size_t i{0}; i < m; i += Batch) {
+      const auto count = std::min(Batch, m - i);
+
+      std::size_t node[Batch], slot[Batch];
+      std::fill(node, node + count, 0);
+      std::fill(slot, slot + count, nodes * NodeSize);
+
+      for (bool descending = nodes != 0; descending;) {
+        descending = false;
+
+        for (std::size_t q{0}; q < count; ++q) {
+          if (node[q] >= nodes)
+            continue;
+
+          const auto below = countBelow(node[q], first[i + q]);
+
+          if (below < NodeSize)
+            slot[q] = node[q] * NodeSize + below;
+
+          node[q] = node[q] * Fanout + 1u + below;
+
+          if (node[q] < nodes) {
+            _mm_prefetch(reinterpret_cast<const char*>(keys.data() + node[q] * NodeSize), _MM_HINT_T0);
+            descending = true;
+          }
+        }
+      }
+
+      for (std::size_t q{0}; q < count; ++q)
+        out[i + q] = ranks[slot[q]];
+    }
+  }
+
+private:
+  // keys below x in the node, one cache line
+  std::size_t countBelow(std::size_t node, T x) const {
+    using V = native<T>;
+    const V query{x};
+    const auto* first = keys.data() + node * NodeSize;
+
+    std::size_t rv{0};
+    for (std::size_t j{0}; j < NodeSize; j += V::Size) {
+      V key;
+      key.load_aligned(first + j, first + j + V::Size);
+      rv += static_cast<std::size_t>(__builtin_popcount(static_cast<unsigned>(moveMask(key < query))));
+    }
+    return rv;
+  }
+
+  // in-order from rank on, returns the rank after the node's subtree; padding compares above all keys and has rank n
+  std::size_t build(const T* sorted, std::size_t node, std::size_t rank) {
+    if (node >= nodes)
+      return rank;
+
+    const auto padding = std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                              : std::numeric_limits<T>::max();
+
+    for (std::size_t j{0}; j < Fanout; ++j) {
+      rank = build(sorted, node * Fanout + 1u + j, rank);
+
+      if (j < NodeSize) {
+        const auto slot = node * NodeSize + j;
+        keys[slot] = rank < n ? sorted[rank] : padding;
+        ranks[slot] = static_cast<std::int32_t>(std::min(rank, n));
+        ++rank;
+      }
+    }
+
+    return rank;
+  }
+
+  std::size_t n;
+  std::size_t nodes;
+  AlignedVector<T, 64u> keys;
+  AlignedVector<std::int32_t, 64u> ranks;
+};
+}
+}
@@ -0,0 +1,260 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <algorithm>
+#include <vector>
+#include "Vec8Float.h"
+#include "VecMemory.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// row-major float matrices with leading dimensions (row strides in elements):
+//   transpose: 8 x 8 blocks in registers, from unpacks, shuffles and 128 bit lane permutes
+//   gemm: the blocked product in the shape of Goto & van de Geijn -- a 6 x 16 micro-kernel keeping twelve vec8f
+//   accumulators in registers, fed from packed panels: a kc x 16 sliver of b stays in L1, an mc x kc block of a in L2
+//   and a kc x nc panel of b in L3. parallel::gemm in VecParallel.h splits the blocks of a across the pool.
+
+// rows[i] becomes column i
+inline void transpose(vec8f (&rows)[8]) {
+  // pairs of rows interleaved, then quads, then the 128 bit halves swapped across
+  const auto t0 = unpackLow(rows[0], rows[1]), t1 = unpackHigh(rows[0], rows[1]);
+  const auto t2 = unpackLow(rows[2], rows[3]), t3 = unpackHigh(rows[2], rows[3]);
+  const auto t4 = unpackLow(rows[4], rows[5]), t5 = unpackHigh(rows[4], rows[5]);
+  const auto t6 = unpackLow(rows[6], rows[7]), t7 = unpackHigh(rows[6], rows[7]);
+
+  const auto s0 = shuffle<0x44>(t0, t2), s1 = shuffle<0xEE>(t0, t2);
+  const auto s2 = shuffle<0x44>(t1, t3), s3 = shuffle<0xEE>(t1, t3);
+  const auto s4 = shuffle<0x44>(t4, t6), s5 = shuffle<0xEE>(t4, t6);
+  const auto s6 = shuffle<0x44>(t5, t7), s7 = shuffle<0xEE>(t5, t7);
+
+  rows[0] = permute<0x20>(s0, s4), rows[1] = permute<0x20>(s1, s5);
+  rows[2] = permute<0x20>(s2, s6), rows[3] = permute<0x20>(s3, s7);
+  rows[4] = permute<0x31>(s0, s4), rows[5] = permute<0x31>(s1, s5);
+  rows[6] = permute<0x31>(s2, s6), rows[7] = permute<0x31>(s3, s7);
+}
+
+// out (cols x rows) = transpose of in (rows x cols); 8 x 8 blocks in registers, the edges element-wise
+inline void transpose(std::size_t rows, std::size_t cols, const float* in, std::size_t ldIn, float* out,
+                      std::size_t ldOut) {
+  std::size_t i{0};
+
+  for (; i + 8 <= rows; i += 8) {
+    std::size_t j{0};
+
+    for (; j + 8 <= cols; j += 8) {
+      vec8f block[8];
+      for (std::size_t r{0}; r < 8; ++r)
+        block[r].load(in + (i + r) * ldIn + j, in + (i + r) * ldIn + j + 8);
+
+      transpose(block);
+
+      for (std::size_t r{0}; r < 8; ++r)
+        block[r].store(out + (j + r) * ldOut + i, out + (j + r) * ldOut + i + 8);
+    }
+
+    for (; j < cols; ++j)
+      for (std::size_t r{i}; r < i + 8; ++r)
+        out[j * ldOut + r] = in[r * ldIn + j];
+  }
+
+  for (; i < rows; ++i)
+    for (std::size_t j{0}; j < cols; ++j)
+      out[j * ldOut + i] = in[i * ldIn + j];
+}
+
+
+namespace detail {
+
+  // micro-kernel tile and cache blocking: kc x 16 floats of b (16 KiB) in L1, mc x kc of a (120 KiB) in L2,
+  // kc x nc of b (3 MiB) in L3
+  namespace blocking {
+    static const constexpr std::size_t mr = 6u;
+    static const constexpr std::size_t nr = 16u;
+    static const constexpr std::size_t kc = 256u;
+    static const constexpr std::size_t mc = 120u;
+    static const constexpr std::size_t nc = 3072u;
+  }
+
+  // mc x kc block of a as slivers of mr rows, each stored column by column; rows past m are zero
+  inline void packA(std::size_t m, std::size_t k, const float* a, std::size_t lda, float* packed) {
+    const auto mr = blocking::mr;
+
+    for (std::size_t i{0}; i < m; i += mr) {
+      const auto rows = std::min(mr, m - i);
+
+      for (std::size_t p{0}; p < k; ++p, packed += mr) {
+        for (std::size_t r{0}; r < rows; ++r)
+          packed[r] = a[(i + r) * lda + p];
+        for (std::size_t r{rows}; r < mr; ++r)
+          packed[r] = 0.f;
+      }
+    }
+  }
+
+  // kc x nc panel of b as slivers of nr columns, each stored row by row; columns past n are zero
+  inline void packB(std::size_t k, std::size_t n, const float* b, std::size_t ldb, float* packed) {
+    const auto nr = blocking::nr;
+
+    for (std::size_t j{0}; j < n; j += nr) {
+      const auto cols = std::min(nr, n - j);
+
+      for (std::size_t p{0}; p < k; ++p, packed += nr) {
+        const auto* row = b + p * ldb + j;
+
+        if (cols == nr) {
+          vec8f{row, row + 8}.store_aligned(packed, packed + 8);
+          vec8f{row + 8, row + 16}.store_aligned(packed + 8, packed + 16);
+        } else {
+          std::copy(row, row + cols, packed);
+          std::fill(packed + cols, packed + nr, 0.f);
+        }
+      }
+    }
+  }
+
+  // c[0, 6) x [0, 16) = (c +) a sliver * b sliver over k: per k step two loads of b, six broadcasts of a and twelve
+  // fused multiply adds; twelve accumulators cover the FMA latency times the two FMA ports
+  inline void microKernel(std::size_t k, const float* a, const float* b, float* c, std::size_t ldc, bool accumulate) {
+    vec8f c00{0.f}, c01{0.f}, c10{0.f}, c11{0.f}, c20{0.f}, c21{0.f};
+    vec8f c30{0.f}, c31{0.f}, c40{0.f}, c41{0.f}, c50{0.f}, c51{0.f};
+
+    const auto update = [&](const float* x, const float* y) {
+      vec8f y0, y1;
+      y0.load_aligned(y, y + 8);
+      y1.load_aligned(y + 8, y + 16);
+
+      const auto step = [&](float scalar, vec8f& lo, vec8f& hi) {
+        const vec8f broadcast{scalar};
+        lo = fusedMulAdd(broadcast, y0, lo);
+        hi = fusedMulAdd(broadcast, y1, hi);
+      };
+
+      step(x[0], c00, c01);
+      step(x[1], c10, c11);
+      step(x[2], c20, c21);
+      step(x[3], c30, c31);
+      step(x[4], c40, c41);
+      step(x[5], c50, c51);
+    };
+
+    // unrolled by four: the loop's own instructions would otherwise take front end slots from the fused multiply adds
+    std::size_t p{0};
+
+    for (; p + 4 <= k; p += 4, a += 24, b += 64) {
+      update(a, b);
+      update(a + 6, b + 16);
+      update(a + 12, b + 32);
+      update(a + 18, b + 48);
+    }
+
+    for (; p < k; ++p, a += 6, b += 16)
+      update(a, b);
+
+    const auto store = [&](std::size_t row, vec8f lo, vec8f hi) {
+      auto* out = c + row * ldc;
+      if (accumulate) {
+        lo += vec8f{out, out + 8};
+        hi += vec8f{out + 8, out + 16};
+      }
+      lo.store(out, out + 8);
+      hi.store(out + 8, out + 16);
+    };
+
+    store(0, c00, c01);
+    store(1, c10, c11);
+    store(2, c20, c21);
+    store(3, c30, c31);
+    store(4, c40, c41);
+    store(5, c50, c51);
+  }
+
+  // c (m x n) = (c +) packed a (m x k) * packed b (k x n); edge tiles go through a full tile on the stack
+  inline void macroKernel(std::size_t m, std::size_t n, std::size_t k, const float* a, const float* b, float* c,
+                          std::size_t ldc, bool accumulate) {
+    const auto mr = blocking::mr, nr = blocking::nr;
+
+    for (std::size_t j{0}; j < n; j += nr) {
+      for (std::size_t i{0}; i < m; i += mr) {
+        const auto* aSliver = a + i * k;
+        const auto* bSliver = b + j * k;
+        auto* cTile = c + i * ldc + j;
+
+        const auto rows = std::min(mr, m - i), cols = std::min(nr, n - j);
+
+        if (rows == mr && cols == nr) {
+          microKernel(k, aSliver, bSliver, cTile, ldc, accumulate);
+          continue;
+        }
+
+        float tile[mr * nr];
+        microKernel(k, aSliver, bSliver, tile, nr, false);
+
+        for (std::size_t r{0}; r < rows; ++r)
+          for (std::size_t s{0}; s < cols; ++s)
+            cTile[r * ldc + s] = (accumulate ? cTile[r * ldc + s] : 0.f) + tile[r * nr + s];
+      }
+    }
+  }
+
+  // the loops around the macro-kernel: panels of b, then blocks of a; forBlocks(count, block) runs block(i, worker)
+  // for i in [0, count) with worker-private packing buffers packedA[worker]
+  template <typename ForBlocks>
+  inline void gemm(std::size_t m, std::size_t n, std::size_t k, const float* a, std::size_t lda, const float* b,
+                   std::size_t ldb, float* c, std::size_t ldc, bool accumulate, std::size_t workers,
+                   ForBlocks forBlocks) {
+    const auto mr = blocking::mr, nr = blocking::nr;
+    const auto kc = std::min(blocking::kc, k);
+    const auto mc = std::min(blocking::mc, (m + mr - 1) / mr * mr);
+    const auto nc = std::min(blocking::nc, (n + nr - 1) / nr * nr);
+
+    // empty products write nothing, and their blocks would be empty too
+    if (m == 0 || n == 0)
+      return;
+
+    if (k == 0) {
+      if (!accumulate)
+        for (std::size_t i{0}; i < m; ++i)
+          std::fill(c + i * ldc, c + i * ldc + n, 0.f);
+      return;
+    }
+
+    AlignedVector<float, 64u> packedB(kc * nc);
+    std::vector<AlignedVector<float, 64u>> packedA(workers, AlignedVector<float, 64u>(mc * kc));
+
+    const auto blocks = (m + mc - 1) / mc;
+
+    for (std::size_t jc{0}; jc < n; jc += nc) {
+      const auto cols = std::min(nc, n - jc);
+
+      for (std::size_t pc{0}; pc < k; pc += kc) {
+        const auto depth = std::min(kc, k - pc);
+        // the first pass over k overwrites c unless asked to accumulate, all later ones add to it
+        const auto add = accumulate || pc != 0;
+
+        packB(depth, cols, b + pc * ldb + jc, ldb, packedB.data());
+
+        forBlocks(blocks, [&](std::size_t block, std::size_t worker) {
+          const auto ic = block * mc;
+          const auto rows = std::min(mc, m - ic);
+          auto* packed = packedA[worker].data();
+
+          packA(rows, depth, a + ic * lda + pc, lda, packed);
+          macroKernel(rows, cols, depth, packed, packedB.data(), c + ic * ldc + jc, ldc, add);
+        });
+      }
+    }
+  }
+}
+
+// c (m x n) = a (m x k) * b (k x n), or c += a * b if accumulate; c must not overlap a or b
+inline void gemm(std::size_t m, std::size_t n, std::size_t k, const float* a, std::size_t lda, const float* b,
+                 std::size_t ldb, float* c, std::size_t ldc, bool accumulate = false) {
+  detail::gemm(m, n, k, a, lda, b, ldb, c, ldc, accumulate, 1u, [](std::size_t count, const auto& block) {
+    for (std::size_t i{0}; i < count; ++i)
+      block(i, 0u);
+  });
+}
+}
+}
@@ -0,0 +1,198 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+#include <sys/mman.h>
+#include <immintrin.h>
+#include "VecBase.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// alignment in the type: AlignedVector and AlignedSpan guarantee it statically so that kernels can pick aligned and
+// streaming loads and stores at compile time, see the AlignedSpan overloads in VecLoop.h
+
+template <std::size_t Alignment>
+struct IsValidAlignment final {
+  static const constexpr bool value = Alignment != 0 && (Alignment & (Alignment - 1)) == 0;
+};
+
+
+// std allocator handing out Alignment-aligned memory, e.g. for std::vector; not final, containers derive from it
+template <typename T, std::size_t Alignment = 32u>
+struct AlignedAllocator {
+  static_assert(IsValidAlignment<Alignment>::value, "alignment has to be a power of two");
+  static_assert(Alignment >= alignof(T), "alignment has to be at least the type's alignment");
+
+  using value_type = T;
+
+  template <typename U>
+  struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+  T* allocate(std::size_t n) {
+    if (n > static_cast<std::size_t>(-1) / sizeof(T))
+      throw std::bad_alloc{};
+
+    auto* p = _mm_malloc(n * sizeof(T), Alignment);
+    if (p == nullptr)
+      throw std::bad_alloc{};
+
+    return static_cast<T*>(p);
+  }
+
+  void deallocate(T* p, std::size_t) { _mm_free(p); }
+};
+
+template <typename T, typename U, std::size_t Alignment>
+inline bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) {
+  return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+inline bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) {
+  return false;
+}
+
+template <typename T, std::size_t Alignment = 32u>
+using AlignedVector = std::vector<T, AlignedAllocator<T, Alignment>>;
+
+
+// non-owning view of n elements starting at an Alignment-aligned address
+template <typename T, std::size_t Alignment = 32u>
+struct AlignedSpan final {
+  static_assert(IsValidAlignment<Alignment>::value, "alignment has to be a power of two");
+
+  using Value = T;
+  static const constexpr std::size_t Align = Alignment;
+
+  AlignedSpan() : first(nullptr), n(0) {}
+
+  AlignedSpan(T* data, std::size_t size) : first(data), n(size) {
+    assert(reinterpret_cast<std::uintptr_t>(data) % Alignment == 0);
+  }
+
+  // const views from mutable ones, and weaker alignments from stronger ones
+  template <typename U, std::size_t Stronger>
+  AlignedSpan(const AlignedSpan<U, Stronger>& other) : first(other.data()), n(other.size()) {
+    static_assert(Stronger >= Alignment, "cannot strengthen alignment");
+  }
+
+  T* data() const { return static_cast<T*>(__builtin_assume_aligned(first, Alignment)); }
+  std::size_t size() const { return n; }
+  bool empty() const { return n == 0; }
+
+  T* begin() const { return data(); }
+  T* end() const { return data() + n; }
+
+  T& operator[](std::size_t index) const {
+    assert(index < n);
+    return data()[index];
+  }
+
+  // elements [offset, offset + count); offset has to keep the alignment
+  AlignedSpan subspan(std::size_t offset, std::size_t count) const {
+    assert(offset + count <= n);
+    return {first + offset, count};
+  }
+
+private:
+  T* first;
+  std::size_t n;
+};
+
+template <typename T, std::size_t Alignment>
+inline AlignedSpan<T, Alignment> span(std::vector<T, AlignedAllocator<T, Alignment>>& v) {
+  return {v.data(), v.size()};
+}
+
+template <typename T, std::size_t Alignment>
+inline AlignedSpan<const T, Alignment> span(const std::vector<T, AlignedAllocator<T, Alignment>>& v) {
+  return {v.data(), v.size()};
+}
+
+
+// bump allocator for per-request scratch buffers: allocations are a pointer increment, reset() frees all at once
+// backed by a single anonymous mapping; 2 MiB huge pages are tried first if asked for, then transparent huge pages
+class Arena final {
+public:
+  static const constexpr std::size_t HugePageBytes = 2u << 20;
+
+  explicit Arena(std::size_t capacity, bool hugePages = false)
+      : bytes(capacity), mapped(capacity), offset(0), huge(false) {
+    void* p = MAP_FAILED;
+
+#if defined(MAP_HUGETLB) && defined(MAP_HUGE_SHIFT)
+    // hugetlb lengths are whole huge pages, munmap fails on anything else; the size is explicit, not the default
+    if (hugePages) {
+      const auto rounded = (bytes + HugePageBytes - 1) & ~(HugePageBytes - 1);
+      const auto flags = MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | 21 << MAP_HUGE_SHIFT;
+
+      p = ::mmap(nullptr, rounded, PROT_READ | PROT_WRITE, flags, -1, 0);
+      huge = p != MAP_FAILED;
+
+      if (huge)
+        mapped = rounded;
+    }
+#endif
+
+    if (p == MAP_FAILED)
+      p = ::mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+
+    if (p == MAP_FAILED)
+      throw std::bad_alloc{};
+
+#ifdef MADV_HUGEPAGE
+    if (hugePages && !huge)
+      ::madvise(p, mapped, MADV_HUGEPAGE);
+#endif
+
+    base = static_cast<unsigned char*>(p);
+  }
+
+  ~Arena() { ::munmap(base, mapped); }
+
+  Arena(const Arena&) = delete;
+  Arena& operator=(const Arena&) = delete;
+
+  // n default-initialized elements; throws std::bad_alloc if the arena is exhausted
+  template <typename T, std::size_t Alignment = 32u>
+  AlignedSpan<T, Alignment> allocate(std::size_t n) {
+    static_assert(IsValidAlignment<Alignment>::value, "alignment has to be a power of two");
+    static_assert(Alignment >= alignof(T), "alignment has to be at least the type's alignment");
+
+    // the mapping is page aligned, so aligning the offset aligns the address
+    const auto aligned = (offset + Alignment - 1) & ~(Alignment - 1);
+
+    if (aligned > bytes || n > (bytes - aligned) / sizeof(T))
+      throw std::bad_alloc{};
+
+    offset = aligned + n * sizeof(T);
+    return {::new (base + aligned) T[n], n};
+  }
+
+  // invalidates all spans handed out so far; the memory stays mapped
+  void reset() { offset = 0; }
+
+  std::size_t used() const { return offset; }
+  std::size_t capacity() const { return bytes; }
+  bool hugePages() const { return huge; }
+
+private:
+  unsigned char* base;
+  std::size_t bytes;  // usable, as asked for
+  std::size_t mapped; // whole huge pages with hugetlb
+  std::size_t offset;
+  bool huge;
+};
+}
+}
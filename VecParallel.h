@@ -0,0 +1,120 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "Parallel.h"
+#include "VecLoop.h"
+#include "VecMatrix.h"
+#include "VecRandom.h"
+#include "VecReduce.h"
+#include "VecScan.h"
+
+namespace avx {
+namespace parallel {
+inline namespace AVX_ISA_NAMESPACE {
+
+// vec kernels over the pool, see Parallel.h; chunks are cut along the output's cache lines
+
+// out[i] = kernel(x[i]) for x in [first, last), see avx::transform
+template <typename T, typename Kernel>
+inline void transform(const T* first, const T* last, T* out, Kernel kernel, Schedule schedule = Schedule::stealing) {
+  forEach(out, static_cast<std::size_t>(last - first), [&](std::size_t i, std::size_t j) {
+    avx::transform(first + i, first + j, out + i, kernel);
+  }, schedule);
+}
+
+// out[i] = kernel(x[i], y[i]) for x in [first1, last1), y in [first2, first2 + (last1 - first1)), see avx::transform
+template <typename T, typename Kernel>
+inline void transform(const T* first1, const T* last1, const T* first2, T* out, Kernel kernel,
+                      Schedule schedule = Schedule::stealing) {
+  forEach(out, static_cast<std::size_t>(last1 - first1), [&](std::size_t i, std::size_t j) {
+    avx::transform(first1 + i, first1 + j, first2 + i, out + i, kernel);
+  }, schedule);
+}
+
+// see avx::sum; float sums differ in the last bits between runs with Schedule::stealing
+template <std::size_t Accumulators = 4, typename T>
+inline T sum(const T* first, const T* last, Schedule schedule = Schedule::stealing) {
+  return reduce(first, static_cast<std::size_t>(last - first), T{0}, [&](std::size_t i, std::size_t j) {
+    return avx::sum<Accumulators>(first + i, first + j);
+  }, [](T lhs, T rhs) { return lhs + rhs; }, schedule);
+}
+
+// see avx::inclusiveScan, in two passes: chunk sums, then each chunk's scan from the sum of all chunks before it
+template <typename T>
+inline T inclusiveScan(const T* first, const T* last, T* out, T init = T{0}, Schedule schedule = Schedule::stealing) {
+  return scan(out, static_cast<std::size_t>(last - first), init, [&](std::size_t i, std::size_t j) {
+    return avx::sum(first + i, first + j);
+  }, [](T lhs, T rhs) { return lhs + rhs; }, [&](std::size_t i, std::size_t j, T carry) {
+    avx::inclusiveScan(first + i, first + j, out + i, carry);
+  }, schedule);
+}
+
+// see avx::exclusiveScan and inclusiveScan above
+template <typename T>
+inline T exclusiveScan(const T* first, const T* last, T* out, T init = T{0}, Schedule schedule = Schedule::stealing) {
+  return scan(out, static_cast<std::size_t>(last - first), init, [&](std::size_t i, std::size_t j) {
+    return avx::sum(first + i, first + j);
+  }, [](T lhs, T rhs) { return lhs + rhs; }, [&](std::size_t i, std::size_t j, T carry) {
+    avx::exclusiveScan(first + i, first + j, out + i, carry);
+  }, schedule);
+}
+
+// see avx::copyIf, in two passes: chunk counts, then each chunk's copies after those of all chunks before it.
+// out needs room for the copies only, and must not overlap [first, last)
+template <typename T, typename Predicate>
+inline T* copyIf(const T* first, const T* last, T* out, Predicate predicate, Schedule schedule = Schedule::stealing) {
+  const auto n = static_cast<std::size_t>(last - first);
+  const auto plus = [](std::size_t lhs, std::size_t rhs) { return lhs + rhs; };
+
+  // the chunk is counted again for its room in out, from L1 by then: stores must not spill into the next chunk's copies
+  const auto count = scan(first, n, std::size_t{0}, [&](std::size_t i, std::size_t j) {
+    return avx::countIf(first + i, first + j, predicate);
+  }, plus, [&](std::size_t i, std::size_t j, std::size_t offset) {
+    avx::detail::copyIf(first + i, j - i, out + offset, avx::countIf(first + i, first + j, predicate), predicate);
+  }, schedule);
+
+  return out + count;
+}
+
+// see avx::fillUniform; element i is lane i % 8 of the (i / 8)-th vec8i of Philox4x32(seed) as from the serial fill:
+// the values depend on the seed and the index alone, not on the array's address, the number of workers or the schedule.
+// Each chunk seeks its own engine to its first element.
+inline void fillUniform(std::uint64_t seed, float* first, float* last, float lo = 0.f, float hi = 1.f,
+                        Schedule schedule = Schedule::stealing) {
+  forEachIndex(static_cast<std::size_t>(last - first), DefaultGrainBytes / sizeof(float),
+               [&](std::size_t i, std::size_t j) {
+                 Philox4x32 engine{seed};
+                 engine.seek(i / vec8f::Size);
+                 avx::fillUniform(engine, first + i, first + j, lo, hi);
+               }, schedule);
+}
+
+// see avx::fillNormal and fillUniform above; Box-Muller draws twice per two vecs, so chunks start at multiples of 16
+inline void fillNormal(std::uint64_t seed, float* first, float* last, float mean = 0.f, float stddev = 1.f,
+                       Schedule schedule = Schedule::stealing) {
+  static_assert(DefaultGrainBytes / sizeof(float) % (2u * vec8f::Size) == 0, "chunks have to start on a vec pair");
+
+  forEachIndex(static_cast<std::size_t>(last - first), DefaultGrainBytes / sizeof(float),
+               [&](std::size_t i, std::size_t j) {
+                 Philox4x32 engine{seed};
+                 engine.seek(i / vec8f::Size);
+                 avx::fillNormal(engine, first + i, first + j, mean, stddev);
+               }, schedule);
+}
+
+// see avx::gemm; the mc row blocks of a are spread across the pool, each worker packs them into a buffer of its own
+inline void gemm(std::size_t m, std::size_t n, std::size_t k, const float* a, std::size_t lda, const float* b,
+                 std::size_t ldb, float* c, std::size_t ldc, bool accumulate = false,
+                 Schedule schedule = Schedule::stealing) {
+  avx::detail::gemm(m, n, k, a, lda, b, ldb, c, ldc, accumulate, concurrency(), [&](std::size_t count, const auto& block) {
+    using Block = std::decay_t<decltype(block)>;
+    detail::run(count, schedule, [](const void* context, std::size_t chunk, std::size_t worker) {
+      (*static_cast<const Block*>(context))(chunk, worker);
+    }, &block);
+  });
+}
+}
+}
+}
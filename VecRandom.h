@@ -0,0 +1,280 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Vec8Float.h"
+#include "Vec8Int.h"
+#include "Vec8FloatMath.h"
+#include "VecHash.h"
+#include "VecLoop.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// pseudo-random numbers eight lanes at a time, each lane an independent stream; engines have next() returning a vec8i
+// of 32 random bits per lane and are seeded by (seed, stream) so that e.g. one stream per thread is reproducible:
+//   Xoshiro128Plus: xoshiro128+, 128 bits of state per lane. Lanes are 2^64 steps apart on the seed's sequence,
+//   streams 2^96 -- seeding costs a long jump per stream, use small stream numbers such as thread indices.
+//   Philox4x32: Philox4x32-10, counter-based: the bits are a keyed hash of (stream, lane, position), any stream and
+//   position is as cheap to get to as any other. Half as fast as xoshiro128+, but passes BigCrush.
+//   uniform: [0, 1) from the upper 23 bits as mantissa of a float in [1, 2), minus one -- no int to float conversion
+//   normal: Box-Muller on two uniforms, two normals per call; the tails are cut off at about 5.6 sigma
+// There is no PCG32: its 64 bit state multiply per lane has no AVX2 instruction.
+
+namespace detail {
+
+  // splitmix64, for seeding: distinct seeds become well mixed states
+  inline std::uint64_t splitMix64(std::uint64_t& x) {
+    auto z = (x += 0x9E3779B97F4A7C15u);
+    z = (z ^ z >> 30) * 0xBF58476D1CE4E5B9u;
+    z = (z ^ z >> 27) * 0x94D049BB133111EBu;
+    return z ^ z >> 31;
+  }
+
+  // one lane of xoshiro128+, for seeding and jumping
+  struct Xoshiro128 final {
+    std::uint32_t s[4];
+
+    void next() {
+      const auto t = s[1] << 9;
+      s[2] ^= s[0];
+      s[3] ^= s[1];
+      s[1] ^= s[2];
+      s[0] ^= s[3];
+      s[2] ^= t;
+      s[3] = s[3] << 11 | s[3] >> 21;
+    }
+
+    // advances by the power of two the polynomial stands for
+    void jump(const std::uint32_t (&polynomial)[4]) {
+      std::uint32_t t[4] = {};
+
+      for (auto word : polynomial)
+        for (int b{0}; b < 32; ++b) {
+          if (word & 1u << b)
+            for (int i{0}; i < 4; ++i)
+              t[i] ^= s[i];
+          next();
+        }
+
+      for (int i{0}; i < 4; ++i)
+        s[i] = t[i];
+    }
+  };
+
+  static const constexpr std::uint32_t Jump64[4] = {0x8764000Bu, 0xF542D2D3u, 0x6FA035C3u, 0x77F2DB5Bu};
+  static const constexpr std::uint32_t Jump96[4] = {0xB523952Eu, 0x0B6F099Fu, 0xCCF5A0EFu, 0x1C580662u};
+
+  namespace philox {
+    static const constexpr std::uint32_t multiplier0 = 0xD2511F53u;
+    static const constexpr std::uint32_t multiplier1 = 0xCD9E8D57u;
+    static const constexpr std::uint32_t weyl0 = 0x9E3779B9u;
+    static const constexpr std::uint32_t weyl1 = 0xBB67AE85u;
+    static const constexpr int rounds = 10;
+  }
+}
+
+
+class Xoshiro128Plus final {
+public:
+  explicit Xoshiro128Plus(std::uint64_t seed, std::uint64_t stream = 0) {
+    const auto low = detail::splitMix64(seed), high = detail::splitMix64(seed);
+
+    detail::Xoshiro128 lane{{static_cast<std::uint32_t>(low), static_cast<std::uint32_t>(low >> 32),
+                             static_cast<std::uint32_t>(high), static_cast<std::uint32_t>(high >> 32)}};
+
+    for (std::uint64_t i{0}; i < stream; ++i)
+      lane.jump(detail::Jump96);
+
+    vec8i::Value state[4][8];
+
+    for (int i{0}; i < 8; ++i) {
+      for (int j{0}; j < 4; ++j)
+        state[j][i] = static_cast<vec8i::Value>(lane.s[j]);
+      lane.jump(detail::Jump64);
+    }
+
+    s0.load(state[0], state[0] + 8);
+    s1.load(state[1], state[1] + 8);
+    s2.load(state[2], state[2] + 8);
+    s3.load(state[3], state[3] + 8);
+  }
+
+  vec8i next() {
+    const auto rv = s0 + s3;
+    const auto t = shiftLeftZeroExtend<9>(s1);
+
+    s2 = s2 ^ s0;
+    s3 = s3 ^ s1;
+    s1 = s1 ^ s2;
+    s0 = s0 ^ s3;
+    s2 = s2 ^ t;
+    s3 = rotateLeft<11>(s3);
+
+    return rv;
+  }
+
+private:
+  vec8i s0, s1, s2, s3;
+};
+
+
+class Philox4x32 final {
+public:
+  // the stream's 64 bits and the lane make up half the counter, the position the other half
+  explicit Philox4x32(std::uint64_t seed, std::uint64_t stream = 0)
+      : key0(static_cast<std::uint32_t>(seed)), key1(static_cast<std::uint32_t>(seed >> 32)),
+        stream0(static_cast<std::uint32_t>(stream)), stream1(static_cast<std::uint32_t>(stream >> 32)), block(0),
+        used(4) {}
+
+  // skips to the position-th vec8i of the stream
+  void seek(std::uint64_t position) {
+    block = position / 4u;
+    used = 4;
+
+    const auto skip = static_cast<int>(position % 4u);
+    if (skip != 0) {
+      generate();
+      used = skip;
+    }
+  }
+
+  vec8i next() {
+    if (used == 4)
+      generate();
+    return words[used++];
+  }
+
+  // the 4 x 32 bit Philox4x32-10 output for one counter and key, lane-wise; see Salmon et al. SC'11, Random123
+  static void bijection(vec8i (&counter)[4], std::uint32_t key0, std::uint32_t key1) {
+    using detail::broadcast;
+    using namespace detail::philox;
+
+    const auto m0 = broadcast(multiplier0), m1 = broadcast(multiplier1);
+
+    for (int round{0}; round < rounds; ++round) {
+      const auto k0 = broadcast(key0 + static_cast<std::uint32_t>(round) * weyl0);
+      const auto k1 = broadcast(key1 + static_cast<std::uint32_t>(round) * weyl1);
+
+      const auto hi0 = mulHiUnsigned(counter[0], m0), lo0 = counter[0] * m0;
+      const auto hi1 = mulHiUnsigned(counter[2], m1), lo1 = counter[2] * m1;
+
+      counter[0] = hi1 ^ counter[1] ^ k0;
+      counter[1] = lo1;
+      counter[2] = hi0 ^ counter[3] ^ k1;
+      counter[3] = lo0;
+    }
+  }
+
+private:
+  // counter (block low, lane | block high << 3, stream low, stream high): 2^61 blocks of four vec8i per stream
+  void generate() {
+    using detail::broadcast;
+
+    words[0] = broadcast(static_cast<std::uint32_t>(block));
+    words[1] = vec8i{0, 1, 2, 3, 4, 5, 6, 7} | broadcast(static_cast<std::uint32_t>(block >> 32 << 3));
+    words[2] = broadcast(stream0);
+    words[3] = broadcast(stream1);
+
+    bijection(words, key0, key1);
+
+    ++block;
+    used = 0;
+  }
+
+  std::uint32_t key0, key1, stream0, stream1;
+  std::uint64_t block;
+  int used;
+  vec8i words[4];
+};
+
+
+// [0, 1) in steps of 2^-23
+template <typename Engine>
+inline vec8f uniform(Engine& engine) {
+  const auto mantissa = shiftRightZeroExtend<9>(engine.next());
+  return reinterpret(mantissa | vec8i{0x3F800000}) - vec8f{1.f};
+}
+
+// [lo, hi)
+template <typename Engine>
+inline vec8f uniform(Engine& engine, float lo, float hi) {
+  return fusedMulAdd(uniform(engine), vec8f{hi - lo}, vec8f{lo});
+}
+
+// two vecs of independent standard normals: radius sqrt(-2 log u) for u in (0, 1], angle 2 pi v
+template <typename Engine>
+inline void normal(Engine& engine, vec8f& z0, vec8f& z1) {
+  const auto u = vec8f{1.f} - uniform(engine);
+  const auto angle = uniform(engine) * vec8f{6.28318530717958647f};
+  const auto radius = sqrt(vec8f{-2.f} * log(u));
+
+  z0 = radius * cos(angle);
+  z1 = radius * sin(angle);
+}
+
+
+// bulk generation into arrays of any length: the k-th vec drawn goes to elements [8k, 8k + 8) with unaligned stores,
+// the last one masked -- the values depend on the engine's state and the index alone, not on the array's address
+
+namespace detail {
+
+  // block(i, count) for [0, n) in blocks of Size from index 0, count is Size but for the tail
+  template <std::size_t Size, typename Block>
+  inline void draws(std::size_t n, Block block) {
+    std::size_t i{0};
+
+    for (; i + Size <= n; i += Size)
+      block(i, Size);
+
+    if (i != n)
+      block(i, n - i);
+  }
+}
+
+// 32 random bits each
+template <typename Engine>
+inline void fillBits(Engine& engine, std::int32_t* first, std::int32_t* last) {
+  detail::draws<vec8i::Size>(static_cast<std::size_t>(last - first), [&](std::size_t i, std::size_t count) {
+    auto x = engine.next();
+    if (count == vec8i::Size)
+      x.store(first + i, first + i + count);
+    else
+      x.store_partial(first + i, first + i + count);
+  });
+}
+
+// uniform in [lo, hi)
+template <typename Engine>
+inline void fillUniform(Engine& engine, float* first, float* last, float lo = 0.f, float hi = 1.f) {
+  detail::draws<vec8f::Size>(static_cast<std::size_t>(last - first), [&](std::size_t i, std::size_t count) {
+    auto x = uniform(engine, lo, hi);
+    if (count == vec8f::Size)
+      x.store(first + i, first + i + count);
+    else
+      x.store_partial(first + i, first + i + count);
+  });
+}
+
+// normal with mean and standard deviation, both of Box-Muller's vecs used: z0 for even blocks, z1 for odd ones
+template <typename Engine>
+inline void fillNormal(Engine& engine, float* first, float* last, float mean = 0.f, float stddev = 1.f) {
+  const vec8f m{mean}, s{stddev};
+  vec8f z0, z1;
+  bool spare = false;
+
+  detail::draws<vec8f::Size>(static_cast<std::size_t>(last - first), [&](std::size_t i, std::size_t count) {
+    if (!spare)
+      normal(engine, z0, z1);
+
+    auto x = fusedMulAdd(spare ? z1 : z0, s, m);
+    spare = !spare;
+
+    if (count == vec8f::Size)
+      x.store(first + i, first + i + count);
+    else
+      x.store_partial(first + i, first + i + count);
+  });
+}
+}
+}
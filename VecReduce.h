@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include <limits>
+#include <utility>
+#include "Vec8Float.h"
+#include "Vec8Int.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// array reductions with independent accumulators: a single accumulator makes every add/FMA wait for the previous one,
+// Accumulators of them keep that many in flight -- 4 to 8 saturate both FMA ports at 4 cycles latency
+//
+// reductions over floats reassociate and therefore differ from a sequential loop in the last bits; see sumKahan and
+// sumPairwise if that matters. Integer sums wrap around.
+
+namespace detail {
+
+  // Accumulators copies of x, without default constructing them first
+  template <std::size_t Accumulators, typename Acc, std::size_t... K>
+  inline std::array<Acc, Accumulators> filled(const Acc& x, std::index_sequence<K...>) {
+    return {{(static_cast<void>(K), x)...}};
+  }
+
+  template <std::size_t Accumulators, typename Acc>
+  inline std::array<Acc, Accumulators> filled(const Acc& x) {
+    static_assert(Accumulators > 0, "at least one accumulator");
+    return filled<Accumulators>(x, std::make_index_sequence<Accumulators>{});
+  }
+
+  // step(acc[k], x, offset) for Accumulators consecutive blocks starting at i; expanded at compile time so that the
+  // accumulators are registers, not an array indexed at runtime
+  template <typename T, typename Acc, std::size_t Accumulators, typename Step, std::size_t... K>
+  inline void steps(const T* first, std::size_t i, std::array<Acc, Accumulators>& acc, Step& step,
+                    std::index_sequence<K...>) {
+    using V = vec<T, 8u>;
+    const int expand[] = {(step(std::get<K>(acc), V(first + i + K * V::Size, first + i + (K + 1) * V::Size), i + K * V::Size), 0)...};
+    static_cast<void>(expand);
+  }
+
+  // step(acc[k], x, offset) for all full blocks, round-robin over the accumulators; returns where the tail starts
+  template <typename T, typename Acc, std::size_t Accumulators, typename Step>
+  inline std::size_t unrolled(const T* first, std::size_t n, std::array<Acc, Accumulators>& acc, Step step) {
+    using V = vec<T, 8u>;
+
+    const auto stride = Accumulators * V::Size;
+    std::size_t i{0};
+
+    for (; i + stride <= n; i += stride)
+      steps(first, i, acc, step, std::make_index_sequence<Accumulators>{});
+
+    // less than Accumulators blocks left
+    for (; i + V::Size <= n; i += V::Size)
+      step(std::get<0>(acc), V(first + i, first + i + V::Size), i);
+
+    return i;
+  }
+
+  // the last n % 8 elements, lanes past the end are identity
+  template <typename T>
+  inline vec<T, 8u> tail(const T* first, const T* last, T identity) {
+    vec<T, 8u> x;
+    x.load_partial(first, last);
+    return blend(vec<T, 8u>{identity}, x, laneMask(static_cast<std::size_t>(last - first)));
+  }
+
+  template <typename Acc, std::size_t Accumulators, typename Combine>
+  inline Acc combine(const std::array<Acc, Accumulators>& acc, Combine fn) {
+    auto rv = acc[0];
+    for (std::size_t k{1}; k < Accumulators; ++k)
+      rv = fn(rv, acc[k]);
+    return rv;
+  }
+
+  template <typename T>
+  struct Bounds final {
+    static T lowest() { return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                                                     : std::numeric_limits<T>::lowest(); }
+    static T highest() { return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                                      : std::numeric_limits<T>::max(); }
+  };
+
+  inline vec8i asMask(const vec8f& mask) { return reinterpret(mask); }
+  inline vec8i asMask(const vec8i& mask) { return mask; }
+
+  template <bool Max, typename T>
+  inline bool better(T x, T best) { return Max ? x > best : x < best; }
+
+  template <bool Max, typename T>
+  inline vec<T, 8u> better(const vec<T, 8u>& x, const vec<T, 8u>& best) { return Max ? x > best : x < best; }
+
+  // index of the first minimum resp. maximum, n for an empty range; nans are never better
+  template <std::size_t Accumulators, bool Max, typename T>
+  inline std::size_t argBest(const T* first, const T* last) {
+    using V = vec<T, 8u>;
+    const auto n = static_cast<std::size_t>(last - first);
+    const auto identity = Max ? Bounds<T>::lowest() : Bounds<T>::highest();
+
+    struct Best {
+      V value;
+      vec8i index;
+    };
+
+    auto acc = filled<Accumulators>(Best{V{identity}, vec8i{-1}});
+
+    const vec8i iota{0, 1, 2, 3, 4, 5, 6, 7};
+    const auto step = [&](Best& best, const V& x, std::size_t offset) {
+      const auto mask = better<Max>(x, best.value);
+      best.value = blend(best.value, x, mask);
+      best.index = blend(best.index, iota + vec8i{static_cast<vec8i::Value>(offset)}, asMask(mask));
+    };
+
+    const auto i = unrolled(first, n, acc, step);
+    if (i != n)
+      step(std::get<0>(acc), tail(first + i, last, identity), i);
+
+    // per lane offsets only grow so the first better element is kept; across lanes ties go to the lower index
+    std::size_t rv{n};
+    T value{identity};
+
+    for (const auto& each : acc)
+      for (std::size_t lane{0}; lane < V::Size; ++lane) {
+        if (each.index[lane] < 0)
+          continue;
+
+        const auto index = static_cast<std::size_t>(each.index[lane]);
+        const auto candidate = each.value[lane];
+
+        if (rv == n || better<Max>(candidate, value) || (candidate == value && index < rv)) {
+          rv = index;
+          value = candidate;
+        }
+      }
+
+    // all elements equal to the identity (or nan): the first one is as good as any
+    return rv == n && n != 0 ? 0 : rv;
+  }
+}
+
+
+template <std::size_t Accumulators = 4, typename T>
+inline T sum(const T* first, const T* last) {
+  using V = vec<T, 8u>;
+  const auto n = static_cast<std::size_t>(last - first);
+
+  auto acc = detail::filled<Accumulators>(V{});
+
+  const auto i = detail::unrolled(first, n, acc, [](V& lhs, const V& x, std::size_t) { lhs += x; });
+  if (i != n)
+    acc[0] += detail::tail(first + i, last, T{0});
+
+  return hSum(detail::combine(acc, [](const V& lhs, const V& rhs) { return lhs + rhs; }));
+}
+
+template <std::size_t Accumulators = 4, typename T>
+inline T minimum(const T* first, const T* last) {
+  using V = vec<T, 8u>;
+  const auto n = static_cast<std::size_t>(last - first);
+  const auto identity = detail::Bounds<T>::highest();
+
+  auto acc = detail::filled<Accumulators>(V{identity});
+
+  const auto i = detail::unrolled(first, n, acc, [](V& lhs, const V& x, std::size_t) { lhs = min(lhs, x); });
+  if (i != n)
+    acc[0] = min(acc[0], detail::tail(first + i, last, identity));
+
+  return hMin(detail::combine(acc, [](const V& lhs, const V& rhs) { return min(lhs, rhs); }));
+}
+
+template <std::size_t Accumulators = 4, typename T>
+inline T maximum(const T* first, const T* last) {
+  using V = vec<T, 8u>;
+  const auto n = static_cast<std::size_t>(last - first);
+  const auto identity = detail::Bounds<T>::lowest();
+
+  auto acc = detail::filled<Accumulators>(V{identity});
+
+  const auto i = detail::unrolled(first, n, acc, [](V& lhs, const V& x, std::size_t) { lhs = max(lhs, x); });
+  if (i != n)
+    acc[0] = max(acc[0], detail::tail(first + i, last, identity));
+
+  return hMax(detail::combine(acc, [](const V& lhs, const V& rhs) { return max(lhs, rhs); }));
+}
+
+// index of the first minimum resp. maximum, last - first for empty ranges; nans are skipped
+template <std::size_t Accumulators = 4, typename T>
+inline std::size_t argMin(const T* first, const T* last) {
+  return detail::argBest<Accumulators, false>(first, last);
+}
+
+template <std::size_t Accumulators = 4, typename T>
+inline std::size_t argMax(const T* first, const T* last) {
+  return detail::argBest<Accumulators, true>(first, last);
+}
+
+// sum of first1[i] * first2[i], fused multiply-adds
+template <std::size_t Accumulators = 4>
+inline float dot(const float* first1, const float* last1, const float* first2) {
+  const auto n = static_cast<std::size_t>(last1 - first1);
+
+  auto acc = detail::filled<Accumulators>(vec8f{0.f});
+
+  const auto i = detail::unrolled(first1, n, acc, [&](vec8f& lhs, const vec8f& x, std::size_t offset) {
+    lhs = fusedMulAdd(x, vec8f(first2 + offset, first2 + offset + vec8f::Size), lhs);
+  });
+
+  if (i != n) {
+    vec8f x{0.f}, y{0.f};
+    x.load_partial(first1 + i, last1);
+    y.load_partial(first2 + i, first2 + n);
+    acc[0] = fusedMulAdd(x, y, acc[0]);
+  }
+
+  return hSum(detail::combine(acc, [](const vec8f& lhs, const vec8f& rhs) { return lhs + rhs; }));
+}
+
+// compensated (Kahan-Babuska-Neumaier) summation: error independent of n, several times slower than sum
+template <std::size_t Accumulators = 4>
+inline float sumKahan(const float* first, const float* last) {
+  const auto n = static_cast<std::size_t>(last - first);
+
+  struct Compensated {
+    vec8f sum;
+    vec8f compensation;
+  };
+
+  auto acc = detail::filled<Accumulators>(Compensated{vec8f{0.f}, vec8f{0.f}});
+
+  const auto step = [](Compensated& lhs, const vec8f& x, std::size_t) {
+    const auto t = lhs.sum + x;
+    const auto larger = abs(lhs.sum) >= abs(x);
+    lhs.compensation += blend(x - t, lhs.sum - t, larger) + blend(lhs.sum, x, larger);
+    lhs.sum = t;
+  };
+
+  const auto i = detail::unrolled(first, n, acc, step);
+  if (i != n)
+    step(acc[0], detail::tail(first + i, last, 0.f), i);
+
+  // the few partial sums left are combined in double precision
+  double rv{0};
+  for (const auto& each : acc)
+    for (std::size_t lane{0}; lane < vec8f::Size; ++lane)
+      rv += static_cast<double>(each.sum[lane]) + static_cast<double>(each.compensation[lane]);
+
+  return static_cast<float>(rv);
+}
+
+// pairwise summation: error grows with log n instead of n, at the speed of sum
+template <std::size_t Accumulators = 4>
+inline float sumPairwise(const float* first, const float* last) {
+  const auto n = static_cast<std::size_t>(last - first);
+  const std::size_t block = 64u * Accumulators * vec8f::Size;
+
+  if (n <= block)
+    return sum<Accumulators>(first, last);
+
+  // a multiple of the block size, at least one block and less than n
+  const auto half = (n / 2 + block - 1) / block * block;
+  return sumPairwise<Accumulators>(first, first + half) + sumPairwise<Accumulators>(first + half, last);
+}
+}
+}
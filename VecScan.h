@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Vec8Float.h"
+#include "Vec8Int.h"
+#include "VecSort.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// prefix sums and stream compaction over int32 and float arrays, eight lanes at a time:
+//   scans: log-step in registers -- add the lanes shifted up by one, two and four -- plus the running total broadcast
+//   from the previous block's last lane; float sums are associated differently than in a scalar loop
+//   copyIf: the predicate's movemask indexes a left-pack permute, see VecSort.h, full stores wherever out has room
+
+namespace detail {
+
+  // lane i gets lane i - K, the lowest K lanes are zero
+  template <int K, typename V>
+  inline V shiftLanesUp(const V& x) {
+    const auto index = max(vec8i{0, 1, 2, 3, 4, 5, 6, 7} - vec8i{K}, vec8i{0});
+    return blend<(1 << K) - 1>(permute(x, index), V{typename V::Value{0}});
+  }
+
+  // lane i = x[0] + .. + x[i]
+  template <typename V>
+  inline V scanLanes(V x) {
+    x += shiftLanesUp<1>(x);
+    x += shiftLanesUp<2>(x);
+    return x + shiftLanesUp<4>(x);
+  }
+
+  template <bool Inclusive, typename T>
+  inline T scan(const T* first, const T* last, T* out, T init) {
+    using V = vec<T, 8u>;
+    const auto n = static_cast<std::size_t>(last - first);
+
+    V carry{init};
+    std::size_t i{0};
+
+    for (; i + V::Size <= n; i += V::Size) {
+      const auto scanned = scanLanes(V{first + i, first + i + V::Size});
+      (carry + (Inclusive ? scanned : shiftLanesUp<1>(scanned))).store(out + i, out + i + V::Size);
+      carry += permute(scanned, vec8i{7});
+    }
+
+    // masked-out lanes are zero and do not change the sums
+    if (i != n) {
+      V x;
+      x.load_partial(first + i, last);
+      const auto scanned = scanLanes(x);
+      (carry + (Inclusive ? scanned : shiftLanesUp<1>(scanned))).store_partial(out + i, out + n);
+      carry += permute(scanned, vec8i{7});
+    }
+
+    return carry[0];
+  }
+
+  // out has room for room elements: full stores while they fit, masked ones after that
+  template <typename T, typename Predicate>
+  inline std::size_t copyIf(const T* first, std::size_t n, T* out, std::size_t room, Predicate predicate) {
+    using V = vec<T, 8u>;
+    const auto& table = leftPackTable();
+
+    std::size_t written{0};
+
+    // the table puts the lanes with clear bits first
+    const auto pack = [&](const V& x, int mask) {
+      const auto* index = table.index[~mask & 0xFF];
+      auto packed = permute(x, vec8i{index, index + 8});
+      const auto count = static_cast<std::size_t>(__builtin_popcount(mask));
+
+      if (written + V::Size <= room)
+        packed.store(out + written, out + written + V::Size);
+      else
+        packed.store_partial(out + written, out + written + count);
+
+      written += count;
+    };
+
+    std::size_t i{0};
+
+    for (; i + V::Size <= n; i += V::Size) {
+      const V x{first + i, first + i + V::Size};
+      pack(x, moveMask(predicate(x)));
+    }
+
+    if (i != n) {
+      V x;
+      x.load_partial(first + i, first + n);
+      pack(x, moveMask(predicate(x)) & ((1 << (n - i)) - 1));
+    }
+
+    return written;
+  }
+}
+
+
+// out[i] = init + x[0] + .. + x[i] for x in [first, last); out may alias first. Returns init plus the sum of all x.
+template <typename T>
+inline T inclusiveScan(const T* first, const T* last, T* out, T init = T{0}) {
+  return detail::scan<true>(first, last, out, init);
+}
+
+// out[i] = init + x[0] + .. + x[i - 1] for x in [first, last); out may alias first. Returns init plus the sum of all x.
+template <typename T>
+inline T exclusiveScan(const T* first, const T* last, T* out, T init = T{0}) {
+  return detail::scan<false>(first, last, out, init);
+}
+
+// number of x in [first, last) whose lane is set in predicate(x), a comparison mask,
+// e.g. [](const vec8f& x) { return x > vec8f{0.f}; }
+template <typename T, typename Predicate>
+inline std::size_t countIf(const T* first, const T* last, Predicate predicate) {
+  using V = vec<T, 8u>;
+  const auto n = static_cast<std::size_t>(last - first);
+
+  std::size_t rv{0}, i{0};
+
+  for (; i + V::Size <= n; i += V::Size)
+    rv += static_cast<std::size_t>(__builtin_popcount(moveMask(predicate(V{first + i, first + i + V::Size}))));
+
+  if (i != n) {
+    V x;
+    x.load_partial(first + i, last);
+    rv += static_cast<std::size_t>(__builtin_popcount(moveMask(predicate(x)) & ((1 << (n - i)) - 1)));
+  }
+
+  return rv;
+}
+
+// the x in [first, last) whose lane is set in predicate(x), in order, to out; returns the end of the copies.
+// out needs room for last - first elements, the ones past the returned end are clobbered; out may alias first
+template <typename T, typename Predicate>
+inline T* copyIf(const T* first, const T* last, T* out, Predicate predicate) {
+  const auto n = static_cast<std::size_t>(last - first);
+  return out + detail::copyIf(first, n, out, n, predicate);
+}
+}
+}
@@ -0,0 +1,213 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include "Vec32Byte.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// searching byte buffers 64 bytes at a time: a block is compared against a few needle bytes at once, the comparisons
+// movemasked into one 64 bit mask with a bit per position; set bits are walked lowest first with count trailing zeros
+// (tzcnt) and clear lowest set bit (blsr). Built on top: find (memchr), findAny, length (strlen), substring find and
+// csv delimiters. The last partial block is copied to a buffer, nothing outside the given ranges is read -- except by
+// length, which has to read aligned blocks to stay within pages.
+
+namespace detail {
+
+  inline vec32b loadBytes(const char* first) {
+    const auto* bytes = reinterpret_cast<const std::int8_t*>(first);
+    return {bytes, bytes + 32};
+  }
+
+  inline std::uint64_t moveMask64(const vec32b& low, const vec32b& high) {
+    const auto high32 = static_cast<std::uint64_t>(static_cast<std::uint32_t>(moveMask(high)));
+    return static_cast<std::uint32_t>(moveMask(low)) | high32 << 32;
+  }
+
+  inline std::size_t lowestBit(std::uint64_t mask) { return static_cast<std::size_t>(__builtin_ctzll(mask)); }
+  inline std::uint64_t clearLowestBit(std::uint64_t mask) { return mask & (mask - 1); }
+
+  // bits below count
+  inline std::uint64_t firstBits(std::size_t count) {
+    return count >= 64u ? ~std::uint64_t{0} : (std::uint64_t{1} << count) - 1;
+  }
+
+  // block(offset, bytes, valid) for the 64 byte blocks of [first, last): bytes is the block, or a zero padded copy of
+  // the last partial one, valid the positions within the range. Stops early once block returns true.
+  template <typename Block>
+  inline void blocks64(const char* first, const char* last, Block block) {
+    const auto n = static_cast<std::size_t>(last - first);
+    std::size_t i{0};
+
+    for (; i + 64u <= n; i += 64u)
+      if (block(i, first + i, ~std::uint64_t{0}))
+        return;
+
+    if (i != n) {
+      alignas(32) char rest[64] = {};
+      std::memcpy(rest, first + i, n - i);
+      block(i, rest, firstBits(n - i));
+    }
+  }
+
+  // bit i is the xor of bits 0 .. i: set from an opening quote up to and excluding the closing one
+  inline std::uint64_t prefixXor(std::uint64_t x) {
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    return x ^ x << 32;
+  }
+}
+
+
+// up to a handful of needle bytes searched for at once, each broadcast to a register once
+template <std::size_t Count>
+struct Needles final {
+  static_assert(Count > 0u, "at least one needle");
+
+  vec32b bytes[Count];
+
+  // lanes of [bytes, bytes + 32) holding any of the needles
+  vec32b equal(const char* block) const {
+    const auto x = detail::loadBytes(block);
+    auto rv = x == bytes[0];
+
+    for (std::size_t i{1}; i < Count; ++i)
+      rv = rv | (x == bytes[i]);
+
+    return rv;
+  }
+
+  // positions in [block, block + 64) holding any of the needles
+  std::uint64_t match(const char* block) const { return detail::moveMask64(equal(block), equal(block + 32)); }
+};
+
+template <typename... Chars>
+inline Needles<sizeof...(Chars)> needles(Chars... chars) {
+  return {{vec32b{static_cast<vec32b::Value>(chars)}...}};
+}
+
+
+// fn(offset) for every position in [first, last) holding one of the needles, in order
+template <std::size_t Count, typename Fn>
+inline void forEachMatch(const char* first, const char* last, const Needles<Count>& needles, Fn fn) {
+  detail::blocks64(first, last, [&](std::size_t offset, const char* block, std::uint64_t valid) {
+    for (auto mask = needles.match(block) & valid; mask != 0; mask = detail::clearLowestBit(mask))
+      fn(offset + detail::lowestBit(mask));
+    return false;
+  });
+}
+
+// first position in [first, last) holding one of the needles, last if there is none
+template <std::size_t Count>
+inline const char* findAny(const char* first, const char* last, const Needles<Count>& needles) {
+  const char* rv = last;
+
+  // four registers a step while there are no matches at all, a single test for all of them
+  for (; last - first >= 128; first += 128) {
+    const auto low = needles.equal(first) | needles.equal(first + 32);
+    const auto high = needles.equal(first + 64) | needles.equal(first + 96);
+    const auto any = low | high;
+    if (!isZFlagSet(any, any))
+      break;
+  }
+
+  detail::blocks64(first, last, [&](std::size_t offset, const char* block, std::uint64_t valid) {
+    const auto mask = needles.match(block) & valid;
+    if (mask == 0)
+      return false;
+    rv = first + offset + detail::lowestBit(mask);
+    return true;
+  });
+
+  return rv;
+}
+
+// first position in [first, last) holding c, last if there is none; see memchr
+inline const char* find(const char* first, const char* last, char c) { return findAny(first, last, needles(c)); }
+
+// bytes before the first zero byte; see strlen. Reads the aligned 32 byte blocks s reaches into, they never cross a
+// page boundary -- starting with the one s is in, the bytes before s masked out.
+inline std::size_t length(const char* s) {
+  const auto misalignment = reinterpret_cast<std::uintptr_t>(s) % 32u;
+  const auto* block = s - misalignment;
+  const vec32b zero{};
+
+  auto mask = static_cast<std::uint32_t>(moveMask(detail::loadBytes(block) == zero)) >> misalignment;
+  if (mask != 0)
+    return static_cast<std::size_t>(__builtin_ctz(mask));
+
+  for (block += 32;; block += 32) {
+    mask = static_cast<std::uint32_t>(moveMask(detail::loadBytes(block) == zero));
+    if (mask != 0)
+      return static_cast<std::size_t>(block - s) + static_cast<std::size_t>(__builtin_ctz(mask));
+  }
+}
+
+// first occurrence of [needleFirst, needleLast) in [first, last), last if there is none; see std::search.
+// Candidates are positions matching both the needle's first and last byte, 32 at a time, verified with memcmp.
+inline const char* find(const char* first, const char* last, const char* needleFirst, const char* needleLast) {
+  const auto n = static_cast<std::size_t>(last - first);
+  const auto k = static_cast<std::size_t>(needleLast - needleFirst);
+
+  if (k == 0)
+    return first;
+  if (k > n)
+    return last;
+  if (k == 1)
+    return find(first, last, *needleFirst);
+
+  const vec32b head{static_cast<vec32b::Value>(needleFirst[0])};
+  const vec32b tail{static_cast<vec32b::Value>(needleFirst[k - 1])};
+
+  // candidates i in [0, n - k], the loads reach up to i + k - 1 + 32
+  std::size_t i{0};
+
+  for (; i + k + 31 <= n; i += 32) {
+    const auto matches = (detail::loadBytes(first + i) == head) & (detail::loadBytes(first + i + k - 1) == tail);
+
+    for (auto mask = static_cast<std::uint32_t>(moveMask(matches)); mask != 0; mask &= mask - 1) {
+      const auto* candidate = first + i + static_cast<std::size_t>(__builtin_ctz(mask));
+      if (std::memcmp(candidate + 1, needleFirst + 1, k - 2) == 0)
+        return candidate;
+    }
+  }
+
+  return std::search(first + i, last, needleFirst, needleLast);
+}
+
+
+// comma-separated values as in RFC 4180: fields end at a separator or a newline outside double quotes, quotes in
+// quoted fields are doubled. fn(offset, newline) for every field end in [first, last), newline at row ends; quoted
+// state is tracked as the prefix xor of the quote positions, carried from block to block. \r of \r\n row ends stays
+// part of the field before.
+template <typename Fn>
+inline void forEachCsvDelimiter(const char* first, const char* last, Fn fn, char separator = ',') {
+  const auto quotes = needles('"');
+  const auto separators = needles(separator);
+  const auto newlines = needles('\n');
+
+  std::uint64_t quoted{0}; // all ones while a quoted field continues into the next block
+
+  detail::blocks64(first, last, [&](std::size_t offset, const char* block, std::uint64_t valid) {
+    const auto inside = detail::prefixXor(quotes.match(block) & valid) ^ quoted;
+    quoted = static_cast<std::uint64_t>(static_cast<std::int64_t>(inside) >> 63);
+
+    const auto outside = valid & ~inside;
+    const auto lineEnds = newlines.match(block) & outside;
+
+    for (auto ends = (separators.match(block) & outside) | lineEnds; ends != 0; ends = detail::clearLowestBit(ends)) {
+      const auto bit = detail::lowestBit(ends);
+      fn(offset + bit, (lineEnds >> bit & 1u) != 0);
+    }
+
+    return false;
+  });
+}
+}
+}
@@ -0,0 +1,498 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "Vec8Float.h"
+#include "Vec8Int.h"
+#include "VecReduce.h"
+
+namespace avx {
+inline namespace AVX_ISA_NAMESPACE {
+
+// sorting int32 and float keys eight at a time, optionally moving an int32 value along with each key (e.g. indices):
+//   up to 64 keys: bitonic networks in registers -- each register's lanes on their own, then merges of 8 + 8, 16 + 16
+//   and 32 + 32 keys across registers
+//   more keys: quicksort, partitioning a register at a time with a movemask and a left-pack permute, down to the above
+// not stable, keys must not be nan, and -0.f and 0.f compare equal: they keep their signs, in either order. merge
+// combines two sorted ranges a register at a time.
+
+namespace detail {
+
+  // keys and their values in lockstep
+  template <typename V>
+  struct KeyValue final {
+    V key;
+    vec8i value;
+  };
+
+  template <typename V>
+  inline const V& keysOf(const V& x) { return x; }
+
+  template <typename V>
+  inline const V& keysOf(const KeyValue<V>& x) { return x.key; }
+
+  template <typename V>
+  inline V permuteLanes(const V& x, const vec8i& index) { return permute(x, index); }
+
+  template <typename V>
+  inline KeyValue<V> permuteLanes(const KeyValue<V>& x, const vec8i& index) {
+    return {permute(x.key, index), permute(x.value, index)};
+  }
+
+  template <typename V>
+  inline V blendLanes(const V& lhs, const V& rhs, const vec8i& mask) { return blend(lhs, rhs, mask); }
+
+  template <typename V>
+  inline KeyValue<V> blendLanes(const KeyValue<V>& lhs, const KeyValue<V>& rhs, const vec8i& mask) {
+    return {blend(lhs.key, rhs.key, mask), blend(lhs.value, rhs.value, mask)};
+  }
+
+
+  // lanes that keep the larger key in step K, J of the bitonic sorter: lane i meets lane i ^ J, ascending in blocks
+  // of K lanes and descending in every other block
+  constexpr int maxLanes(int k, int j) {
+    int rv = 0;
+    for (int i = 0; i < 8; ++i)
+      if (((i & j) != 0) != ((i & k) != 0))
+        rv |= 1 << i;
+    return rv;
+  }
+
+  template <int J>
+  inline vec8i partners() { return vec8i{0, 1, 2, 3, 4, 5, 6, 7} ^ vec8i{J}; }
+
+  // keys alone: min and max, no comparison
+  template <int K, int J, typename V>
+  inline V step(const V& x) {
+    const auto p = permute(x, partners<J>());
+    return blend<maxLanes(K, J)>(min(x, p), max(x, p));
+  }
+
+  // keys with values: swap where the partner's key belongs here, both lanes of a pair agree on it
+  template <int K, int J, typename V>
+  inline KeyValue<V> step(const KeyValue<V>& x) {
+    const auto p = permuteLanes(x, partners<J>());
+    const auto swap = asMask(blend<maxLanes(K, J)>(p.key < x.key, p.key > x.key));
+    return blendLanes(x, p, swap);
+  }
+
+  // a bitonic register's lanes ascending
+  template <typename L>
+  inline L mergeLanes(L x) {
+    x = step<8, 4>(x);
+    x = step<8, 2>(x);
+    return step<8, 1>(x);
+  }
+
+  // a register's lanes ascending
+  template <typename L>
+  inline L sortLanes(L x) {
+    x = step<2, 1>(x);
+    x = step<4, 2>(x);
+    x = step<4, 1>(x);
+    return mergeLanes(x);
+  }
+
+  // lane-wise: lo gets the smaller, hi the larger key. vminps and vmaxps return their second operand for keys that
+  // compare equal, -0.f and 0.f: with the operands swapped for max such a pair swaps instead of both becoming hi
+  template <typename V>
+  inline void exchange(V& lo, V& hi) {
+    const auto smaller = min(lo, hi);
+    hi = max(hi, lo);
+    lo = smaller;
+  }
+
+  template <typename V>
+  inline void exchange(KeyValue<V>& lo, KeyValue<V>& hi) {
+    const auto swap = asMask(hi.key < lo.key);
+    const auto smaller = blendLanes(lo, hi, swap);
+    hi = blendLanes(hi, lo, swap);
+    lo = smaller;
+  }
+
+  template <typename L>
+  inline L reverse(const L& x) { return permuteLanes(x, vec8i{7, 6, 5, 4, 3, 2, 1, 0}); }
+
+  // two sorted registers to sixteen sorted keys, lo the lower eight
+  template <typename L>
+  inline void mergeRegisters(L& lo, L& hi) {
+    hi = reverse(hi);
+    exchange(lo, hi);
+    lo = mergeLanes(lo);
+    hi = mergeLanes(hi);
+  }
+
+  // Count registers as one sequence of Count * 8 keys, Count a power of two: sorted runs of 1, 2, 4 registers are
+  // merged by reversing the second run, which makes the pair bitonic, and half-cleaning at distances run .. 1
+  template <std::size_t Count, typename L>
+  inline void sortRegisters(L* x) {
+    for (std::size_t i{0}; i < Count; ++i)
+      x[i] = sortLanes(x[i]);
+
+    for (std::size_t run{1}; run < Count; run *= 2) {
+      for (std::size_t first{0}; first < Count; first += 2 * run) {
+        auto* y = x + first;
+
+        for (std::size_t i{0}; i < run / 2; ++i)
+          std::swap(y[run + i], y[2 * run - 1 - i]);
+        for (std::size_t i{0}; i < run; ++i)
+          y[run + i] = reverse(y[run + i]);
+
+        for (std::size_t distance{run}; distance > 0; distance /= 2)
+          for (std::size_t block{0}; block < 2 * run; block += 2 * distance)
+            for (std::size_t i{0}; i < distance; ++i)
+              exchange(y[block + i], y[block + i + distance]);
+
+        for (std::size_t i{0}; i < 2 * run; ++i)
+          y[i] = mergeLanes(y[i]);
+      }
+    }
+  }
+
+
+  // lane order for each movemask: lanes with the bit clear first, then the ones with the bit set, each in order
+  struct LeftPackTable final {
+    alignas(32) std::int32_t index[256][8] = {};
+
+    constexpr LeftPackTable() {
+      for (int mask = 0; mask < 256; ++mask) {
+        int lane = 0;
+        for (int i = 0; i < 8; ++i)
+          if ((mask & (1 << i)) == 0)
+            index[mask][lane++] = i;
+        for (int i = 0; i < 8; ++i)
+          if ((mask & (1 << i)) != 0)
+            index[mask][lane++] = i;
+      }
+    }
+  };
+
+  // 8 KiB
+  inline const LeftPackTable& leftPackTable() {
+    static constexpr LeftPackTable table{};
+    return table;
+  }
+
+
+  // what the sort moves around: keys alone, or keys and their values; offsets from the start of the arrays
+  template <typename T>
+  struct Keys final {
+    using Vec = vec<T, 8u>;
+    using Lanes = Vec;
+    using Element = T;
+
+    T* keys;
+
+    Lanes load(std::size_t i) const { return {keys + i, keys + i + 8}; }
+    void store(std::size_t i, Lanes x) const { x.store(keys + i, keys + i + 8); }
+
+    // count may be less than eight, the other lanes are pad
+    Lanes load(std::size_t i, std::size_t count, T pad) const {
+      Vec x;
+      x.load_partial(keys + i, keys + i + count);
+      return blend(Vec{pad}, x, laneMask(count));
+    }
+
+    void store(std::size_t i, std::size_t count, Lanes x) const { x.store_partial(keys + i, keys + i + count); }
+
+    Element get(std::size_t i) const { return keys[i]; }
+    void set(std::size_t i, Element x) const { keys[i] = x; }
+    static T key(Element x) { return x; }
+
+    // pad keys sort last, ties with them do not matter without values
+    bool padSafe(std::size_t, std::size_t, T) const { return true; }
+
+    void sortFallback(std::size_t first, std::size_t last) const { std::sort(keys + first, keys + last); }
+  };
+
+  template <typename T>
+  struct KeysValues final {
+    using Vec = vec<T, 8u>;
+    using Lanes = KeyValue<Vec>;
+    using Element = std::pair<T, std::int32_t>;
+
+    T* keys;
+    std::int32_t* values;
+
+    Lanes load(std::size_t i) const { return {Vec{keys + i, keys + i + 8}, vec8i{values + i, values + i + 8}}; }
+
+    void store(std::size_t i, Lanes x) const {
+      x.key.store(keys + i, keys + i + 8);
+      x.value.store(values + i, values + i + 8);
+    }
+
+    Lanes load(std::size_t i, std::size_t count, T pad) const {
+      Lanes x;
+      x.key.load_partial(keys + i, keys + i + count);
+      x.key = blend(Vec{pad}, x.key, laneMask(count));
+      x.value.load_partial(values + i, values + i + count);
+      return x;
+    }
+
+    void store(std::size_t i, std::size_t count, Lanes x) const {
+      x.key.store_partial(keys + i, keys + i + count);
+      x.value.store_partial(values + i, values + i + count);
+    }
+
+    Element get(std::size_t i) const { return {keys[i], values[i]}; }
+    void set(std::size_t i, Element x) const { keys[i] = x.first, values[i] = x.second; }
+    static T key(Element x) { return x.first; }
+
+    // a real key equal to the pad could swap its value with a pad lane's
+    bool padSafe(std::size_t first, std::size_t last, T pad) const {
+      return std::find(keys + first, keys + last, pad) == keys + last;
+    }
+
+    void sortFallback(std::size_t first, std::size_t last) const {
+      std::vector<Element> elements(last - first);
+      for (std::size_t i{first}; i < last; ++i)
+        elements[i - first] = get(i);
+
+      std::sort(begin(elements), end(elements), [](Element lhs, Element rhs) { return lhs.first < rhs.first; });
+
+      for (std::size_t i{first}; i < last; ++i)
+        set(i, elements[i - first]);
+    }
+  };
+
+  template <typename T>
+  inline T sortPad() {
+    return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity() : std::numeric_limits<T>::max();
+  }
+
+  // up to Count * 8 keys at offset first, padded to full registers
+  template <std::size_t Count, typename Data>
+  inline void sortSmall(const Data& data, std::size_t first, std::size_t n) {
+    using T = typename Data::Vec::Value;
+    const auto pad = sortPad<T>();
+
+    typename Data::Lanes x[Count];
+
+    for (std::size_t i{0}; i < Count; ++i) {
+      const auto offset = std::min(n, i * 8);
+      x[i] = data.load(first + offset, std::min<std::size_t>(8, n - offset), pad);
+    }
+
+    sortRegisters<Count>(x);
+
+    for (std::size_t i{0}; i < Count; ++i) {
+      const auto offset = std::min(n, i * 8);
+      data.store(first + offset, std::min<std::size_t>(8, n - offset), x[i]);
+    }
+  }
+
+  template <typename Data>
+  inline void sortSmall(const Data& data, std::size_t first, std::size_t n) {
+    assert(n <= 64u);
+
+    if (!data.padSafe(first, first + n, sortPad<typename Data::Vec::Value>()))
+      return data.sortFallback(first, first + n);
+
+    if (n <= 8u)
+      sortSmall<1>(data, first, n);
+    else if (n <= 16u)
+      sortSmall<2>(data, first, n);
+    else if (n <= 32u)
+      sortSmall<4>(data, first, n);
+    else
+      sortSmall<8>(data, first, n);
+  }
+
+
+  // [first, last) into keys at most pivot resp. less than pivot (OrEqual) and the rest; returns where the rest starts.
+  // In place: the first and last register are held back, so that there is always room for a full register store on
+  // both sides -- each register is packed once and stored twice, to the left for its lower and to the right for its
+  // upper keys. Needs at least two registers' worth of keys.
+  template <bool OrEqual, typename Data>
+  inline std::size_t partition(const Data& data, std::size_t first, std::size_t last,
+                               typename Data::Vec::Value pivot) {
+    using Vec = typename Data::Vec;
+    assert(last - first >= 16u);
+
+    const Vec p{pivot};
+    const auto& table = leftPackTable();
+
+    std::size_t readLeft{first + 8}, readRight{last - 8}, writeLeft{first}, writeRight{last};
+
+    const auto pack = [&](const typename Data::Lanes& x) {
+      const auto mask = moveMask(OrEqual ? keysOf(x) >= p : keysOf(x) > p);
+      const auto upper = static_cast<std::size_t>(__builtin_popcount(mask));
+      const auto packed = permuteLanes(x, vec8i{table.index[mask], table.index[mask] + 8});
+
+      data.store(writeLeft, packed);
+      data.store(writeRight - 8, packed);
+      writeLeft += 8 - upper;
+      writeRight -= upper;
+    };
+
+    const auto heldLeft = data.load(first);
+    const auto heldRight = data.load(last - 8);
+
+    // read from the side with less room left
+    while (readRight - readLeft >= 8) {
+      if (readLeft - writeLeft <= writeRight - readRight) {
+        pack(data.load(readLeft));
+        readLeft += 8;
+      } else {
+        readRight -= 8;
+        pack(data.load(readRight));
+      }
+    }
+
+    // fewer than eight keys in between: buffered, that makes room for them one by one
+    typename Data::Element rest[8];
+    const auto count = readRight - readLeft;
+
+    for (std::size_t i{0}; i < count; ++i)
+      rest[i] = data.get(readLeft + i);
+
+    for (std::size_t i{0}; i < count; ++i) {
+      const auto key = Data::key(rest[i]);
+      if (OrEqual ? key >= pivot : key > pivot)
+        data.set(--writeRight, rest[i]);
+      else
+        data.set(writeLeft++, rest[i]);
+    }
+
+    // sixteen free slots left: disjoint stores, then eight: both stores the same
+    pack(heldLeft);
+    pack(heldRight);
+
+    assert(writeLeft == writeRight);
+    return writeLeft;
+  }
+
+  template <typename T>
+  inline T median(T a, T b, T c) {
+    return std::max(std::min(a, b), std::min(std::max(a, b), c));
+  }
+
+  template <typename Data>
+  inline void quicksort(const Data& data, std::size_t first, std::size_t last, int depth) {
+    while (last - first > 64u) {
+      if (depth-- == 0)
+        return data.sortFallback(first, last);
+
+      const auto n = last - first;
+      const auto pivot = median(Data::key(data.get(first + n / 4)), Data::key(data.get(first + n / 2)),
+                                Data::key(data.get(first + 3 * n / 4)));
+
+      auto split = partition<false>(data, first, last, pivot);
+
+      // all keys at most pivot: split off the ones equal to it, they are in place
+      if (split == last) {
+        last = partition<true>(data, first, last, pivot);
+        continue;
+      }
+
+      // recurse into the smaller side, loop on the larger: stack depth stays logarithmic
+      if (split - first < last - split) {
+        quicksort(data, first, split, depth);
+        first = split;
+      } else {
+        quicksort(data, split, last, depth);
+        last = split;
+      }
+    }
+
+    sortSmall(data, first, last - first);
+  }
+
+  template <typename Data>
+  inline void sort(const Data& data, std::size_t n) {
+    int depth{0};
+    for (auto i = n; i > 0; i /= 2)
+      depth += 2;
+
+    quicksort(data, 0, n, depth);
+  }
+
+  template <typename T>
+  using IsSortKey = std::integral_constant<bool, std::is_same<T, std::int32_t>::value || std::is_same<T, float>::value>;
+}
+
+
+// [first, last) ascending, in place
+template <typename T>
+inline void sort(T* first, T* last) {
+  static_assert(detail::IsSortKey<T>::value, "sort keys are std::int32_t or float");
+  detail::sort(detail::Keys<T>{first}, static_cast<std::size_t>(last - first));
+}
+
+// keys [first, last) ascending, in place; values[i] moves along with first[i]
+template <typename T>
+inline void sort(T* first, T* last, std::int32_t* values) {
+  static_assert(detail::IsSortKey<T>::value, "sort keys are std::int32_t or float");
+  detail::sort(detail::KeysValues<T>{first, values}, static_cast<std::size_t>(last - first));
+}
+
+// indices i that order [first, last) by first[i]; the keys stay as they are
+template <typename T>
+inline std::vector<std::int32_t> argSort(const T* first, const T* last) {
+  assert(last - first <= std::numeric_limits<std::int32_t>::max());
+
+  std::vector<T> keys(first, last);
+  std::vector<std::int32_t> indices(keys.size());
+  std::iota(begin(indices), end(indices), 0);
+
+  sort(keys.data(), keys.data() + keys.size(), indices.data());
+  return indices;
+}
+
+// sorted [first1, last1) and [first2, last2) into out, which must not overlap them; returns the end of out.
+// Each step merges the held register with the next one from the range with the smaller head, and stores the lower
+// eight keys -- the held upper eight are at least as large as everything stored so far.
+template <typename T>
+inline T* merge(const T* first1, const T* last1, const T* first2, const T* last2, T* out) {
+  static_assert(detail::IsSortKey<T>::value, "sort keys are std::int32_t or float");
+  using Vec = vec<T, 8u>;
+
+  if (last1 - first1 < 8 || last2 - first2 < 8)
+    return std::merge(first1, last1, first2, last2, out);
+
+  Vec lo{first1, first1 + 8}, hi{first2, first2 + 8};
+  first1 += 8, first2 += 8;
+  detail::mergeRegisters(lo, hi);
+
+  // remaining lengths unsigned: a signed last - first >= 8 after first += 8 trips -Wstrict-overflow once inlined
+  const auto remaining = [](const T* first, const T* last) { return static_cast<std::size_t>(last - first); };
+
+  while (remaining(first1, last1) >= 8u && remaining(first2, last2) >= 8u) {
+    lo.store(out, out + 8);
+    out += 8;
+
+    if (*first1 <= *first2) {
+      lo.load(first1, first1 + 8);
+      first1 += 8;
+    } else {
+      lo.load(first2, first2 + 8);
+      first2 += 8;
+    }
+
+    detail::mergeRegisters(lo, hi);
+  }
+
+  lo.store(out, out + 8);
+  out += 8;
+
+  // the held keys, the shorter rest and the longer rest; the first two fit a small buffer
+  T held[8], small[16];
+  hi.store(held, held + 8);
+
+  if (last1 - first1 > last2 - first2) {
+    std::swap(first1, first2);
+    std::swap(last1, last2);
+  }
+
+  const auto smallLast = std::merge(held, held + 8, first1, last1, small);
+  return std::merge(small, smallLast, first2, last2, out);
+}
+}
+}